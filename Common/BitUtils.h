@@ -145,6 +145,26 @@ constexpr T RotateRight(const T value, size_t amount) noexcept
   return static_cast<T>((value >> amount) | (value << (BitSize<T>() - amount)));
 }
 
+///
+/// Counts the number of leading zero bits (CLZ).
+///
+/// @param  value The value to count the leading zeros of.
+/// @tparam T     An unsigned type no wider than 64 bits.
+///
+/// @return The number of leading zero bits, or the bit width of T if value is zero.
+///
+template <typename T>
+constexpr int CountLeadingZeros(const T value) noexcept
+{
+  static_assert(std::is_unsigned<T>(), "Can only count leading zeros of unsigned types.");
+  static_assert(sizeof(T) <= sizeof(unsigned long long), "Type is too wide.");
+
+  if (value == 0)
+    return static_cast<int>(BitSize<T>());
+
+  return __builtin_clzll(value) - static_cast<int>(BitSize<unsigned long long>() - BitSize<T>());
+}
+
 ///
 /// Verifies whether the supplied value is a valid bit mask of the form 0b00...0011...11.
 /// Both edge cases of all zeros and all ones are considered valid masks, too.
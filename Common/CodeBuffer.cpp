@@ -0,0 +1,24 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/CodeBuffer.h"
+
+#include <malloc.h>
+#include <ogc/cache.h>
+
+CodeBuffer::CodeBuffer(u32 capacity) : m_capacity(capacity)
+{
+  // Cache line aligned, so that flushing the buffer doesn't touch unrelated data
+  m_code = static_cast<u32*>(memalign(32, capacity * sizeof(u32)));
+}
+
+CodeBuffer::~CodeBuffer()
+{
+  free(m_code);
+}
+
+void CodeBuffer::Flush()
+{
+  DCFlushRange(m_code, m_size * sizeof(u32));
+  ICInvalidateRange(m_code, m_size * sizeof(u32));
+}
@@ -0,0 +1,55 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Holds instructions generated at runtime, for tests that need more encodings than can reasonably
+// be written out as inline assembly (e.g. every immediate field value).
+//
+// Instructions are appended with Emit. Flush must be called after emitting and before running
+// the code, since instruction fetch does not see stores that are still in the data cache.
+class CodeBuffer
+{
+public:
+  // capacity is in instructions
+  explicit CodeBuffer(u32 capacity);
+  ~CodeBuffer();
+
+  CodeBuffer(const CodeBuffer&) = delete;
+  CodeBuffer& operator=(const CodeBuffer&) = delete;
+
+  // Discards the emitted instructions, so the buffer can be reused for the next batch.
+  void Reset() { m_size = 0; }
+
+  // Instructions beyond the capacity are dropped and make Overflowed return true.
+  void Emit(u32 instruction)
+  {
+    if (m_size < m_capacity)
+      m_code[m_size++] = instruction;
+    else
+      m_overflowed = true;
+  }
+
+  // Writes the emitted instructions back to memory and invalidates them in the instruction cache.
+  void Flush();
+
+  u32 Size() const { return m_size; }
+  u32 Capacity() const { return m_capacity; }
+  bool Overflowed() const { return m_overflowed; }
+
+  // The start of the buffer as a function pointer. The emitted code has to follow the ABI of the
+  // function type, including ending with blr.
+  template <typename Function>
+  Function GetFunction() const
+  {
+    return reinterpret_cast<Function>(m_code);
+  }
+
+private:
+  u32* m_code;
+  u32 m_size = 0;
+  u32 m_capacity;
+  bool m_overflowed = false;
+};
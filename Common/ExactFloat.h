@@ -0,0 +1,619 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Software model of Broadway's floating-point arithmetic.
+//
+// Every operation computes the exact result with integer arithmetic and rounds it once to the
+// target precision, so the results do not depend on the host FPU, its rounding mode or whether
+// the compiler contracts expressions. Values are passed around as the double-precision bit
+// patterns the FPRs hold; single-precision results are widened to double like on the hardware.
+//
+// The hardware-specific parts live here too:
+// - NaN operands are propagated in a, b, c order (a*c+b for the multiply-add family), made quiet,
+//   and invalid operations produce the default NaN 0x7FF8000000000000.
+// - In non-IEEE mode, results whose exact value is below the smallest normal number are flushed
+//   to zero before rounding (see frsp.cpp). Inputs are never flushed (see ni.cpp).
+// - Single-precision multiplies only use the upper 26 significant bits of frC (Force25Bit).
+// - Single-precision NaN results have their mantissa truncated to single precision.
+
+#pragma once
+
+#include <utility>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/FloatUtils.h"
+
+enum class FloatPrecision
+{
+  Single,
+  Double,
+};
+
+// Rounding control and accumulated FPSCR exception bits for a sequence of operations
+struct FPState
+{
+  RoundingMode rounding_mode = RoundingMode::Nearest;
+  bool ni = false;
+  // Exception bits (FPSCR_OX, FPSCR_VXSNAN...) and FR/FI of the most recent operation
+  u32 fpscr = 0;
+};
+
+constexpr u64 DEFAULT_NAN_BITS = 0x7FF8000000000000ULL;
+
+namespace ExactFloat
+{
+struct U128
+{
+  u64 hi;
+  u64 lo;
+};
+
+inline bool IsZero(U128 value)
+{
+  return (value.hi | value.lo) == 0;
+}
+
+inline bool LessThan(U128 a, U128 b)
+{
+  return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+inline U128 Add(U128 a, U128 b)
+{
+  const u64 lo = a.lo + b.lo;
+  return {a.hi + b.hi + (lo < a.lo), lo};
+}
+
+inline U128 Sub(U128 a, U128 b)
+{
+  return {a.hi - b.hi - (a.lo < b.lo), a.lo - b.lo};
+}
+
+inline U128 ShiftLeft(U128 value, u32 amount)
+{
+  if (amount == 0)
+    return value;
+  if (amount >= 128)
+    return {0, 0};
+  if (amount >= 64)
+    return {value.lo << (amount - 64), 0};
+  return {(value.hi << amount) | (value.lo >> (64 - amount)), value.lo << amount};
+}
+
+inline U128 ShiftRight(U128 value, u32 amount)
+{
+  if (amount == 0)
+    return value;
+  if (amount >= 128)
+    return {0, 0};
+  if (amount >= 64)
+    return {0, value.hi >> (amount - 64)};
+  return {value.hi >> amount, (value.lo >> amount) | (value.hi << (64 - amount))};
+}
+
+// Shifts right by 1 to 128 bits and reports whether the most significant bit that was shifted
+// out was set (round_bit) and whether any of the ones below it were (sticky).
+inline u64 ShiftRightRound(U128 value, u32 amount, bool* round_bit, bool* sticky)
+{
+  const U128 kept = ShiftRight(value, amount);
+  const U128 lost = Sub(value, ShiftLeft(kept, amount));
+  const U128 half = ShiftLeft(U128{0, 1}, amount - 1);
+  *round_bit = !LessThan(lost, half);
+  *sticky = !IsZero(*round_bit ? Sub(lost, half) : lost);
+  return kept.lo;
+}
+
+// Shifts right, ORing all the bits that were shifted out into the least significant bit.
+// As long as there are a few more bits below the rounding position, this rounds exactly like
+// the unshifted value would.
+inline U128 ShiftRightJam(U128 value, u32 amount)
+{
+  if (amount == 0)
+    return value;
+  if (amount >= 128)
+    return {0, IsZero(value) ? 0u : 1u};
+
+  U128 result;
+  u64 lost;
+  if (amount >= 64)
+  {
+    result = {0, amount == 64 ? value.hi : value.hi >> (amount - 64)};
+    lost = value.lo | (amount == 64 ? 0 : value.hi << (128 - amount));
+  }
+  else
+  {
+    result = {value.hi >> amount, (value.lo >> amount) | (value.hi << (64 - amount))};
+    lost = value.lo << (64 - amount);
+  }
+  result.lo |= lost != 0;
+  return result;
+}
+
+inline int MostSignificantBit(U128 value)
+{
+  if (value.hi != 0)
+    return 127 - Common::CountLeadingZeros(value.hi);
+  return 63 - Common::CountLeadingZeros(value.lo);
+}
+
+inline U128 Multiply(u64 a, u64 b)
+{
+#ifdef __SIZEOF_INT128__
+  const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<u64>(product >> 64), static_cast<u64>(product)};
+#else
+  const u64 a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+  const u64 b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+  const u64 lo_lo = a_lo * b_lo;
+  const u64 hi_lo = a_hi * b_lo;
+  const u64 lo_hi = a_lo * b_hi;
+  const u64 hi_hi = a_hi * b_hi;
+  const u64 middle = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  return {hi_hi + (hi_lo >> 32) + (middle >> 32), (middle << 32) | (lo_lo & 0xFFFFFFFF)};
+#endif
+}
+
+// A finite value: (-1)^sign * mantissa * 2^exponent
+struct Unpacked
+{
+  bool sign;
+  s32 exponent;
+  U128 mantissa;
+};
+
+inline bool IsNaN(u64 bits)
+{
+  return (bits & ~DOUBLE_SIGN) > DOUBLE_EXP;
+}
+
+inline bool IsSNaN(u64 bits)
+{
+  return IsNaN(bits) && (bits & DOUBLE_QBIT) == 0;
+}
+
+inline bool IsInfinity(u64 bits)
+{
+  return (bits & ~DOUBLE_SIGN) == DOUBLE_EXP;
+}
+
+inline bool IsZero(u64 bits)
+{
+  return (bits & ~DOUBLE_SIGN) == 0;
+}
+
+inline Unpacked Unpack(u64 bits)
+{
+  const u64 biased_exponent = (bits & DOUBLE_EXP) >> DOUBLE_FRAC_WIDTH;
+  u64 mantissa = bits & DOUBLE_FRAC;
+  s32 exponent = -1074;
+  if (biased_exponent != 0)
+  {
+    mantissa |= DOUBLE_FRAC + 1;
+    exponent = static_cast<s32>(biased_exponent) - 1075;
+  }
+  return {(bits & DOUBLE_SIGN) != 0, exponent, {0, mantissa}};
+}
+
+// Moves the most significant bit of a nonzero mantissa to the given position
+inline Unpacked Normalize(Unpacked value, int msb)
+{
+  const int shift = msb - MostSignificantBit(value.mantissa);
+  if (shift >= 0)
+    value.mantissa = ShiftLeft(value.mantissa, static_cast<u32>(shift));
+  else
+    value.mantissa = ShiftRightJam(value.mantissa, static_cast<u32>(-shift));
+  value.exponent -= shift;
+  return value;
+}
+
+// Rounds away the mantissa bits of single-precision frC operands that the multiplier ignores
+inline u64 Force25Bit(u64 bits)
+{
+  if ((bits & DOUBLE_EXP) == DOUBLE_EXP)
+    return bits;
+  return (bits & 0xFFFFFFFFF8000000ULL) + (bits & 0x8000000);
+}
+
+inline u64 Negate(u64 bits)
+{
+  return bits ^ DOUBLE_SIGN;
+}
+
+inline u64 SignedZero(bool sign)
+{
+  return sign ? DOUBLE_SIGN : 0;
+}
+
+// An exact zero sum of two values with different signs is -0 only when rounding towards -inf
+inline u64 ZeroSum(const FPState& state)
+{
+  return SignedZero(state.rounding_mode == RoundingMode::TowardsNegativeInfinity);
+}
+
+inline u64 FinishNaN(u64 bits, FloatPrecision precision)
+{
+  bits |= DOUBLE_QBIT;
+  return precision == FloatPrecision::Single ? TruncateMantissaBits(bits) : bits;
+}
+
+inline u64 InvalidOperation(u32 flag, FPState& state)
+{
+  state.fpscr |= flag;
+  return DEFAULT_NAN_BITS;
+}
+
+// Rounds a nonzero exact value to the target precision
+inline u64 Round(const Unpacked& value, FloatPrecision precision, FPState& state)
+{
+  const bool single = precision == FloatPrecision::Single;
+  const int precision_bits = single ? 24 : 53;
+  const s32 min_exponent = single ? -126 : -1022;
+  const s32 max_exponent = single ? 127 : 1023;
+
+  // The value lies in [2^top, 2^(top+1))
+  const s32 top = value.exponent + MostSignificantBit(value.mantissa);
+  const bool tiny = top < min_exponent;
+
+  if (tiny && state.ni)
+  {
+    state.fpscr |= FPSCR_UX | FPSCR_XX | FPSCR_FI;
+    return SignedZero(value.sign);
+  }
+
+  // Weight of the last bit that is kept, taking the denormal range into account
+  const s32 lsb_exponent = (tiny ? min_exponent : top) - precision_bits + 1;
+  const s32 shift = lsb_exponent - value.exponent;
+
+  u64 kept;
+  bool round_bit = false;
+  bool sticky = false;
+  if (shift <= 0)
+  {
+    kept = ShiftLeft(value.mantissa, static_cast<u32>(-shift)).lo;
+  }
+  else if (shift > 128)
+  {
+    kept = 0;
+    sticky = true;
+  }
+  else
+  {
+    kept = ShiftRightRound(value.mantissa, static_cast<u32>(shift), &round_bit, &sticky);
+  }
+
+  const bool inexact = round_bit || sticky;
+  bool increment = false;
+  switch (state.rounding_mode)
+  {
+  case RoundingMode::Nearest:
+    increment = round_bit && (sticky || (kept & 1));
+    break;
+  case RoundingMode::TowardsZero:
+    break;
+  case RoundingMode::TowardsPositiveInfinity:
+    increment = inexact && !value.sign;
+    break;
+  case RoundingMode::TowardsNegativeInfinity:
+    increment = inexact && value.sign;
+    break;
+  }
+  kept += increment;
+
+  if (inexact)
+  {
+    state.fpscr |= FPSCR_XX | FPSCR_FI;
+    if (increment)
+      state.fpscr |= FPSCR_FR;
+    if (tiny)
+      state.fpscr |= FPSCR_UX;
+  }
+
+  if (kept == 0)
+    return SignedZero(value.sign);
+
+  const int kept_msb = 63 - Common::CountLeadingZeros(kept);
+  const s32 result_exponent = lsb_exponent + kept_msb;
+  const u64 sign = value.sign ? DOUBLE_SIGN : 0;
+
+  if (result_exponent > max_exponent)
+  {
+    state.fpscr |= FPSCR_OX | FPSCR_XX | FPSCR_FI;
+    state.fpscr &= ~FPSCR_FR;
+
+    bool to_infinity = false;
+    switch (state.rounding_mode)
+    {
+    case RoundingMode::Nearest:
+      to_infinity = true;
+      break;
+    case RoundingMode::TowardsZero:
+      break;
+    case RoundingMode::TowardsPositiveInfinity:
+      to_infinity = !value.sign;
+      break;
+    case RoundingMode::TowardsNegativeInfinity:
+      to_infinity = value.sign;
+      break;
+    }
+    if (to_infinity)
+    {
+      state.fpscr |= FPSCR_FR;
+      return sign | DOUBLE_EXP;
+    }
+    return sign | (single ? 0x47EFFFFFE0000000ULL : 0x7FEFFFFFFFFFFFFFULL);
+  }
+
+  if (result_exponent < -1022)
+  {
+    // Double-precision denormal: the last kept bit has a weight of 2^-1074
+    return sign | (kept << (lsb_exponent + 1074));
+  }
+
+  return sign | (static_cast<u64>(result_exponent + 1023) << DOUBLE_FRAC_WIDTH) |
+         ((kept << (52 - kept_msb)) & DOUBLE_FRAC);
+}
+
+inline u64 RoundBits(u64 bits, FloatPrecision precision, FPState& state)
+{
+  return Round(Unpack(bits), precision, state);
+}
+
+// Adds two nonzero exact values and rounds the sum. Mantissas may use up to 106 bits.
+inline u64 AddAndRound(Unpacked x, Unpacked y, FloatPrecision precision, FPState& state)
+{
+  // Line both values up with the larger one's most significant bit at bit 125. Bits of the
+  // smaller one that fall off the end are jammed; that only happens when it is at least 20 bits
+  // further down, in which case there can't be any significant cancellation.
+  const s32 x_top = x.exponent + MostSignificantBit(x.mantissa);
+  const s32 y_top = y.exponent + MostSignificantBit(y.mantissa);
+  if (x_top < y_top)
+    std::swap(x, y);
+
+  x = Normalize(x, 125);
+  y = Normalize(y, 125);
+  const U128 y_mantissa = ShiftRightJam(y.mantissa, static_cast<u32>(x.exponent - y.exponent));
+
+  Unpacked sum;
+  sum.exponent = x.exponent;
+  if (x.sign == y.sign)
+  {
+    sum.sign = x.sign;
+    sum.mantissa = Add(x.mantissa, y_mantissa);
+  }
+  else if (!LessThan(x.mantissa, y_mantissa))
+  {
+    sum.sign = x.sign;
+    sum.mantissa = Sub(x.mantissa, y_mantissa);
+  }
+  else
+  {
+    sum.sign = y.sign;
+    sum.mantissa = Sub(y_mantissa, x.mantissa);
+  }
+
+  if (IsZero(sum.mantissa))
+    return ZeroSum(state);
+
+  return Round(sum, precision, state);
+}
+
+inline bool PropagateNaN2(u64 a, u64 b, FloatPrecision precision, FPState& state, u64* result)
+{
+  if (!IsNaN(a) && !IsNaN(b))
+    return false;
+  if (IsSNaN(a) || IsSNaN(b))
+    state.fpscr |= FPSCR_VXSNAN;
+  *result = FinishNaN(IsNaN(a) ? a : b, precision);
+  return true;
+}
+
+inline bool PropagateNaN3(u64 a, u64 b, u64 c, FloatPrecision precision, FPState& state,
+                          u64* result)
+{
+  if (!IsNaN(a) && !IsNaN(b) && !IsNaN(c))
+    return false;
+  if (IsSNaN(a) || IsSNaN(b) || IsSNaN(c))
+    state.fpscr |= FPSCR_VXSNAN;
+  *result = FinishNaN(IsNaN(a) ? a : IsNaN(b) ? b : c, precision);
+  return true;
+}
+}  // namespace ExactFloat
+
+// a + b
+inline u64 FloatAdd(u64 a, u64 b, FloatPrecision precision, FPState& state)
+{
+  using namespace ExactFloat;
+  state.fpscr &= ~(FPSCR_FR | FPSCR_FI);
+
+  u64 result = 0;
+  if (PropagateNaN2(a, b, precision, state, &result))
+    return result;
+
+  if (IsInfinity(a) || IsInfinity(b))
+  {
+    if (IsInfinity(a) && IsInfinity(b) && ((a ^ b) & DOUBLE_SIGN))
+      return InvalidOperation(FPSCR_VXISI, state);
+    return IsInfinity(a) ? a : b;
+  }
+
+  if (IsZero(a) && IsZero(b))
+    return ((a ^ b) & DOUBLE_SIGN) ? ZeroSum(state) : a;
+  if (IsZero(a))
+    return RoundBits(b, precision, state);
+  if (IsZero(b))
+    return RoundBits(a, precision, state);
+
+  return AddAndRound(Unpack(a), Unpack(b), precision, state);
+}
+
+// a - b
+inline u64 FloatSub(u64 a, u64 b, FloatPrecision precision, FPState& state)
+{
+  // NaNs keep their sign, so only negate b once it's known not to be one
+  if (ExactFloat::IsNaN(b))
+    return FloatAdd(a, b, precision, state);
+  return FloatAdd(a, ExactFloat::Negate(b), precision, state);
+}
+
+// a * c
+inline u64 FloatMul(u64 a, u64 c, FloatPrecision precision, FPState& state)
+{
+  using namespace ExactFloat;
+  state.fpscr &= ~(FPSCR_FR | FPSCR_FI);
+
+  u64 result = 0;
+  if (PropagateNaN2(a, c, precision, state, &result))
+    return result;
+
+  const bool sign = ((a ^ c) & DOUBLE_SIGN) != 0;
+  if (IsInfinity(a) || IsInfinity(c))
+  {
+    if (IsZero(a) || IsZero(c))
+      return InvalidOperation(FPSCR_VXIMZ, state);
+    return SignedZero(sign) | DOUBLE_EXP;
+  }
+  if (IsZero(a) || IsZero(c))
+    return SignedZero(sign);
+
+  if (precision == FloatPrecision::Single)
+    c = Force25Bit(c);
+
+  const Unpacked x = Unpack(a);
+  const Unpacked y = Unpack(c);
+  return Round({sign, x.exponent + y.exponent, Multiply(x.mantissa.lo, y.mantissa.lo)}, precision,
+               state);
+}
+
+// a / b
+inline u64 FloatDiv(u64 a, u64 b, FloatPrecision precision, FPState& state)
+{
+  using namespace ExactFloat;
+  state.fpscr &= ~(FPSCR_FR | FPSCR_FI);
+
+  u64 result = 0;
+  if (PropagateNaN2(a, b, precision, state, &result))
+    return result;
+
+  const bool sign = ((a ^ b) & DOUBLE_SIGN) != 0;
+  if (IsInfinity(a))
+  {
+    if (IsInfinity(b))
+      return InvalidOperation(FPSCR_VXIDI, state);
+    return SignedZero(sign) | DOUBLE_EXP;
+  }
+  if (IsInfinity(b))
+    return SignedZero(sign);
+  if (IsZero(b))
+  {
+    if (IsZero(a))
+      return InvalidOperation(FPSCR_VXZDZ, state);
+    state.fpscr |= FPSCR_ZX;
+    return SignedZero(sign) | DOUBLE_EXP;
+  }
+  if (IsZero(a))
+    return SignedZero(sign);
+
+  // With both mantissas normalized to [2^52, 2^53), the 64 fraction bits of the quotient plus a
+  // sticky bit for the remainder are plenty for rounding to double precision.
+  const Unpacked x = Normalize(Unpack(a), 52);
+  const Unpacked y = Normalize(Unpack(b), 52);
+  const u64 dividend = x.mantissa.lo;
+  const u64 divisor = y.mantissa.lo;
+
+  U128 quotient;
+  u64 remainder;
+#ifdef __SIZEOF_INT128__
+  const unsigned __int128 wide_dividend = static_cast<unsigned __int128>(dividend) << 64;
+  const unsigned __int128 wide_quotient = wide_dividend / divisor;
+  quotient = {static_cast<u64>(wide_quotient >> 64), static_cast<u64>(wide_quotient)};
+  remainder = static_cast<u64>(wide_dividend - wide_quotient * divisor);
+#else
+  quotient.hi = dividend / divisor;
+  remainder = dividend % divisor;
+  quotient.lo = 0;
+  for (int i = 0; i < 64; ++i)
+  {
+    remainder <<= 1;
+    quotient.lo <<= 1;
+    if (remainder >= divisor)
+    {
+      remainder -= divisor;
+      quotient.lo |= 1;
+    }
+  }
+#endif
+  quotient.lo |= remainder != 0;
+
+  return Round({sign, x.exponent - y.exponent - 64, quotient}, precision, state);
+}
+
+// a * c + b, optionally negating b and/or the result (fmsub, fnmadd, fnmsub)
+inline u64 FloatMulAdd(u64 a, u64 c, u64 b, bool negate_b, bool negate_result,
+                       FloatPrecision precision, FPState& state)
+{
+  using namespace ExactFloat;
+  state.fpscr &= ~(FPSCR_FR | FPSCR_FI);
+
+  // NaNs propagate without any change to their sign
+  u64 result = 0;
+  if (PropagateNaN3(a, b, c, precision, state, &result))
+    return result;
+
+  if (negate_b)
+    b = Negate(b);
+
+  const bool product_sign = ((a ^ c) & DOUBLE_SIGN) != 0;
+  if (IsInfinity(a) || IsInfinity(c))
+  {
+    if (IsZero(a) || IsZero(c))
+      return InvalidOperation(FPSCR_VXIMZ, state);
+    if (IsInfinity(b) && ((b & DOUBLE_SIGN) != 0) != product_sign)
+      return InvalidOperation(FPSCR_VXISI, state);
+    result = SignedZero(product_sign) | DOUBLE_EXP;
+  }
+  else if (IsInfinity(b))
+  {
+    result = b;
+  }
+  else if (IsZero(a) || IsZero(c))
+  {
+    if (IsZero(b))
+      result = ((b & DOUBLE_SIGN) != 0) == product_sign ? b : ZeroSum(state);
+    else
+      result = RoundBits(b, precision, state);
+  }
+  else
+  {
+    if (precision == FloatPrecision::Single)
+      c = Force25Bit(c);
+
+    const Unpacked x = Unpack(a);
+    const Unpacked y = Unpack(c);
+    const Unpacked product = {product_sign, x.exponent + y.exponent,
+                              Multiply(x.mantissa.lo, y.mantissa.lo)};
+    if (IsZero(b))
+      result = Round(product, precision, state);
+    else
+      result = AddAndRound(product, Unpack(b), precision, state);
+  }
+
+  return negate_result ? Negate(result) : result;
+}
+
+// frsp, and the rounding that single-precision instructions apply to their result
+inline u64 FloatRoundToSingle(u64 b, FPState& state)
+{
+  using namespace ExactFloat;
+  state.fpscr &= ~(FPSCR_FR | FPSCR_FI);
+
+  if (IsNaN(b))
+  {
+    if (IsSNaN(b))
+      state.fpscr |= FPSCR_VXSNAN;
+    return FinishNaN(b, FloatPrecision::Single);
+  }
+  if (IsInfinity(b) || IsZero(b))
+    return b;
+  return RoundBits(b, FloatPrecision::Single, state);
+}
@@ -0,0 +1,112 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/ExpectedStream.h"
+
+#include <malloc.h>
+#include <network.h>
+
+#include "Common/hwtests.h"
+
+extern int client_socket;
+
+// The console is big-endian, so the entries can be received straight into the buffers.
+static bool ReceiveAll(void* buffer, u32 size)
+{
+  u8* data = static_cast<u8*>(buffer);
+  while (size != 0)
+  {
+    const s32 received = net_recv(client_socket, data, size, 0);
+    if (received <= 0)
+      return false;
+    data += received;
+    size -= received;
+  }
+  return true;
+}
+
+ExpectedStream::ExpectedStream(ExpectedKind kind, u32 param, u64 first, u64 count)
+    : m_expected(count * ExpectedEntriesPerInput(kind))
+{
+  for (u64*& buffer : m_buffers)
+    buffer = static_cast<u64*>(memalign(32, EXPECTED_STREAM_BLOCK_ENTRIES * sizeof(u64)));
+
+  LWP_SemInit(&m_free_buffers, 2, 2);
+  LWP_SemInit(&m_full_buffers, 0, 2);
+
+  network_printf(EXPECTED_STREAM_REQUEST " %u %u %llu %llu\n", static_cast<u32>(kind), param, first,
+                 count);
+
+  LWP_CreateThread(&m_thread, ReceiveThread, this, nullptr, 16 * 1024, 80);
+}
+
+ExpectedStream::~ExpectedStream()
+{
+  if (!m_ended)
+  {
+    // Let the host know, then skip whatever it already sent until the terminating block
+    network_printf(EXPECTED_STREAM_CANCEL "\n");
+    const u64* entries;
+    while (Next(&entries) != 0)
+    {
+    }
+  }
+
+  LWP_JoinThread(m_thread, nullptr);
+  LWP_SemDestroy(m_free_buffers);
+  LWP_SemDestroy(m_full_buffers);
+
+  for (u64* buffer : m_buffers)
+    free(buffer);
+}
+
+u32 ExpectedStream::Next(const u64** entries)
+{
+  if (m_holding_block)
+  {
+    LWP_SemPost(m_free_buffers);
+    m_holding_block = false;
+  }
+
+  if (m_ended)
+    return 0;
+
+  LWP_SemWait(m_full_buffers);
+  const u32 size = m_sizes[m_read_index];
+  *entries = m_buffers[m_read_index];
+  m_read_index ^= 1;
+  m_holding_block = true;
+
+  if (size == 0)
+  {
+    m_ended = true;
+    if (m_received != m_expected)
+      network_printf("Expected stream ended after %llu of %llu entries\n", m_received, m_expected);
+  }
+  m_received += size;
+  return size;
+}
+
+void* ExpectedStream::ReceiveThread(void* arg)
+{
+  ExpectedStream* stream = static_cast<ExpectedStream*>(arg);
+
+  for (u32 write_index = 0;; write_index ^= 1)
+  {
+    LWP_SemWait(stream->m_free_buffers);
+
+    u32 size = 0;
+    if (!ReceiveAll(&size, sizeof(size)) || size > EXPECTED_STREAM_BLOCK_ENTRIES ||
+        !ReceiveAll(stream->m_buffers[write_index], size * sizeof(u64)))
+    {
+      // Treat a broken connection like the end of the stream
+      size = 0;
+    }
+
+    stream->m_sizes[write_index] = size;
+    LWP_SemPost(stream->m_full_buffers);
+
+    if (size == 0)
+      return nullptr;
+  }
+}
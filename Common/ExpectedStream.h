@@ -0,0 +1,49 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <ogc/lwp.h>
+#include <ogc/semaphore.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/ExpectedStreamProtocol.h"
+
+// Receives expected results that tools/expected_stream computes on the host, so that sweeps only
+// have to execute the instruction under test and compare.
+//
+// A background thread receives the next block while the test works on the current one. This
+// requires the host tool to be connected instead of netcat, so tests only use it when built with
+// their USE_EXPECTED_STREAM switch turned on.
+class ExpectedStream
+{
+public:
+  ExpectedStream(ExpectedKind kind, u32 param, u64 first, u64 count);
+  ~ExpectedStream();
+
+  ExpectedStream(const ExpectedStream&) = delete;
+  ExpectedStream& operator=(const ExpectedStream&) = delete;
+
+  // Returns the number of entries in the next block and points *entries at them, waiting for
+  // the block to arrive if needed. The previous block must not be used anymore after this.
+  // Returns 0 once the stream has ended or the connection was lost.
+  u32 Next(const u64** entries);
+
+  // True if all requested entries were received.
+  bool Complete() const { return m_received == m_expected; }
+
+private:
+  static void* ReceiveThread(void* arg);
+
+  u64* m_buffers[2];
+  u32 m_sizes[2] = {};
+  u32 m_read_index = 0;
+  bool m_holding_block = false;
+  bool m_ended = false;
+  u64 m_received = 0;
+  u64 m_expected;
+
+  lwp_t m_thread = LWP_THREAD_NULL;
+  sem_t m_free_buffers;
+  sem_t m_full_buffers;
+};
@@ -0,0 +1,48 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Protocol shared by ExpectedStream (console) and tools/expected_stream (host).
+//
+// The console requests a range of expected results by sending a text line of the form
+//   @@expected <kind> <param> <first input> <input count>
+// over the regular test output connection. The host answers with a sequence of blocks, each made
+// of a big-endian u32 entry count followed by that many big-endian u64 entries, and terminates
+// the stream with an empty block. Sending "@@expected cancel" makes the host stop early; it still
+// sends the terminating empty block so that both sides stay in sync.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+#define EXPECTED_STREAM_REQUEST "@@expected"
+#define EXPECTED_STREAM_CANCEL EXPECTED_STREAM_REQUEST " cancel"
+
+enum class ExpectedKind : u32
+{
+  // Input i is the double with upper word i and lower word 0. Two entries per input: the
+  // frsqrte_expected result and the fres_expected result (param is the NI bit).
+  Reciprocal = 0,
+  // Input i is the float with bit pattern i. One entry per input: the fctiw_expected result
+  // (param is the RoundingMode).
+  Fctiw = 1,
+  // Input i is the float with bit pattern i. Four entries per input: the result and FPSCR of
+  // fadds i, -0.0 followed by those of fmuls i, i, starting from a cleared FPSCR with param as
+  // the RoundingMode.
+  Fprf = 2,
+};
+
+// Upper bound on the entries in a single block, so the console can size its receive buffers
+constexpr u32 EXPECTED_STREAM_BLOCK_ENTRIES = 0x10000;
+
+constexpr u32 ExpectedEntriesPerInput(ExpectedKind kind)
+{
+  switch (kind)
+  {
+  case ExpectedKind::Reciprocal:
+    return 2;
+  case ExpectedKind::Fprf:
+    return 4;
+  default:
+    return 1;
+  }
+}
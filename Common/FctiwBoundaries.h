@@ -0,0 +1,161 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Inputs for fctiw and fctiwz that sit on or right next to a rounding boundary: every double
+// within FCTIW_BOUNDARY_ULPS ulps of each integer and half-integer from -(2^31 + 1) to 2^31 + 1,
+// preceded by the same neighborhoods around exponent edges (zero, denormals, the points where the
+// ulp reaches 1 and 2, the edges of the 64-bit range, infinity and NaN).
+//
+// The inputs are indexed, so a test can walk any subset (a stride, or a range per run) and the
+// host can regenerate exactly the same inputs. Apart from the test runner at the end, which only
+// exists on the console, it doesn't depend on anything console-specific.
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/FloatUtils.h"
+
+constexpr s32 FCTIW_BOUNDARY_ULPS = 3;
+constexpr u64 FCTIW_BOUNDARY_NEIGHBORS = 2 * FCTIW_BOUNDARY_ULPS + 1;
+
+// Positive values whose neighborhoods are tested with both signs
+constexpr u64 FCTIW_EXPONENT_EDGES[] = {
+    0x0000000000000000,  // zero
+    0x000FFFFFFFFFFFFF,  // largest denormal
+    0x0010000000000000,  // smallest normal
+    0x3CA0000000000000,  // 2^-53, below which 0.5 + x rounds to 0.5
+    0x3FE0000000000000,  // 0.5
+    0x3FF0000000000000,  // 1, where the integer part starts
+    0x41E0000000000000,  // 2^31
+    0x41F0000000000000,  // 2^32
+    0x4330000000000000,  // 2^52, where the ulp becomes 1
+    0x4340000000000000,  // 2^53, where the ulp becomes 2
+    0x43E0000000000000,  // 2^63
+    0x43F0000000000000,  // 2^64
+    0x7FEFFFFFFFFFFFFF,  // largest double, whose neighbors above are infinity and SNaNs
+    0x7FF8000000000000,  // QNaN, whose neighbors below are SNaNs
+};
+
+constexpr u64 FCTIW_EDGE_INPUTS = std::size(FCTIW_EXPONENT_EDGES) * 2 * FCTIW_BOUNDARY_NEIGHBORS;
+
+// Integers and half-integers from -(2^31 + 1) to 2^31 + 1, so that both saturation points have
+// boundaries on either side
+constexpr s64 FCTIW_FIRST_HALF_STEP = -(s64{1} << 32) - 2;
+constexpr u64 FCTIW_NUM_BOUNDARIES = (u64{1} << 33) + 5;
+
+constexpr u64 FCTIW_BOUNDARY_INPUTS =
+    FCTIW_EDGE_INPUTS + FCTIW_NUM_BOUNDARIES * FCTIW_BOUNDARY_NEIGHBORS;
+
+// Moves a double by the given number of representable values, treating both zeros as one. Doubles
+// ordered by value are ordered by their magnitude bits, with the sign flipping the direction.
+inline u64 FctiwOffsetUlps(u64 bits, s32 ulps)
+{
+  if (ulps == 0)
+    return bits;
+  const s64 magnitude = static_cast<s64>(bits & ~DOUBLE_SIGN);
+  const s64 ordered = ((bits & DOUBLE_SIGN) ? -magnitude : magnitude) + ulps;
+  return ordered < 0 ? DOUBLE_SIGN | static_cast<u64>(-ordered) : static_cast<u64>(ordered);
+}
+
+// Returns the bit pattern of input index, which must be below FCTIW_BOUNDARY_INPUTS
+inline u64 FctiwBoundaryInput(u64 index)
+{
+  const s32 ulps = static_cast<s32>(index % FCTIW_BOUNDARY_NEIGHBORS) - FCTIW_BOUNDARY_ULPS;
+  const u64 neighborhood = index / FCTIW_BOUNDARY_NEIGHBORS;
+
+  if (index < FCTIW_EDGE_INPUTS)
+  {
+    const u64 edge = FCTIW_EXPONENT_EDGES[neighborhood / 2];
+    return FctiwOffsetUlps((neighborhood & 1) ? edge | DOUBLE_SIGN : edge, ulps);
+  }
+
+  const s64 half_steps = FCTIW_FIRST_HALF_STEP +
+                         static_cast<s64>(neighborhood - std::size(FCTIW_EXPONENT_EDGES) * 2);
+  return FctiwOffsetUlps(Common::BitCast<u64>(static_cast<double>(half_steps) * 0.5), ulps);
+}
+
+#ifdef GEKKO
+#include <wiiuse/wpad.h>
+
+#include "Common/hwtests.h"
+
+// Each run tests the edge inputs and every FCTIW_BOUNDARY_STRIDE-th of the others, starting at an
+// offset taken from the test seed, so that runs with different seeds cover different inputs. A
+// stride of 1 tests all of them, which takes days.
+constexpr u64 FCTIW_BOUNDARY_STRIDE = 7919;
+constexpr u32 FCTIW_BOUNDARY_BLOCK_SIZE = 4096;
+
+// Runs the instruction under test on count inputs
+typedef void (*FctiwKernel)(const u64* inputs, u64* results, u32 count);
+typedef u64 (*FctiwExpected)(double input, RoundingMode rounding_mode);
+
+// Tests count boundary inputs, every stride-th one starting at first. FPSCR[RN] must already be
+// set to rounding_mode. Returns false if aborted.
+inline bool FctiwTestBoundaries(const char* name, FctiwKernel run, FctiwExpected expected,
+                                u64 first, u64 stride, u64 count, RoundingMode rounding_mode)
+{
+  static u64 inputs[FCTIW_BOUNDARY_BLOCK_SIZE];
+  static u64 results[FCTIW_BOUNDARY_BLOCK_SIZE];
+
+  for (u64 done = 0; done < count;)
+  {
+    const u32 size = static_cast<u32>(std::min<u64>(FCTIW_BOUNDARY_BLOCK_SIZE, count - done));
+    for (u32 i = 0; i < size; ++i)
+      inputs[i] = FctiwBoundaryInput(first + (done + i) * stride);
+
+    run(inputs, results, size);
+
+    for (u32 i = 0; i < size; ++i)
+    {
+      const u64 expected_result = expected(Common::BitCast<double>(inputs[i]), rounding_mode);
+      DO_TEST(results[i] == expected_result, "{} 0x{:016x} (RN={}):\n"
+                                             "     got 0x{:016x}\n"
+                                             "expected 0x{:016x}",
+              name, inputs[i], static_cast<u32>(rounding_mode), results[i], expected_result);
+    }
+
+    done += size;
+    if (done % (FCTIW_BOUNDARY_BLOCK_SIZE * 256) == 0 || done == count)
+    {
+      network_printf("Progress: %llu/%llu\n", done, count);
+
+      WPAD_ScanPads();
+      if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+// Tests the boundary inputs of this run in every rounding mode
+inline void FctiwTestAllBoundaries(const char* name, FctiwKernel run, FctiwExpected expected)
+{
+  const u64 offset = GetTestSeed() % FCTIW_BOUNDARY_STRIDE;
+  const u64 num_strided =
+      (FCTIW_BOUNDARY_INPUTS - FCTIW_EDGE_INPUTS - offset + FCTIW_BOUNDARY_STRIDE - 1) /
+      FCTIW_BOUNDARY_STRIDE;
+  network_printf("Boundary inputs: every %llu-th starting at %llu\n", FCTIW_BOUNDARY_STRIDE,
+                 offset);
+
+  for (u64 rounding_mode = 0; rounding_mode < 4; ++rounding_mode)
+  {
+    asm volatile("mtfsf 7, %0" ::"f"(rounding_mode));
+    network_printf("Rounding mode: %llu\n", rounding_mode);
+
+    const RoundingMode mode = static_cast<RoundingMode>(rounding_mode);
+    if (!FctiwTestBoundaries(name, run, expected, 0, 1, FCTIW_EDGE_INPUTS, mode) ||
+        !FctiwTestBoundaries(name, run, expected, FCTIW_EDGE_INPUTS + offset,
+                             FCTIW_BOUNDARY_STRIDE, num_strided, mode))
+    {
+      break;
+    }
+  }
+
+  asm volatile("mtfsf 7, %0" ::"f"(u64{0}));
+}
+#endif
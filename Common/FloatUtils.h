@@ -3,10 +3,13 @@
 #include "Common/CommonTypes.h"
 #include "Common/BitUtils.h"
 #include <cfloat>
+#include <cmath>
+#include <cstring>
 #include <limits>
 
-#include <cfloat>
-#include <limits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 enum class RoundingMode
 {
@@ -30,8 +33,121 @@ constexpr u32 FLOAT_FRAC = 0x007FFFFF;
 constexpr u32 FLOAT_ZERO = 0x00000000;
 constexpr u32 FLOAT_FRAC_WIDTH = 23;
 
+// Assembles a double from its fields. exponent is biased, fraction is cut to the fraction bits.
+inline u64 MakeDouble(bool sign, s32 exponent, u64 fraction)
+{
+  return (sign ? DOUBLE_SIGN : 0) | (static_cast<u64>(exponent) << DOUBLE_FRAC_WIDTH) |
+         (fraction & DOUBLE_FRAC);
+}
+
+// The biased exponent of a double
+inline s32 GetExponent(u64 bits)
+{
+  return static_cast<s32>((bits & DOUBLE_EXP) >> DOUBLE_FRAC_WIDTH);
+}
+
+// FPSCR bits. The manuals number them from the most significant bit, so FX is bit 0.
+constexpr u32 FPSCR_FX = 1U << 31;
+constexpr u32 FPSCR_FEX = 1U << 30;
+constexpr u32 FPSCR_VX = 1U << 29;
+constexpr u32 FPSCR_OX = 1U << 28;
+constexpr u32 FPSCR_UX = 1U << 27;
+constexpr u32 FPSCR_ZX = 1U << 26;
+constexpr u32 FPSCR_XX = 1U << 25;
+constexpr u32 FPSCR_VXSNAN = 1U << 24;
+constexpr u32 FPSCR_VXISI = 1U << 23;
+constexpr u32 FPSCR_VXIDI = 1U << 22;
+constexpr u32 FPSCR_VXZDZ = 1U << 21;
+constexpr u32 FPSCR_VXIMZ = 1U << 20;
+constexpr u32 FPSCR_VXVC = 1U << 19;
+constexpr u32 FPSCR_FR = 1U << 18;
+constexpr u32 FPSCR_FI = 1U << 17;
+constexpr u32 FPSCR_FPRF = 0x1FU << 12;
+constexpr u32 FPSCR_VXSOFT = 1U << 10;
+constexpr u32 FPSCR_VXSQRT = 1U << 9;
+constexpr u32 FPSCR_VXCVI = 1U << 8;
+constexpr u32 FPSCR_VE = 1U << 7;
+constexpr u32 FPSCR_OE = 1U << 6;
+constexpr u32 FPSCR_UE = 1U << 5;
+constexpr u32 FPSCR_ZE = 1U << 4;
+constexpr u32 FPSCR_XE = 1U << 3;
+constexpr u32 FPSCR_NI = 1U << 2;
+constexpr u32 FPSCR_RN = 0x3;
+
+constexpr u32 FPSCR_FPRF_SHIFT = 12;
+constexpr u32 FPSCR_ANY_VX = FPSCR_VXSNAN | FPSCR_VXISI | FPSCR_VXIDI | FPSCR_VXZDZ |
+                             FPSCR_VXIMZ | FPSCR_VXVC | FPSCR_VXSOFT | FPSCR_VXSQRT | FPSCR_VXCVI;
+constexpr u32 FPSCR_ANY_X = FPSCR_OX | FPSCR_UX | FPSCR_ZX | FPSCR_XX | FPSCR_ANY_VX;
+
+// Values of FPSCR[FPRF], the result class bit followed by the FPCC bits
+constexpr u32 FPRF_QNAN = 0x11;
+constexpr u32 FPRF_NEGATIVE_INFINITY = 0x09;
+constexpr u32 FPRF_NEGATIVE_NORMAL = 0x08;
+constexpr u32 FPRF_NEGATIVE_DENORMAL = 0x18;
+constexpr u32 FPRF_NEGATIVE_ZERO = 0x12;
+constexpr u32 FPRF_POSITIVE_ZERO = 0x02;
+constexpr u32 FPRF_POSITIVE_DENORMAL = 0x14;
+constexpr u32 FPRF_POSITIVE_NORMAL = 0x04;
+constexpr u32 FPRF_POSITIVE_INFINITY = 0x05;
+
+// FPRF for a double-precision result
+inline u32 ClassifyDouble(u64 bits)
+{
+  const bool sign = (bits & DOUBLE_SIGN) != 0;
+  const u64 exp = bits & DOUBLE_EXP;
+  const u64 frac = bits & DOUBLE_FRAC;
+
+  if (exp == DOUBLE_EXP)
+  {
+    if (frac != 0)
+      return FPRF_QNAN;
+    return sign ? FPRF_NEGATIVE_INFINITY : FPRF_POSITIVE_INFINITY;
+  }
+  if (exp == 0)
+  {
+    if (frac == 0)
+      return sign ? FPRF_NEGATIVE_ZERO : FPRF_POSITIVE_ZERO;
+    return sign ? FPRF_NEGATIVE_DENORMAL : FPRF_POSITIVE_DENORMAL;
+  }
+  return sign ? FPRF_NEGATIVE_NORMAL : FPRF_POSITIVE_NORMAL;
+}
+
+// FPRF for a single-precision result, given as the double it is stored as in the FPR. Values that
+// are normal as doubles are classified as denormal if they would be denormal as floats.
+inline u32 ClassifySingle(u64 bits)
+{
+  const u64 exp = bits & DOUBLE_EXP;
+  constexpr u64 smallest_normal_exp = static_cast<u64>(1023 - 126) << DOUBLE_FRAC_WIDTH;
+
+  if (exp != 0 && exp != DOUBLE_EXP && exp < smallest_normal_exp)
+    return (bits & DOUBLE_SIGN) ? FPRF_NEGATIVE_DENORMAL : FPRF_POSITIVE_DENORMAL;
+  return ClassifyDouble(bits);
+}
+
+// Computes FPSCR after an arithmetic instruction. exceptions holds the exception bits the
+// instruction raised together with its FR and FI, fprf is the class of its result. The exception
+// bits are sticky, FX is only set by exceptions that were not already set, and VX and FEX
+// summarize the current exception bits.
+inline u32 UpdateFPSCR(u32 fpscr, u32 exceptions, u32 fprf)
+{
+  u32 result = fpscr & ~(FPSCR_FR | FPSCR_FI | FPSCR_FPRF | FPSCR_VX | FPSCR_FEX);
+  result |= exceptions & (FPSCR_ANY_X | FPSCR_FR | FPSCR_FI);
+  result |= fprf << FPSCR_FPRF_SHIFT;
+
+  if ((exceptions & ~fpscr & FPSCR_ANY_X) != 0)
+    result |= FPSCR_FX;
+  if ((result & FPSCR_ANY_VX) != 0)
+    result |= FPSCR_VX;
+
+  // The enable bits line up with the exception bits: VE/VX, OE/OX, UE/UX, ZE/ZX and XE/XX
+  constexpr u32 enable_bits = FPSCR_VE | FPSCR_OE | FPSCR_UE | FPSCR_ZE | FPSCR_XE;
+  if (((result >> 22) & result & enable_bits) != 0)
+    result |= FPSCR_FEX;
+
+  return result;
+}
 
-u64 TruncateMantissaBits(u64 bits)
+inline u64 TruncateMantissaBits(u64 bits)
 {
   // Truncate the bits (doesn't depend on rounding mode)
   constexpr u64 remove_bits = DOUBLE_FRAC_WIDTH - FLOAT_FRAC_WIDTH;
@@ -125,8 +241,34 @@ inline float RoundToFloatWithMode(double input, RoundingMode rounding_mode)
   return result;
 }
 
+// Widens a single-precision bit pattern the way lfs does. Unlike a conversion through float,
+// this keeps SNaNs signaling.
+inline u64 ConvertFloatBitsToDouble(u32 bits)
+{
+  const u64 sign = static_cast<u64>(bits & FLOAT_SIGN) << 32;
+  const u32 exp = (bits & FLOAT_EXP) >> FLOAT_FRAC_WIDTH;
+  u64 frac = bits & FLOAT_FRAC;
+  constexpr u32 frac_shift = DOUBLE_FRAC_WIDTH - FLOAT_FRAC_WIDTH;
+
+  if (exp == 0xFF)
+    return sign | DOUBLE_EXP | (frac << frac_shift);
 
-double frsqrte_expected(double val)
+  if (exp == 0)
+  {
+    if (frac == 0)
+      return sign;
+
+    // Single-precision denormals are normal in double precision
+    const int shift = Common::CountLeadingZeros(frac) - (63 - FLOAT_FRAC_WIDTH);
+    frac = (frac << shift) & FLOAT_FRAC;
+    const u64 biased_exp = 1023 - 126 - shift;
+    return sign | (biased_exp << DOUBLE_FRAC_WIDTH) | (frac << frac_shift);
+  }
+
+  return sign | (static_cast<u64>(exp - 127 + 1023) << DOUBLE_FRAC_WIDTH) | (frac << frac_shift);
+}
+
+inline double frsqrte_expected(double val)
 {
   static const int estimate_base[] = {
       0x3ffa000, 0x3c29000, 0x38aa000, 0x3572000, 0x3279000, 0x2fb7000, 0x2d26000, 0x2ac0000,
@@ -191,8 +333,7 @@ double frsqrte_expected(double val)
   return valf;
 }
 
-
-double fres_expected(double val, bool ni)
+inline double fres_expected(double val, bool ni)
 {
   static const s32 estimate_base[] = {
       0xfff000, 0xf07000, 0xe1d400, 0xd41000, 0xc71000, 0xbac400, 0xaf2000, 0xa41000,
@@ -267,4 +408,321 @@ double fres_expected(double val, bool ni)
     vali = sign | static_cast<u32>(exponent << FLOAT_FRAC_WIDTH) | new_mantissa;
   }
   return static_cast<double>(valf);
-}
\ No newline at end of file
+}
+
+// Algorithm adapted from Appendix C.4.2 in PowerPC Microprocessor Family:
+// The Programming Environments Manual for 32 and 64-bit Microprocessors
+inline u64 fctiw_expected(double b, RoundingMode rounding_mode)
+{
+  const u64 upper_bits = 0xfff8000000000000ull;
+  if (std::isnan(b))
+    return upper_bits | 0x80000000;
+
+  const u64 bi = Common::BitCast<u64>(b);
+
+  s32 sign = static_cast<s32>((bi & DOUBLE_SIGN) >> 63);
+  s32 exp = static_cast<s32>((bi & DOUBLE_EXP) >> 52);
+  u64 frac = ((bi & DOUBLE_FRAC) << 11);
+
+  if (exp > 0)
+    frac |= 1ull << 63;
+
+  if (exp > 0)
+    exp -= 1023;
+  else
+    exp = -1022;
+
+  bool gbit = false;
+  bool rbit = false;
+  bool xbit = false;
+  for (s64 i = 0; i < 63 - exp; ++i)
+  {
+    xbit |= rbit;
+    rbit = gbit;
+    gbit = frac & 1;
+    frac >>= 1;
+  }
+
+  u32 inc = 0;
+  switch (rounding_mode)
+  {
+  case RoundingMode::Nearest:
+    if (gbit && ((frac & 1) || rbit || xbit))
+      inc = 1;
+    break;
+  case RoundingMode::TowardsZero:
+    // Nothing
+    break;
+  case RoundingMode::TowardsPositiveInfinity:
+    if (!sign && (gbit || rbit || xbit))
+      inc = 1;
+    break;
+  case RoundingMode::TowardsNegativeInfinity:
+    if (sign && (gbit || rbit || xbit))
+      inc = 1;
+    break;
+  }
+
+  frac += inc;
+
+  if (!sign && frac > 0x7fffffff)
+  {
+    // Positive large operand or +inf
+    frac = 0x7fffffff;
+  }
+  else if (frac > 0x80000000)
+  {
+    // Negative large operand or -inf
+    frac = 0x80000000;
+  }
+  else if (sign)
+  {
+    // Appendix C.4.2 does not cast to 32-bit here, but doing so matches
+    // Broadway's behavior of setting bit 31 to 1 for negative zeroes.
+    // Bits 0-31 are undefined according to appendix C.4.2.
+    frac = static_cast<u64>(~static_cast<u32>(frac)) + 1;
+  }
+
+  return upper_bits | frac;
+}
+
+// GQR load and store types
+enum class QuantizeType : u32
+{
+  Float = 0,
+  U8 = 4,
+  U16 = 5,
+  S8 = 6,
+  S16 = 7,
+};
+
+constexpr u32 GQR_ST_TYPE_SHIFT = 0;
+constexpr u32 GQR_ST_SCALE_SHIFT = 8;
+constexpr u32 GQR_LD_TYPE_SHIFT = 16;
+constexpr u32 GQR_LD_SCALE_SHIFT = 24;
+
+constexpr u32 MakeGQR(QuantizeType ld_type, u32 ld_scale, QuantizeType st_type, u32 st_scale)
+{
+  return (static_cast<u32>(ld_type) << GQR_LD_TYPE_SHIFT) | (ld_scale << GQR_LD_SCALE_SHIFT) |
+         (static_cast<u32>(st_type) << GQR_ST_TYPE_SHIFT) | (st_scale << GQR_ST_SCALE_SHIFT);
+}
+
+constexpr u32 QuantizeTypeSize(QuantizeType type)
+{
+  switch (type)
+  {
+  case QuantizeType::U8:
+  case QuantizeType::S8:
+    return 1;
+  case QuantizeType::U16:
+  case QuantizeType::S16:
+    return 2;
+  default:
+    return 4;
+  }
+}
+
+// 2^exponent for exponent in [-32, 31], built directly so that it is exact everywhere
+inline float QuantizePowerOfTwo(s32 exponent)
+{
+  return Common::BitCast<float>(static_cast<u32>(127 + exponent) << FLOAT_FRAC_WIDTH);
+}
+
+// The GQR scale fields are 6-bit signed numbers. Loads divide by 2^scale, stores multiply.
+inline float DequantizeFactor(u32 scale)
+{
+  const s32 signed_scale = scale >= 32 ? static_cast<s32>(scale) - 64 : static_cast<s32>(scale);
+  return QuantizePowerOfTwo(-signed_scale);
+}
+
+inline float QuantizeFactor(u32 scale)
+{
+  const s32 signed_scale = scale >= 32 ? static_cast<s32>(scale) - 64 : static_cast<s32>(scale);
+  return QuantizePowerOfTwo(signed_scale);
+}
+
+// What psq_l produces for one element. raw holds the element as loaded from memory, zero-extended.
+// Every integer fits in a float and the factor is a power of two that can't push it out of the
+// normal range, so the result is exact.
+inline float Dequantize(u32 raw, QuantizeType type, u32 scale)
+{
+  switch (type)
+  {
+  case QuantizeType::U8:
+    return static_cast<float>(raw & 0xFF) * DequantizeFactor(scale);
+  case QuantizeType::U16:
+    return static_cast<float>(raw & 0xFFFF) * DequantizeFactor(scale);
+  case QuantizeType::S8:
+    return static_cast<float>(static_cast<s8>(raw)) * DequantizeFactor(scale);
+  case QuantizeType::S16:
+    return static_cast<float>(static_cast<s16>(raw)) * DequantizeFactor(scale);
+  default:
+    return Common::BitCast<float>(raw);
+  }
+}
+
+// What psq_st writes for one element, zero-extended. Integer types are scaled in single precision,
+// clamped to the range of the type and truncated towards zero, like Dolphin does. The clamping
+// sends NaN to the minimum, which matches the SSE2 path but is not verified on hardware.
+inline u32 Quantize(float value, QuantizeType type, u32 scale)
+{
+  float min;
+  float max;
+  switch (type)
+  {
+  case QuantizeType::U8:
+    min = 0.0f;
+    max = 255.0f;
+    break;
+  case QuantizeType::U16:
+    min = 0.0f;
+    max = 65535.0f;
+    break;
+  case QuantizeType::S8:
+    min = -128.0f;
+    max = 127.0f;
+    break;
+  case QuantizeType::S16:
+    min = -32768.0f;
+    max = 32767.0f;
+    break;
+  default:
+    return Common::BitCast<u32>(value);
+  }
+
+  float scaled = value * QuantizeFactor(scale);
+  scaled = scaled > min ? scaled : min;
+  scaled = scaled < max ? scaled : max;
+  const u32 mask = type == QuantizeType::U8 || type == QuantizeType::S8 ? 0xFF : 0xFFFF;
+  return static_cast<u32>(static_cast<s32>(scaled)) & mask;
+}
+
+// Batch versions of Dequantize and Quantize, working on elements stored big-endian like in the
+// console's memory. The host gets SSE2 paths, which tools/quantize_batch_check compares with the
+// scalar code.
+inline void DequantizeBatch(const u8* src, float* dst, u32 count, QuantizeType type, u32 scale)
+{
+  const u32 size = QuantizeTypeSize(type);
+  u32 i = 0;
+
+#ifdef __SSE2__
+  const __m128 factor = _mm_set1_ps(DequantizeFactor(scale));
+  const __m128i zero = _mm_setzero_si128();
+  switch (type)
+  {
+  case QuantizeType::U8:
+  case QuantizeType::S8:
+    for (; i + 16 <= count; i += 16)
+    {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      __m128i halves[2];
+      if (type == QuantizeType::U8)
+      {
+        halves[0] = _mm_unpacklo_epi8(bytes, zero);
+        halves[1] = _mm_unpackhi_epi8(bytes, zero);
+      }
+      else
+      {
+        halves[0] = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+        halves[1] = _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8);
+      }
+      for (u32 j = 0; j < 2; ++j)
+      {
+        // Values are non-negative for U8, so sign extension is fine for both
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(halves[j], halves[j]), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(halves[j], halves[j]), 16);
+        _mm_storeu_ps(dst + i + 8 * j, _mm_mul_ps(_mm_cvtepi32_ps(lo), factor));
+        _mm_storeu_ps(dst + i + 8 * j + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), factor));
+      }
+    }
+    break;
+  case QuantizeType::U16:
+  case QuantizeType::S16:
+    for (; i + 8 <= count; i += 8)
+    {
+      __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+      halves = _mm_or_si128(_mm_slli_epi16(halves, 8), _mm_srli_epi16(halves, 8));
+      __m128i lo, hi;
+      if (type == QuantizeType::U16)
+      {
+        lo = _mm_unpacklo_epi16(halves, zero);
+        hi = _mm_unpackhi_epi16(halves, zero);
+      }
+      else
+      {
+        lo = _mm_srai_epi32(_mm_unpacklo_epi16(halves, halves), 16);
+        hi = _mm_srai_epi32(_mm_unpackhi_epi16(halves, halves), 16);
+      }
+      _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), factor));
+      _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), factor));
+    }
+    break;
+  default:
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+      words = _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+      words = _mm_shufflelo_epi16(words, _MM_SHUFFLE(2, 3, 0, 1));
+      words = _mm_shufflehi_epi16(words, _MM_SHUFFLE(2, 3, 0, 1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), words);
+    }
+    break;
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    u32 raw = 0;
+    for (u32 j = 0; j < size; ++j)
+      raw = (raw << 8) | src[i * size + j];
+    dst[i] = Dequantize(raw, type, scale);
+  }
+}
+
+inline void QuantizeBatch(const float* src, u8* dst, u32 count, QuantizeType type, u32 scale)
+{
+  const u32 size = QuantizeTypeSize(type);
+  u32 i = 0;
+
+#ifdef __SSE2__
+  if (type != QuantizeType::Float)
+  {
+    const bool is_signed = type == QuantizeType::S8 || type == QuantizeType::S16;
+    const __m128 factor = _mm_set1_ps(QuantizeFactor(scale));
+    const __m128 min = _mm_set1_ps(is_signed ? (size == 1 ? -128.0f : -32768.0f) : 0.0f);
+    const __m128 max = _mm_set1_ps(size == 1 ? (is_signed ? 127.0f : 255.0f) :
+                                               (is_signed ? 32767.0f : 65535.0f));
+    for (; i + 4 <= count; i += 4)
+    {
+      // Same operand order as the scalar code, so that NaNs are clamped the same way
+      __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i), factor);
+      scaled = _mm_min_ps(_mm_max_ps(scaled, min), max);
+      __m128i values = _mm_cvttps_epi32(scaled);
+
+      if (size == 1)
+      {
+        values = _mm_packs_epi32(values, values);
+        values = is_signed ? _mm_packs_epi16(values, values) : _mm_packus_epi16(values, values);
+        const u32 bytes = static_cast<u32>(_mm_cvtsi128_si32(values));
+        std::memcpy(dst + i, &bytes, 4);
+      }
+      else
+      {
+        // There's no unsigned 32-to-16-bit pack in SSE2, so bias U16 into the signed range
+        const __m128i bias = _mm_set1_epi32(is_signed ? 0 : 0x8000);
+        values = _mm_packs_epi32(_mm_sub_epi32(values, bias), _mm_sub_epi32(values, bias));
+        values = _mm_xor_si128(values, _mm_set1_epi16(is_signed ? 0 : -0x8000));
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 2 * i), values);
+      }
+    }
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    const u32 raw = Quantize(src[i], type, scale);
+    for (u32 j = 0; j < size; ++j)
+      dst[i * size + j] = static_cast<u8>(raw >> (8 * (size - 1 - j)));
+  }
+}
@@ -0,0 +1,95 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Operands for the fused multiply-add sweep of cputest/fmadd.cpp. They are chosen so that the
+// exact result lands on or right next to a rounding boundary of the target precision, where
+// rounding the product before adding (or rounding twice) gives a different result. It doesn't
+// depend on anything console-specific, so tools/exact_float_check runs the same inputs against
+// the host's fma.
+
+#pragma once
+
+#include <algorithm>
+
+#include "Common/CommonTypes.h"
+#include "Common/ExactFloat.h"
+#include "Common/FloatUtils.h"
+#include "Common/Random.h"
+
+// Operands in the order of the instruction fields: a * c + b
+struct FMAInputs
+{
+  u64 a;
+  u64 c;
+  u64 b;
+};
+
+// Half an ulp of value in the given precision, or the smallest denormal if that's too small to
+// represent
+inline u64 HalfUlp(u64 value, FloatPrecision precision)
+{
+  const s32 exponent = GetExponent(value) - (precision == FloatPrecision::Double ? 53 : 24);
+  return exponent > 0 ? MakeDouble(false, exponent, 0) : 1;
+}
+
+// Moves a finite value the given number of ulps away from zero (towards zero if negative), stopping
+// at zero
+inline u64 AddUlps(u64 value, s32 ulps)
+{
+  const u64 magnitude = value & ~DOUBLE_SIGN;
+  if (ulps < 0 && magnitude < static_cast<u64>(-ulps))
+    return value & DOUBLE_SIGN;
+  return (value & DOUBLE_SIGN) | (magnitude + static_cast<u64>(static_cast<s64>(ulps)));
+}
+
+inline FMAInputs GenerateFMAInputs(Random& random, FloatPrecision target)
+{
+  // Keep the product in the normal range most of the time, but also put it right at the bottom of
+  // the normal range of the target precision, where NI and denormal rounding come in
+  const bool near_denormal = random.NextBelow(5) == 0;
+  const s32 smallest_normal = target == FloatPrecision::Double ? 1 : 1023 - 126;
+  const s32 product_exponent = near_denormal ? smallest_normal + random.NextInRange(-8, 8) :
+                                               1023 + random.NextInRange(-60, 60);
+  const s32 a_exponent = 1023 + random.NextInRange(-30, 30);
+  const s32 c_exponent = std::max(product_exponent + 1023 - a_exponent, 1);
+
+  // Operands with single-precision mantissas, like the ones games load with lfs or psq_l
+  const u64 fraction_mask = random.NextBool() ? DOUBLE_FRAC & ~0x1FFFFFFFULL : DOUBLE_FRAC;
+
+  FMAInputs in;
+  in.a = MakeDouble(random.NextBool(), a_exponent, random.Next64() & fraction_mask);
+  in.c = MakeDouble(random.NextBool(), c_exponent, random.Next64() & fraction_mask);
+
+  FPState state;
+  const u64 product = FloatMul(in.a, in.c, target, state);
+
+  switch (random.NextBelow(4))
+  {
+  case 0:
+  {
+    // Cancel the rounded product, leaving its rounding error (or a neighbor of it)
+    in.b = AddUlps(product ^ DOUBLE_SIGN, random.NextInRange(-2, 2));
+    break;
+  }
+  case 1:
+  case 2:
+  {
+    // Land on the midpoint between two representable results, or right next to it, so that the
+    // low bits of the product decide the rounding
+    u64 half = HalfUlp(product, target);
+    if (random.NextBool())
+      half = AddUlps(half, random.NextInRange(-2, 2));
+    in.b = half | (random.NextBool() ? DOUBLE_SIGN : 0);
+    break;
+  }
+  default:
+  {
+    // Anything close enough in magnitude to overlap the product
+    const s32 exponent = std::max(GetExponent(product) + random.NextInRange(-60, 60), 0);
+    in.b = MakeDouble(random.NextBool(), exponent, random.Next64() & fraction_mask);
+    break;
+  }
+  }
+
+  return in;
+}
@@ -0,0 +1,35 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Expected results of the FPRF sweep in cputest/fprf.cpp, which tools/expected_stream also
+// serves as ExpectedKind::Fprf (see Common/ExpectedStreamProtocol.h).
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "Common/ExactFloat.h"
+#include "Common/FloatUtils.h"
+
+// Computes the four entries of ExpectedKind::Fprf for count consecutive float bit patterns
+// starting at first: the result and FPSCR of fadds i, -0.0 and of fmuls i, i, each starting from
+// a cleared FPSCR with the given rounding mode.
+inline void ComputeFprfSweepBlock(u32 first, u32 count, RoundingMode rounding_mode, u64* expected)
+{
+  const u32 initial_fpscr = static_cast<u32>(rounding_mode);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u64 value = ConvertFloatBitsToDouble(first + i);
+
+    FPState add_state;
+    add_state.rounding_mode = rounding_mode;
+    const u64 sum = FloatAdd(value, DOUBLE_SIGN, FloatPrecision::Single, add_state);
+    expected[4 * i] = sum;
+    expected[4 * i + 1] = UpdateFPSCR(initial_fpscr, add_state.fpscr, ClassifySingle(sum));
+
+    FPState mul_state;
+    mul_state.rounding_mode = rounding_mode;
+    const u64 product = FloatMul(value, value, FloatPrecision::Single, mul_state);
+    expected[4 * i + 2] = product;
+    expected[4 * i + 3] = UpdateFPSCR(initial_fpscr, mul_state.fpscr, ClassifySingle(product));
+  }
+}
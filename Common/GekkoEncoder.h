@@ -0,0 +1,610 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// constexpr encoders for Gekko/Broadway instructions, for tests that generate code at runtime
+// (see CodeBuffer.h). Everything here is plain integer arithmetic, so it works the same on the
+// host and on the console, and the known encodings at the bottom of this file are checked by
+// every build that includes it.
+//
+// Functions are named after the mnemonics and take the operands in assembler order, with
+// registers given as plain numbers. Record forms (the ones with a trailing dot) are selected with
+// the rc argument, overflow-enable forms (trailing o) with oe.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+namespace Gekko
+{
+// Instruction forms
+
+constexpr u32 DForm(u32 opcode, u32 d, u32 a, s32 imm)
+{
+  return (opcode << 26) | (d << 21) | (a << 16) | (static_cast<u32>(imm) & 0xFFFF);
+}
+
+constexpr u32 XForm(u32 opcode, u32 d, u32 a, u32 b, u32 xo, bool rc = false)
+{
+  return (opcode << 26) | (d << 21) | (a << 16) | (b << 11) | (xo << 1) | (rc ? 1 : 0);
+}
+
+constexpr u32 XOForm(u32 opcode, u32 d, u32 a, u32 b, bool oe, u32 xo, bool rc)
+{
+  return (opcode << 26) | (d << 21) | (a << 16) | (b << 11) | (oe ? 1 << 10 : 0) | (xo << 1) |
+         (rc ? 1 : 0);
+}
+
+constexpr u32 MForm(u32 opcode, u32 s, u32 a, u32 b, u32 mb, u32 me, bool rc)
+{
+  return (opcode << 26) | (s << 21) | (a << 16) | (b << 11) | (mb << 6) | (me << 1) | (rc ? 1 : 0);
+}
+
+constexpr u32 AForm(u32 opcode, u32 d, u32 a, u32 b, u32 c, u32 xo, bool rc)
+{
+  return (opcode << 26) | (d << 21) | (a << 16) | (b << 11) | (c << 6) | (xo << 1) | (rc ? 1 : 0);
+}
+
+// The two halves of the SPR number are swapped in the encoding
+constexpr u32 XFXForm(u32 opcode, u32 d, u32 spr, u32 xo)
+{
+  return XForm(opcode, d, spr & 0x1F, (spr >> 5) & 0x1F, xo);
+}
+
+// psq_l, psq_lu, psq_st and psq_stu: 12-bit offset, W bit and GQR index
+constexpr u32 PSQForm(u32 opcode, u32 fd, u32 a, s32 offset, bool w, u32 gqr)
+{
+  return (opcode << 26) | (fd << 21) | (a << 16) | (w ? 1 << 15 : 0) | (gqr << 12) |
+         (static_cast<u32>(offset) & 0xFFF);
+}
+
+// psq_lx, psq_lux, psq_stx and psq_stux
+constexpr u32 PSQXForm(u32 fd, u32 a, u32 b, bool w, u32 gqr, u32 xo)
+{
+  return (4 << 26) | (fd << 21) | (a << 16) | (b << 11) | (w ? 1 << 10 : 0) | (gqr << 7) |
+         (xo << 1);
+}
+
+// Special purpose registers
+constexpr u32 SPR_XER = 1;
+constexpr u32 SPR_LR = 8;
+constexpr u32 SPR_CTR = 9;
+constexpr u32 SPR_GQR0 = 912;
+
+// Integer arithmetic
+
+constexpr u32 ADDI(u32 rd, u32 ra, s32 simm) { return DForm(14, rd, ra, simm); }
+constexpr u32 ADDIS(u32 rd, u32 ra, s32 simm) { return DForm(15, rd, ra, simm); }
+constexpr u32 ADDIC(u32 rd, u32 ra, s32 simm, bool rc = false)
+{
+  return DForm(rc ? 13 : 12, rd, ra, simm);
+}
+constexpr u32 SUBFIC(u32 rd, u32 ra, s32 simm) { return DForm(8, rd, ra, simm); }
+constexpr u32 MULLI(u32 rd, u32 ra, s32 simm) { return DForm(7, rd, ra, simm); }
+constexpr u32 LI(u32 rd, s32 simm) { return ADDI(rd, 0, simm); }
+constexpr u32 LIS(u32 rd, s32 simm) { return ADDIS(rd, 0, simm); }
+
+constexpr u32 ADD(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 266, rc);
+}
+constexpr u32 ADDC(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 10, rc);
+}
+constexpr u32 ADDE(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 138, rc);
+}
+constexpr u32 ADDME(u32 rd, u32 ra, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, 0, oe, 234, rc);
+}
+constexpr u32 ADDZE(u32 rd, u32 ra, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, 0, oe, 202, rc);
+}
+constexpr u32 SUBF(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 40, rc);
+}
+constexpr u32 SUBFC(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 8, rc);
+}
+constexpr u32 SUBFE(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 136, rc);
+}
+constexpr u32 SUBFME(u32 rd, u32 ra, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, 0, oe, 232, rc);
+}
+constexpr u32 SUBFZE(u32 rd, u32 ra, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, 0, oe, 200, rc);
+}
+constexpr u32 NEG(u32 rd, u32 ra, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, 0, oe, 104, rc);
+}
+constexpr u32 MULLW(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 235, rc);
+}
+constexpr u32 MULHW(u32 rd, u32 ra, u32 rb, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, false, 75, rc);
+}
+constexpr u32 MULHWU(u32 rd, u32 ra, u32 rb, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, false, 11, rc);
+}
+constexpr u32 DIVW(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 491, rc);
+}
+constexpr u32 DIVWU(u32 rd, u32 ra, u32 rb, bool oe = false, bool rc = false)
+{
+  return XOForm(31, rd, ra, rb, oe, 459, rc);
+}
+
+// Integer logic, shifts and rotates. These put rS in the first register field.
+
+constexpr u32 AND(u32 ra, u32 rs, u32 rb, bool rc = false) { return XForm(31, rs, ra, rb, 28, rc); }
+constexpr u32 ANDC(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 60, rc);
+}
+constexpr u32 OR(u32 ra, u32 rs, u32 rb, bool rc = false) { return XForm(31, rs, ra, rb, 444, rc); }
+constexpr u32 ORC(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 412, rc);
+}
+constexpr u32 XOR(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 316, rc);
+}
+constexpr u32 NAND(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 476, rc);
+}
+constexpr u32 NOR(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 124, rc);
+}
+constexpr u32 EQV(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 284, rc);
+}
+constexpr u32 SLW(u32 ra, u32 rs, u32 rb, bool rc = false) { return XForm(31, rs, ra, rb, 24, rc); }
+constexpr u32 SRW(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 536, rc);
+}
+constexpr u32 SRAW(u32 ra, u32 rs, u32 rb, bool rc = false)
+{
+  return XForm(31, rs, ra, rb, 792, rc);
+}
+constexpr u32 SRAWI(u32 ra, u32 rs, u32 sh, bool rc = false)
+{
+  return XForm(31, rs, ra, sh, 824, rc);
+}
+constexpr u32 CNTLZW(u32 ra, u32 rs, bool rc = false) { return XForm(31, rs, ra, 0, 26, rc); }
+constexpr u32 EXTSB(u32 ra, u32 rs, bool rc = false) { return XForm(31, rs, ra, 0, 954, rc); }
+constexpr u32 EXTSH(u32 ra, u32 rs, bool rc = false) { return XForm(31, rs, ra, 0, 922, rc); }
+constexpr u32 MR(u32 ra, u32 rs, bool rc = false) { return OR(ra, rs, rs, rc); }
+
+constexpr u32 ORI(u32 ra, u32 rs, u32 uimm) { return DForm(24, rs, ra, uimm); }
+constexpr u32 ORIS(u32 ra, u32 rs, u32 uimm) { return DForm(25, rs, ra, uimm); }
+constexpr u32 XORI(u32 ra, u32 rs, u32 uimm) { return DForm(26, rs, ra, uimm); }
+constexpr u32 XORIS(u32 ra, u32 rs, u32 uimm) { return DForm(27, rs, ra, uimm); }
+// andi. and andis. only exist as record forms
+constexpr u32 ANDI_RC(u32 ra, u32 rs, u32 uimm) { return DForm(28, rs, ra, uimm); }
+constexpr u32 ANDIS_RC(u32 ra, u32 rs, u32 uimm) { return DForm(29, rs, ra, uimm); }
+constexpr u32 NOP() { return ORI(0, 0, 0); }
+
+constexpr u32 RLWIMI(u32 ra, u32 rs, u32 sh, u32 mb, u32 me, bool rc = false)
+{
+  return MForm(20, rs, ra, sh, mb, me, rc);
+}
+constexpr u32 RLWINM(u32 ra, u32 rs, u32 sh, u32 mb, u32 me, bool rc = false)
+{
+  return MForm(21, rs, ra, sh, mb, me, rc);
+}
+constexpr u32 RLWNM(u32 ra, u32 rs, u32 rb, u32 mb, u32 me, bool rc = false)
+{
+  return MForm(23, rs, ra, rb, mb, me, rc);
+}
+constexpr u32 SLWI(u32 ra, u32 rs, u32 n) { return RLWINM(ra, rs, n, 0, 31 - n); }
+constexpr u32 SRWI(u32 ra, u32 rs, u32 n) { return RLWINM(ra, rs, (32 - n) & 31, n, 31); }
+
+// Integer compares
+
+constexpr u32 CMPW(u32 crfd, u32 ra, u32 rb) { return XForm(31, crfd << 2, ra, rb, 0); }
+constexpr u32 CMPLW(u32 crfd, u32 ra, u32 rb) { return XForm(31, crfd << 2, ra, rb, 32); }
+constexpr u32 CMPWI(u32 crfd, u32 ra, s32 simm) { return DForm(11, crfd << 2, ra, simm); }
+constexpr u32 CMPLWI(u32 crfd, u32 ra, u32 uimm) { return DForm(10, crfd << 2, ra, uimm); }
+
+// Integer loads and stores
+
+constexpr u32 LWZ(u32 rd, s32 d, u32 ra) { return DForm(32, rd, ra, d); }
+constexpr u32 LWZU(u32 rd, s32 d, u32 ra) { return DForm(33, rd, ra, d); }
+constexpr u32 LBZ(u32 rd, s32 d, u32 ra) { return DForm(34, rd, ra, d); }
+constexpr u32 LBZU(u32 rd, s32 d, u32 ra) { return DForm(35, rd, ra, d); }
+constexpr u32 STW(u32 rs, s32 d, u32 ra) { return DForm(36, rs, ra, d); }
+constexpr u32 STWU(u32 rs, s32 d, u32 ra) { return DForm(37, rs, ra, d); }
+constexpr u32 STB(u32 rs, s32 d, u32 ra) { return DForm(38, rs, ra, d); }
+constexpr u32 STBU(u32 rs, s32 d, u32 ra) { return DForm(39, rs, ra, d); }
+constexpr u32 LHZ(u32 rd, s32 d, u32 ra) { return DForm(40, rd, ra, d); }
+constexpr u32 LHZU(u32 rd, s32 d, u32 ra) { return DForm(41, rd, ra, d); }
+constexpr u32 LHA(u32 rd, s32 d, u32 ra) { return DForm(42, rd, ra, d); }
+constexpr u32 LHAU(u32 rd, s32 d, u32 ra) { return DForm(43, rd, ra, d); }
+constexpr u32 STH(u32 rs, s32 d, u32 ra) { return DForm(44, rs, ra, d); }
+constexpr u32 STHU(u32 rs, s32 d, u32 ra) { return DForm(45, rs, ra, d); }
+constexpr u32 LMW(u32 rd, s32 d, u32 ra) { return DForm(46, rd, ra, d); }
+constexpr u32 STMW(u32 rs, s32 d, u32 ra) { return DForm(47, rs, ra, d); }
+
+constexpr u32 LWZX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 23); }
+constexpr u32 LWZUX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 55); }
+constexpr u32 LBZX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 87); }
+constexpr u32 LBZUX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 119); }
+constexpr u32 LHZX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 279); }
+constexpr u32 LHZUX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 311); }
+constexpr u32 LHAX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 343); }
+constexpr u32 LHAUX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 375); }
+constexpr u32 LWBRX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 534); }
+constexpr u32 LHBRX(u32 rd, u32 ra, u32 rb) { return XForm(31, rd, ra, rb, 790); }
+constexpr u32 STWX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 151); }
+constexpr u32 STWUX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 183); }
+constexpr u32 STBX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 215); }
+constexpr u32 STBUX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 247); }
+constexpr u32 STHX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 407); }
+constexpr u32 STHUX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 439); }
+constexpr u32 STWBRX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 662); }
+constexpr u32 STHBRX(u32 rs, u32 ra, u32 rb) { return XForm(31, rs, ra, rb, 918); }
+
+// Branches, condition and special registers, synchronization
+
+constexpr u32 B(s32 offset, bool lk = false)
+{
+  return (18 << 26) | (static_cast<u32>(offset) & 0x03FFFFFC) | (lk ? 1 : 0);
+}
+constexpr u32 BC(u32 bo, u32 bi, s32 offset, bool lk = false)
+{
+  return (16 << 26) | (bo << 21) | (bi << 16) | (static_cast<u32>(offset) & 0xFFFC) | (lk ? 1 : 0);
+}
+constexpr u32 BCLR(u32 bo, u32 bi, bool lk = false) { return XForm(19, bo, bi, 0, 16, lk); }
+constexpr u32 BLR() { return BCLR(20, 0); }
+// Decrements CTR and branches if it isn't zero
+constexpr u32 BDNZ(s32 offset) { return BC(16, 0, offset); }
+
+constexpr u32 MFSPR(u32 rd, u32 spr) { return XFXForm(31, rd, spr, 339); }
+constexpr u32 MTSPR(u32 spr, u32 rs) { return XFXForm(31, rs, spr, 467); }
+constexpr u32 MFXER(u32 rd) { return MFSPR(rd, SPR_XER); }
+constexpr u32 MTXER(u32 rs) { return MTSPR(SPR_XER, rs); }
+constexpr u32 MFLR(u32 rd) { return MFSPR(rd, SPR_LR); }
+constexpr u32 MTLR(u32 rs) { return MTSPR(SPR_LR, rs); }
+constexpr u32 MFCTR(u32 rd) { return MFSPR(rd, SPR_CTR); }
+constexpr u32 MTCTR(u32 rs) { return MTSPR(SPR_CTR, rs); }
+constexpr u32 MFCR(u32 rd) { return XForm(31, rd, 0, 0, 19); }
+constexpr u32 MTCRF(u32 crm, u32 rs) { return (31 << 26) | (rs << 21) | (crm << 12) | (144 << 1); }
+constexpr u32 MCRXR(u32 crfd) { return XForm(31, crfd << 2, 0, 0, 512); }
+
+constexpr u32 ISYNC() { return XForm(19, 0, 0, 0, 150); }
+constexpr u32 SYNC() { return XForm(31, 0, 0, 0, 598); }
+
+// Floating-point loads and stores
+
+constexpr u32 LFS(u32 frd, s32 d, u32 ra) { return DForm(48, frd, ra, d); }
+constexpr u32 LFSU(u32 frd, s32 d, u32 ra) { return DForm(49, frd, ra, d); }
+constexpr u32 LFD(u32 frd, s32 d, u32 ra) { return DForm(50, frd, ra, d); }
+constexpr u32 LFDU(u32 frd, s32 d, u32 ra) { return DForm(51, frd, ra, d); }
+constexpr u32 STFS(u32 frs, s32 d, u32 ra) { return DForm(52, frs, ra, d); }
+constexpr u32 STFSU(u32 frs, s32 d, u32 ra) { return DForm(53, frs, ra, d); }
+constexpr u32 STFD(u32 frs, s32 d, u32 ra) { return DForm(54, frs, ra, d); }
+constexpr u32 STFDU(u32 frs, s32 d, u32 ra) { return DForm(55, frs, ra, d); }
+constexpr u32 LFSX(u32 frd, u32 ra, u32 rb) { return XForm(31, frd, ra, rb, 535); }
+constexpr u32 LFDX(u32 frd, u32 ra, u32 rb) { return XForm(31, frd, ra, rb, 599); }
+constexpr u32 STFSX(u32 frs, u32 ra, u32 rb) { return XForm(31, frs, ra, rb, 663); }
+constexpr u32 STFDX(u32 frs, u32 ra, u32 rb) { return XForm(31, frs, ra, rb, 727); }
+constexpr u32 STFIWX(u32 frs, u32 ra, u32 rb) { return XForm(31, frs, ra, rb, 983); }
+
+// Floating-point arithmetic. The single-precision variants use primary opcode 59 instead of 63.
+
+constexpr u32 FADD(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, 0, 21, rc);
+}
+constexpr u32 FADDS(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, 0, 21, rc);
+}
+constexpr u32 FSUB(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, 0, 20, rc);
+}
+constexpr u32 FSUBS(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, 0, 20, rc);
+}
+constexpr u32 FMUL(u32 frd, u32 fra, u32 frc, bool rc = false)
+{
+  return AForm(63, frd, fra, 0, frc, 25, rc);
+}
+constexpr u32 FMULS(u32 frd, u32 fra, u32 frc, bool rc = false)
+{
+  return AForm(59, frd, fra, 0, frc, 25, rc);
+}
+constexpr u32 FDIV(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, 0, 18, rc);
+}
+constexpr u32 FDIVS(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, 0, 18, rc);
+}
+constexpr u32 FMADD(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, frc, 29, rc);
+}
+constexpr u32 FMADDS(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, frc, 29, rc);
+}
+constexpr u32 FMSUB(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, frc, 28, rc);
+}
+constexpr u32 FMSUBS(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, frc, 28, rc);
+}
+constexpr u32 FNMADD(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, frc, 31, rc);
+}
+constexpr u32 FNMADDS(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, frc, 31, rc);
+}
+constexpr u32 FNMSUB(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, frc, 30, rc);
+}
+constexpr u32 FNMSUBS(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(59, frd, fra, frb, frc, 30, rc);
+}
+constexpr u32 FSEL(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, fra, frb, frc, 23, rc);
+}
+constexpr u32 FRES(u32 frd, u32 frb, bool rc = false) { return AForm(59, frd, 0, frb, 0, 24, rc); }
+constexpr u32 FRSQRTE(u32 frd, u32 frb, bool rc = false)
+{
+  return AForm(63, frd, 0, frb, 0, 26, rc);
+}
+
+// Floating-point moves, conversions, compares and FPSCR access
+
+constexpr u32 FMR(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 72, rc); }
+constexpr u32 FNEG(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 40, rc); }
+constexpr u32 FABS(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 264, rc); }
+constexpr u32 FNABS(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 136, rc); }
+constexpr u32 FRSP(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 12, rc); }
+constexpr u32 FCTIW(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 14, rc); }
+constexpr u32 FCTIWZ(u32 frd, u32 frb, bool rc = false) { return XForm(63, frd, 0, frb, 15, rc); }
+constexpr u32 FCMPU(u32 crfd, u32 fra, u32 frb) { return XForm(63, crfd << 2, fra, frb, 0); }
+constexpr u32 FCMPO(u32 crfd, u32 fra, u32 frb) { return XForm(63, crfd << 2, fra, frb, 32); }
+constexpr u32 MFFS(u32 frd, bool rc = false) { return XForm(63, frd, 0, 0, 583, rc); }
+constexpr u32 MTFSF(u32 fm, u32 frb, bool rc = false)
+{
+  return (63 << 26) | (fm << 17) | (frb << 11) | (711 << 1) | (rc ? 1 : 0);
+}
+constexpr u32 MTFSFI(u32 crfd, u32 imm, bool rc = false)
+{
+  return XForm(63, crfd << 2, 0, imm << 1, 134, rc);
+}
+constexpr u32 MTFSB0(u32 crbd, bool rc = false) { return XForm(63, crbd, 0, 0, 70, rc); }
+constexpr u32 MTFSB1(u32 crbd, bool rc = false) { return XForm(63, crbd, 0, 0, 38, rc); }
+
+// Paired singles (primary opcode 4)
+
+constexpr u32 PS_ADD(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, 0, 21, rc);
+}
+constexpr u32 PS_SUB(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, 0, 20, rc);
+}
+constexpr u32 PS_MUL(u32 frd, u32 fra, u32 frc, bool rc = false)
+{
+  return AForm(4, frd, fra, 0, frc, 25, rc);
+}
+constexpr u32 PS_DIV(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, 0, 18, rc);
+}
+constexpr u32 PS_MULS0(u32 frd, u32 fra, u32 frc, bool rc = false)
+{
+  return AForm(4, frd, fra, 0, frc, 12, rc);
+}
+constexpr u32 PS_MULS1(u32 frd, u32 fra, u32 frc, bool rc = false)
+{
+  return AForm(4, frd, fra, 0, frc, 13, rc);
+}
+constexpr u32 PS_MADD(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 29, rc);
+}
+constexpr u32 PS_MSUB(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 28, rc);
+}
+constexpr u32 PS_NMADD(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 31, rc);
+}
+constexpr u32 PS_NMSUB(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 30, rc);
+}
+constexpr u32 PS_MADDS0(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 14, rc);
+}
+constexpr u32 PS_MADDS1(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 15, rc);
+}
+constexpr u32 PS_SUM0(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 10, rc);
+}
+constexpr u32 PS_SUM1(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 11, rc);
+}
+constexpr u32 PS_SEL(u32 frd, u32 fra, u32 frc, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, fra, frb, frc, 23, rc);
+}
+constexpr u32 PS_RES(u32 frd, u32 frb, bool rc = false) { return AForm(4, frd, 0, frb, 0, 24, rc); }
+constexpr u32 PS_RSQRTE(u32 frd, u32 frb, bool rc = false)
+{
+  return AForm(4, frd, 0, frb, 0, 26, rc);
+}
+
+constexpr u32 PS_MR(u32 frd, u32 frb, bool rc = false) { return XForm(4, frd, 0, frb, 72, rc); }
+constexpr u32 PS_NEG(u32 frd, u32 frb, bool rc = false) { return XForm(4, frd, 0, frb, 40, rc); }
+constexpr u32 PS_ABS(u32 frd, u32 frb, bool rc = false) { return XForm(4, frd, 0, frb, 264, rc); }
+constexpr u32 PS_NABS(u32 frd, u32 frb, bool rc = false) { return XForm(4, frd, 0, frb, 136, rc); }
+constexpr u32 PS_MERGE00(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return XForm(4, frd, fra, frb, 528, rc);
+}
+constexpr u32 PS_MERGE01(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return XForm(4, frd, fra, frb, 560, rc);
+}
+constexpr u32 PS_MERGE10(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return XForm(4, frd, fra, frb, 592, rc);
+}
+constexpr u32 PS_MERGE11(u32 frd, u32 fra, u32 frb, bool rc = false)
+{
+  return XForm(4, frd, fra, frb, 624, rc);
+}
+constexpr u32 PS_CMPU0(u32 crfd, u32 fra, u32 frb) { return XForm(4, crfd << 2, fra, frb, 0); }
+constexpr u32 PS_CMPO0(u32 crfd, u32 fra, u32 frb) { return XForm(4, crfd << 2, fra, frb, 32); }
+constexpr u32 PS_CMPU1(u32 crfd, u32 fra, u32 frb) { return XForm(4, crfd << 2, fra, frb, 64); }
+constexpr u32 PS_CMPO1(u32 crfd, u32 fra, u32 frb) { return XForm(4, crfd << 2, fra, frb, 96); }
+
+// Quantized loads and stores. w=true loads or stores ps0 only, gqr selects the GQR.
+
+constexpr u32 PSQ_L(u32 frd, s32 d, u32 ra, bool w, u32 gqr)
+{
+  return PSQForm(56, frd, ra, d, w, gqr);
+}
+constexpr u32 PSQ_LU(u32 frd, s32 d, u32 ra, bool w, u32 gqr)
+{
+  return PSQForm(57, frd, ra, d, w, gqr);
+}
+constexpr u32 PSQ_ST(u32 frs, s32 d, u32 ra, bool w, u32 gqr)
+{
+  return PSQForm(60, frs, ra, d, w, gqr);
+}
+constexpr u32 PSQ_STU(u32 frs, s32 d, u32 ra, bool w, u32 gqr)
+{
+  return PSQForm(61, frs, ra, d, w, gqr);
+}
+constexpr u32 PSQ_LX(u32 frd, u32 ra, u32 rb, bool w, u32 gqr)
+{
+  return PSQXForm(frd, ra, rb, w, gqr, 6);
+}
+constexpr u32 PSQ_LUX(u32 frd, u32 ra, u32 rb, bool w, u32 gqr)
+{
+  return PSQXForm(frd, ra, rb, w, gqr, 38);
+}
+constexpr u32 PSQ_STX(u32 frs, u32 ra, u32 rb, bool w, u32 gqr)
+{
+  return PSQXForm(frs, ra, rb, w, gqr, 7);
+}
+constexpr u32 PSQ_STUX(u32 frs, u32 ra, u32 rb, bool w, u32 gqr)
+{
+  return PSQXForm(frs, ra, rb, w, gqr, 39);
+}
+
+// Known encodings, as produced by binutils
+
+static_assert(BLR() == 0x4E800020);
+static_assert(NOP() == 0x60000000);
+static_assert(LI(3, 1) == 0x38600001);
+static_assert(LIS(10, -4096) == 0x3D40F000);
+static_assert(ADDI(4, 4, 8) == 0x38840008);
+static_assert(ADDIC(3, 4, -1, true) == 0x3464FFFF);
+static_assert(ADD(3, 4, 5) == 0x7C642A14);
+static_assert(ADD(3, 4, 5, true, true) == 0x7C642E15);
+static_assert(SUBFE(3, 4, 5, false, true) == 0x7C642911);
+static_assert(NEG(3, 4, false, true) == 0x7C6400D1);
+static_assert(DIVWU(3, 4, 5, true) == 0x7C642F96);
+static_assert(DIVWU(3, 4, 5) == 0x7C642B96);
+static_assert(MULHW(3, 4, 5, true) == 0x7C642897);
+static_assert(MR(8, 6) == 0x7CC83378);
+static_assert(AND(3, 4, 5, true) == 0x7C832839);
+static_assert(SRAWI(3, 3, 1) == 0x7C630E70);
+static_assert(SRAW(3, 4, 5, true) == 0x7C832E31);
+static_assert(CNTLZW(3, 4) == 0x7C830034);
+static_assert(EXTSH(3, 4) == 0x7C830734);
+static_assert(ANDI_RC(3, 4, 0xFF) == 0x708300FF);
+static_assert(RLWIMI(8, 5, 3, 4, 5, true) == 0x50A8190B);
+static_assert(RLWNM(8, 5, 7, 1, 2) == 0x5CA83844);
+static_assert(SLWI(3, 2, 2) == 0x5443103A);
+static_assert(SRWI(3, 4, 8) == 0x5483C23E);
+static_assert(CMPW(7, 3, 4) == 0x7F832000);
+static_assert(CMPLWI(1, 3, 10) == 0x2883000A);
+static_assert(LWZ(5, 0, 3) == 0x80A30000);
+static_assert(STWU(1, -16, 1) == 0x9421FFF0);
+static_assert(LHAUX(3, 4, 5) == 0x7C642AEE);
+static_assert(STWBRX(3, 4, 5) == 0x7C642D2C);
+static_assert(B(-8) == 0x4BFFFFF8);
+static_assert(BC(12, 2, 16) == 0x41820010);
+static_assert(BDNZ(-40) == 0x4200FFD8);
+static_assert(MFLR(0) == 0x7C0802A6);
+static_assert(MTXER(0) == 0x7C0103A6);
+static_assert(MTCTR(5) == 0x7CA903A6);
+static_assert(MFCTR(3) == 0x7C6902A6);
+static_assert(MFSPR(3, SPR_GQR0 + 2) == 0x7C72E2A6);
+static_assert(MFCR(9) == 0x7D200026);
+static_assert(MTCRF(0x80, 10) == 0x7D480120);
+static_assert(MCRXR(0) == 0x7C000400);
+static_assert(ISYNC() == 0x4C00012C);
+static_assert(SYNC() == 0x7C0004AC);
+static_assert(LFS(1, 4, 3) == 0xC0230004);
+static_assert(STFD(1, 8, 3) == 0xD8230008);
+static_assert(STFIWX(1, 3, 4) == 0x7C2327AE);
+static_assert(FADD(1, 1, 2) == 0xFC21102A);
+static_assert(FADDS(1, 2, 3, true) == 0xEC22182B);
+static_assert(FMUL(1, 2, 3) == 0xFC2200F2);
+static_assert(FMADDS(1, 2, 3, 4) == 0xEC2220FA);
+static_assert(FNMSUB(1, 2, 3, 4) == 0xFC2220FC);
+static_assert(FRES(1, 2) == 0xEC201030);
+static_assert(FRSQRTE(1, 2) == 0xFC201034);
+static_assert(FRSP(1, 2) == 0xFC201018);
+static_assert(FCTIWZ(1, 2) == 0xFC20101E);
+static_assert(FCMPO(0, 1, 2) == 0xFC011040);
+static_assert(MFFS(1) == 0xFC20048E);
+static_assert(MTFSF(0xFF, 1) == 0xFDFE0D8E);
+static_assert(MTFSFI(7, 0) == 0xFF80010C);
+static_assert(MTFSB1(31) == 0xFFE0004C);
+static_assert(PS_ADD(1, 1, 2) == 0x1021102A);
+static_assert(PS_MUL(1, 2, 3) == 0x102200F2);
+static_assert(PS_MADDS0(1, 2, 3, 4) == 0x102220DC);
+static_assert(PS_SUM1(1, 2, 3, 4) == 0x102220D6);
+static_assert(PS_MERGE01(1, 2, 3) == 0x10221C60);
+static_assert(PS_CMPO1(0, 1, 2) == 0x100110C0);
+static_assert(PSQ_L(1, 0, 3, false, 0) == 0xE0230000);
+static_assert(PSQ_ST(2, -8, 4, true, 5) == 0xF044DFF8);
+static_assert(PSQ_LX(1, 3, 4, false, 2) == 0x1023210C);
+}  // namespace Gekko
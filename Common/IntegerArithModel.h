@@ -0,0 +1,156 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Reference model of the XER and CR0 updates done by the integer arithmetic instructions, so
+// that generated kernels can be checked for every OE and Rc variant. It doesn't depend on
+// anything console-specific and also builds on the host.
+//
+// The results that the architecture leaves undefined (divw and divwu overflows) follow Dolphin's
+// interpreter: a negative dividend gives 0xFFFFFFFF for divw, anything else gives 0.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "Common/GekkoEncoder.h"
+
+constexpr u32 XER_SO = 0x80000000;
+constexpr u32 XER_OV = 0x40000000;
+constexpr u32 XER_CA = 0x20000000;
+
+// CR0 as a 4-bit field
+constexpr u32 CR0_LT = 0x8;
+constexpr u32 CR0_GT = 0x4;
+constexpr u32 CR0_EQ = 0x2;
+constexpr u32 CR0_SO = 0x1;
+
+struct IntegerArithInstruction
+{
+  const char* name;
+  // Extended opcode, the primary opcode is always 31
+  u32 xo;
+  bool uses_rb;
+  // mulhw and mulhwu have no overflow-enable form
+  bool has_oe;
+};
+
+constexpr IntegerArithInstruction INTEGER_ARITH_INSTRUCTIONS[] = {
+    {"addc", 10, true, true},    {"adde", 138, true, true},  {"addme", 234, false, true},
+    {"addze", 202, false, true}, {"subfc", 8, true, true},   {"subfe", 136, true, true},
+    {"neg", 104, false, true},   {"mullw", 235, true, true}, {"mulhw", 75, true, false},
+    {"divw", 491, true, true},   {"divwu", 459, true, true},
+};
+
+constexpr u32 EncodeIntegerArith(const IntegerArithInstruction& instruction, u32 rd, u32 ra,
+                                 u32 rb, bool oe, bool rc)
+{
+  return Gekko::XOForm(31, rd, ra, instruction.uses_rb ? rb : 0, oe, instruction.xo, rc);
+}
+
+struct IntegerArithResult
+{
+  u32 rd;
+  u32 xer;
+  // 4-bit field
+  u32 cr0;
+};
+
+// Executes one instruction. cr0 is the field before the instruction, which is kept if rc is
+// false.
+constexpr IntegerArithResult ExecuteIntegerArith(const IntegerArithInstruction& instruction,
+                                                 bool oe, bool rc, u32 a, u32 b, u32 xer,
+                                                 u32 cr0)
+{
+  const u32 carry_in = (xer & XER_CA) ? 1 : 0;
+  u32 x = a;
+  u32 y = b;
+  u32 z = 0;
+  bool is_add = true;
+  u32 result = 0;
+  bool overflow = false;
+
+  switch (instruction.xo)
+  {
+  case 10:  // addc
+    break;
+  case 138:  // adde
+    z = carry_in;
+    break;
+  case 234:  // addme
+    y = 0xFFFFFFFF;
+    z = carry_in;
+    break;
+  case 202:  // addze
+    y = 0;
+    z = carry_in;
+    break;
+  case 8:  // subfc
+    x = ~a;
+    z = 1;
+    break;
+  case 136:  // subfe
+    x = ~a;
+    z = carry_in;
+    break;
+  default:
+    // The others don't touch CA
+    is_add = false;
+    break;
+  }
+
+  if (is_add)
+  {
+    const u64 sum = static_cast<u64>(x) + y + z;
+    result = static_cast<u32>(sum);
+    overflow = (((x ^ result) & (y ^ result)) >> 31) != 0;
+    xer = (xer & ~XER_CA) | ((sum >> 32) ? XER_CA : 0);
+  }
+  else
+  {
+    const s32 sa = static_cast<s32>(a);
+    const s32 sb = static_cast<s32>(b);
+    const s64 product = static_cast<s64>(sa) * sb;
+    switch (instruction.xo)
+    {
+    case 104:  // neg
+      result = 0 - a;
+      overflow = a == 0x80000000;
+      break;
+    case 235:  // mullw
+      result = static_cast<u32>(product);
+      overflow = product != static_cast<s32>(product);
+      break;
+    case 75:  // mulhw
+      result = static_cast<u32>(static_cast<u64>(product) >> 32);
+      break;
+    case 491:  // divw
+      overflow = b == 0 || (a == 0x80000000 && b == 0xFFFFFFFF);
+      if (overflow)
+        result = sa < 0 ? 0xFFFFFFFF : 0;
+      else
+        result = static_cast<u32>(sa / sb);
+      break;
+    case 459:  // divwu
+      overflow = b == 0;
+      result = overflow ? 0 : a / b;
+      break;
+    }
+  }
+
+  if (oe)
+    xer = overflow ? (xer | XER_OV | XER_SO) : (xer & ~XER_OV);
+
+  if (rc)
+  {
+    const s32 signed_result = static_cast<s32>(result);
+    cr0 = signed_result < 0 ? CR0_LT : signed_result > 0 ? CR0_GT : CR0_EQ;
+    if (xer & XER_SO)
+      cr0 |= CR0_SO;
+  }
+
+  return {result, xer, cr0};
+}
+
+static_assert(ExecuteIntegerArith(INTEGER_ARITH_INSTRUCTIONS[0], true, true, 0x7FFFFFFF, 1, 0, 0)
+                  .xer == (XER_SO | XER_OV));
+static_assert(ExecuteIntegerArith(INTEGER_ARITH_INSTRUCTIONS[4], false, false, 1, 1, 0, 0).xer ==
+              XER_CA);
@@ -0,0 +1,127 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Reference model of the integer load and store instructions, working on a window of memory and
+// a copy of the GPRs, so that generated load/store kernels can be checked instruction by
+// instruction. It doesn't depend on anything console-specific and also builds on the host.
+//
+// The invalid forms follow Dolphin's interpreter: update forms with rA=0 use r0 like any other
+// register, and update loads with rA=rD write the loaded value first and the effective address
+// last, so rA ends up holding the address.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "Common/GekkoEncoder.h"
+
+struct LoadStoreInstruction
+{
+  const char* name;
+  // Primary opcode for the D-forms, extended opcode (with primary opcode 31) for the X-forms
+  u32 opcode;
+  bool indexed;
+  bool update;
+  bool store;
+  // Access size in bytes
+  u32 size;
+  bool sign_extend;
+  bool byte_reverse;
+};
+
+constexpr LoadStoreInstruction LOAD_STORE_INSTRUCTIONS[] = {
+    {"lwz", 32, false, false, false, 4, false, false},
+    {"lwzu", 33, false, true, false, 4, false, false},
+    {"lhz", 40, false, false, false, 2, false, false},
+    {"lhzu", 41, false, true, false, 2, false, false},
+    {"lha", 42, false, false, false, 2, true, false},
+    {"lhau", 43, false, true, false, 2, true, false},
+    {"lbz", 34, false, false, false, 1, false, false},
+    {"lbzu", 35, false, true, false, 1, false, false},
+    {"stw", 36, false, false, true, 4, false, false},
+    {"stwu", 37, false, true, true, 4, false, false},
+    {"sth", 44, false, false, true, 2, false, false},
+    {"sthu", 45, false, true, true, 2, false, false},
+    {"stb", 38, false, false, true, 1, false, false},
+    {"stbu", 39, false, true, true, 1, false, false},
+
+    {"lwzx", 23, true, false, false, 4, false, false},
+    {"lwzux", 55, true, true, false, 4, false, false},
+    {"lhzx", 279, true, false, false, 2, false, false},
+    {"lhzux", 311, true, true, false, 2, false, false},
+    {"lhax", 343, true, false, false, 2, true, false},
+    {"lhaux", 375, true, true, false, 2, true, false},
+    {"lbzx", 87, true, false, false, 1, false, false},
+    {"lbzux", 119, true, true, false, 1, false, false},
+    {"lwbrx", 534, true, false, false, 4, false, true},
+    {"lhbrx", 790, true, false, false, 2, false, true},
+    {"stwx", 151, true, false, true, 4, false, false},
+    {"stwux", 183, true, true, true, 4, false, false},
+    {"sthx", 407, true, false, true, 2, false, false},
+    {"sthux", 439, true, true, true, 2, false, false},
+    {"stbx", 215, true, false, true, 1, false, false},
+    {"stbux", 247, true, true, true, 1, false, false},
+    {"stwbrx", 662, true, false, true, 4, false, true},
+    {"sthbrx", 918, true, false, true, 2, false, true},
+};
+
+// Encodes the instruction. rd is rS for stores; d is the displacement for the D-forms and is
+// ignored for the X-forms, which use rb instead.
+constexpr u32 EncodeLoadStore(const LoadStoreInstruction& instruction, u32 rd, u32 ra, u32 rb,
+                              s32 d)
+{
+  if (instruction.indexed)
+    return Gekko::XForm(31, rd, ra, rb, instruction.opcode);
+  return Gekko::DForm(instruction.opcode, rd, ra, d);
+}
+
+// The state an instruction works on. memory holds the bytes at addresses
+// [memory_base, memory_base + memory_size).
+struct LoadStoreState
+{
+  u32 gpr[32];
+  u8* memory;
+  u32 memory_base;
+  u32 memory_size;
+};
+
+// Executes one instruction on the state. Returns false without changing anything if the access
+// falls outside the memory window.
+inline bool ExecuteLoadStore(const LoadStoreInstruction& instruction, u32 rd, u32 ra, u32 rb,
+                             s32 d, LoadStoreState& state)
+{
+  // rA=0 means zero rather than r0, except in the (invalid) update forms
+  const u32 base = (ra == 0 && !instruction.update) ? 0 : state.gpr[ra];
+  const u32 address = base + (instruction.indexed ? state.gpr[rb] : static_cast<u32>(d));
+
+  const u32 offset = address - state.memory_base;
+  if (address < state.memory_base || offset > state.memory_size - instruction.size)
+    return false;
+
+  u8* bytes = &state.memory[offset];
+  if (instruction.store)
+  {
+    const u32 value = state.gpr[rd];
+    for (u32 i = 0; i < instruction.size; ++i)
+    {
+      const u32 shift = 8 * (instruction.byte_reverse ? i : instruction.size - 1 - i);
+      bytes[i] = static_cast<u8>(value >> shift);
+    }
+  }
+  else
+  {
+    u32 value = 0;
+    for (u32 i = 0; i < instruction.size; ++i)
+    {
+      const u32 shift = 8 * (instruction.byte_reverse ? i : instruction.size - 1 - i);
+      value |= static_cast<u32>(bytes[i]) << shift;
+    }
+    if (instruction.sign_extend && instruction.size == 2)
+      value = static_cast<u32>(static_cast<s32>(static_cast<s16>(value)));
+    state.gpr[rd] = value;
+  }
+
+  if (instruction.update)
+    state.gpr[ra] = address;
+
+  return true;
+}
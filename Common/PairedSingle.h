@@ -0,0 +1,129 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Bit-exact model of the paired-single instructions, built on ExactFloat.h.
+//
+// Arithmetic slots are computed exactly and rounded once to single precision, with the
+// hardware's NaN propagation and frC truncation. Slots that are only moved follow the behavior
+// checked by pairedmove.cpp: ps0 is rounded like RoundMantissaBits does, ps1 is truncated.
+// Operands are named after the instruction fields, so ps_madd computes a * c + b.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "Common/ExactFloat.h"
+#include "Common/FloatUtils.h"
+
+// The contents of an FPR in paired-single mode, as double-precision bit patterns
+struct PairedSingle
+{
+  u64 ps0;
+  u64 ps1;
+
+  bool operator==(const PairedSingle& other) const
+  {
+    return ps0 == other.ps0 && ps1 == other.ps1;
+  }
+  bool operator!=(const PairedSingle& other) const { return !(*this == other); }
+};
+
+inline PairedSingle ps_add_expected(const PairedSingle& a, const PairedSingle& b, FPState& state)
+{
+  return {FloatAdd(a.ps0, b.ps0, FloatPrecision::Single, state),
+          FloatAdd(a.ps1, b.ps1, FloatPrecision::Single, state)};
+}
+
+inline PairedSingle ps_sub_expected(const PairedSingle& a, const PairedSingle& b, FPState& state)
+{
+  return {FloatSub(a.ps0, b.ps0, FloatPrecision::Single, state),
+          FloatSub(a.ps1, b.ps1, FloatPrecision::Single, state)};
+}
+
+inline PairedSingle ps_mul_expected(const PairedSingle& a, const PairedSingle& c, FPState& state)
+{
+  return {FloatMul(a.ps0, c.ps0, FloatPrecision::Single, state),
+          FloatMul(a.ps1, c.ps1, FloatPrecision::Single, state)};
+}
+
+inline PairedSingle ps_div_expected(const PairedSingle& a, const PairedSingle& b, FPState& state)
+{
+  return {FloatDiv(a.ps0, b.ps0, FloatPrecision::Single, state),
+          FloatDiv(a.ps1, b.ps1, FloatPrecision::Single, state)};
+}
+
+// Both slots are multiplied by c.ps0
+inline PairedSingle ps_muls0_expected(const PairedSingle& a, const PairedSingle& c, FPState& state)
+{
+  return {FloatMul(a.ps0, c.ps0, FloatPrecision::Single, state),
+          FloatMul(a.ps1, c.ps0, FloatPrecision::Single, state)};
+}
+
+// Both slots are multiplied by c.ps1
+inline PairedSingle ps_muls1_expected(const PairedSingle& a, const PairedSingle& c, FPState& state)
+{
+  return {FloatMul(a.ps0, c.ps1, FloatPrecision::Single, state),
+          FloatMul(a.ps1, c.ps1, FloatPrecision::Single, state)};
+}
+
+inline PairedSingle ps_madd_expected(const PairedSingle& a, const PairedSingle& c,
+                                     const PairedSingle& b, FPState& state)
+{
+  return {FloatMulAdd(a.ps0, c.ps0, b.ps0, false, false, FloatPrecision::Single, state),
+          FloatMulAdd(a.ps1, c.ps1, b.ps1, false, false, FloatPrecision::Single, state)};
+}
+
+// Both slots are multiplied by c.ps0
+inline PairedSingle ps_madds0_expected(const PairedSingle& a, const PairedSingle& c,
+                                       const PairedSingle& b, FPState& state)
+{
+  return {FloatMulAdd(a.ps0, c.ps0, b.ps0, false, false, FloatPrecision::Single, state),
+          FloatMulAdd(a.ps1, c.ps0, b.ps1, false, false, FloatPrecision::Single, state)};
+}
+
+// Both slots are multiplied by c.ps1
+inline PairedSingle ps_madds1_expected(const PairedSingle& a, const PairedSingle& c,
+                                       const PairedSingle& b, FPState& state)
+{
+  return {FloatMulAdd(a.ps0, c.ps1, b.ps0, false, false, FloatPrecision::Single, state),
+          FloatMulAdd(a.ps1, c.ps1, b.ps1, false, false, FloatPrecision::Single, state)};
+}
+
+// ps0 = a.ps0 + b.ps1, ps1 is moved from c.ps1
+inline PairedSingle ps_sum0_expected(const PairedSingle& a, const PairedSingle& c,
+                                     const PairedSingle& b, FPState& state)
+{
+  return {FloatAdd(a.ps0, b.ps1, FloatPrecision::Single, state), TruncateMantissaBits(c.ps1)};
+}
+
+// ps0 is moved from c.ps0, ps1 = a.ps0 + b.ps1. Unlike the other moves, the ps0 move rounds
+// infinities and NaNs like finite numbers.
+inline PairedSingle ps_sum1_expected(const PairedSingle& a, const PairedSingle& c,
+                                     const PairedSingle& b, FPState& state)
+{
+  return {RoundMantissaBitsAssumeFinite(c.ps0, state.rounding_mode),
+          FloatAdd(a.ps0, b.ps1, FloatPrecision::Single, state)};
+}
+
+inline PairedSingle ps_merge00_expected(const PairedSingle& a, const PairedSingle& b,
+                                        const FPState& state)
+{
+  return {RoundMantissaBits(a.ps0, state.rounding_mode), TruncateMantissaBits(b.ps0)};
+}
+
+inline PairedSingle ps_merge01_expected(const PairedSingle& a, const PairedSingle& b,
+                                        const FPState& state)
+{
+  return {RoundMantissaBits(a.ps0, state.rounding_mode), TruncateMantissaBits(b.ps1)};
+}
+
+inline PairedSingle ps_merge10_expected(const PairedSingle& a, const PairedSingle& b,
+                                        const FPState& state)
+{
+  return {RoundMantissaBits(a.ps1, state.rounding_mode), TruncateMantissaBits(b.ps0)};
+}
+
+inline PairedSingle ps_merge11_expected(const PairedSingle& a, const PairedSingle& b,
+                                        const FPState& state)
+{
+  return {RoundMantissaBits(a.ps1, state.rounding_mode), TruncateMantissaBits(b.ps1)};
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Runs floating-point and paired-single instructions over blocks of operands and checks the
+// results against a model, for the cputests that sweep FPSCR[NI] and FPSCR[RN]. Console only.
+
+#pragma once
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/ExactFloat.h"
+#include "Common/PairedSingle.h"
+#include "Common/hwtests.h"
+
+// Operands in the order of the instruction fields. ps1 is loaded through ps_merge00, so it always
+// holds a single-precision value, ps0 can hold any double.
+struct PSInputs
+{
+  PairedSingle a;
+  PairedSingle c;
+  PairedSingle b;
+};
+
+// The paired single that LOAD_PS loads for value: ps1 is loaded through ps_merge00, which
+// truncates
+inline PairedSingle Pair(u64 value)
+{
+  return {value, TruncateMantissaBits(value)};
+}
+
+// Loads a full double into ps0 while keeping the single in ps1
+#define LOAD_PS(reg, offset_ps0, offset_ps1)                                                       \
+  "lfd " reg ", " offset_ps1 "(%5)\n"                                                              \
+  "ps_merge00 " reg ", " reg ", " reg "\n"                                                         \
+  "isync\n"                                                                                        \
+  "lfd " reg ", " offset_ps0 "(%5)\n"                                                              \
+  "isync\n"
+
+// Defines a function that runs instruction once for each of count PSInputs. %0 is frD, %2 is frA,
+// %3 is frC and %4 is frB. ps1 of the result is moved to %1 right away, since the compiler only
+// moves ps0 when it copies registers.
+#define PS_KERNEL(name, instruction)                                                               \
+  static void name(const PSInputs* inputs, PairedSingle* results, u32 count)                       \
+  {                                                                                                \
+    for (u32 i = 0; i < count; ++i)                                                                \
+    {                                                                                              \
+      double ps0, ps1, a, c, b;                                                                    \
+      asm volatile(LOAD_PS("%2", "0", "8") LOAD_PS("%3", "16", "24") LOAD_PS("%4", "32", "40")     \
+                   instruction "\n"                                                                \
+                   "ps_merge11 %1, %0, %0\n"                                                       \
+                   : "=&f"(ps0), "=&f"(ps1), "=&f"(a), "=&f"(c), "=&f"(b)                          \
+                   : "b"(&inputs[i])                                                               \
+                   : "memory");                                                                    \
+      results[i] = {Common::BitCast<u64>(ps0), Common::BitCast<u64>(ps1)};                         \
+    }                                                                                              \
+  }
+
+struct PSOperation
+{
+  const char* name;
+  void (*run)(const PSInputs* inputs, PairedSingle* results, u32 count);
+  PairedSingle (*expected)(const PSInputs& in, FPState& state);
+  // Scalar instructions only have a defined result in ps0
+  bool scalar = false;
+};
+
+// Runs the operation on count inputs and checks the results against its model. FPSCR[NI] and
+// FPSCR[RN] must already be set to ni and rounding_mode.
+inline void CheckPSOperation(const PSOperation& operation, const PSInputs* inputs,
+                             PairedSingle* results, u32 count, u32 ni, u32 rounding_mode)
+{
+  operation.run(inputs, results, count);
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    const PSInputs& in = inputs[i];
+    FPState state;
+    state.rounding_mode = static_cast<RoundingMode>(rounding_mode);
+    state.ni = ni != 0;
+    PairedSingle expected = operation.expected(in, state);
+    PairedSingle result = results[i];
+    if (operation.scalar)
+      result.ps1 = expected.ps1 = 0;
+
+    DO_TEST(result == expected,
+            "{} (NI={}, RN={}) a={:016x}/{:016x} c={:016x}/{:016x} b={:016x}/{:016x}:\n"
+            "     got {:016x} {:016x}\n"
+            "expected {:016x} {:016x}",
+            operation.name, ni, rounding_mode, in.a.ps0, in.a.ps1, in.c.ps0, in.c.ps1, in.b.ps0,
+            in.b.ps1, result.ps0, result.ps1, expected.ps0, expected.ps1);
+  }
+}
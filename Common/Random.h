@@ -0,0 +1,131 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+
+// Seedable pseudo-random number generator for randomized tests (xoshiro256**). Unlike rand(), a
+// run can be reproduced from its seed, which the harness prints at START_TEST (see GetTestSeed).
+//
+// Sharded runs should give every shard its own stream: Random::ForStream(seed, n) is the
+// generator for seed advanced by n * 2^128 steps, so streams of the same seed never overlap.
+class Random
+{
+public:
+  explicit Random(u64 seed) { Seed(seed); }
+
+  static Random ForStream(u64 seed, u32 stream)
+  {
+    Random random(seed);
+    for (u32 i = 0; i < stream; ++i)
+      random.Jump();
+    return random;
+  }
+
+  // The state is expanded from the seed with splitmix64, which never yields an all-zero state.
+  void Seed(u64 seed)
+  {
+    for (u64& word : m_state)
+    {
+      seed += 0x9E3779B97F4A7C15ULL;
+      u64 z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  u64 Next64()
+  {
+    const u64 result = Common::RotateLeft(m_state[1] * 5, 7) * 9;
+    const u64 t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = Common::RotateLeft(m_state[3], 45);
+    return result;
+  }
+
+  u32 Next32() { return static_cast<u32>(Next64() >> 32); }
+
+  bool NextBool() { return (Next64() >> 63) != 0; }
+
+  // Uniform in [0, bound). bound must not be zero.
+  u32 NextBelow(u32 bound)
+  {
+    // Multiply-shift with rejection of the few values that would bias the result
+    const u32 threshold = static_cast<u32>(-bound) % bound;
+    while (true)
+    {
+      const u64 product = static_cast<u64>(Next32()) * bound;
+      if (static_cast<u32>(product) >= threshold)
+        return static_cast<u32>(product >> 32);
+    }
+  }
+
+  // Uniform in [min, max]
+  s32 NextInRange(s32 min, s32 max)
+  {
+    const u32 span = static_cast<u32>(max) - static_cast<u32>(min);
+    const u32 offset = span == 0xFFFFFFFF ? Next32() : NextBelow(span + 1);
+    return static_cast<s32>(static_cast<u32>(min) + offset);
+  }
+
+  void Fill(u64* out, size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+      out[i] = Next64();
+  }
+
+  void Fill(u32* out, size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+      out[i] = Next32();
+  }
+
+  void FillBytes(void* out, size_t size)
+  {
+    u8* bytes = static_cast<u8*>(out);
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+      const u64 value = Next64();
+      std::memcpy(bytes, &value, 8);
+    }
+    if (size != 0)
+    {
+      const u64 value = Next64();
+      std::memcpy(bytes, &value, size);
+    }
+  }
+
+  // Advances the generator by 2^128 steps
+  void Jump()
+  {
+    static constexpr u64 JUMP[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                   0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    u64 state[4] = {};
+    for (u64 jump : JUMP)
+    {
+      for (u32 bit = 0; bit < 64; ++bit)
+      {
+        if ((jump >> bit) & 1)
+        {
+          for (u32 i = 0; i < 4; ++i)
+            state[i] ^= m_state[i];
+        }
+        Next64();
+      }
+    }
+    std::memcpy(m_state, state, sizeof(m_state));
+  }
+
+private:
+  u64 m_state[4];
+};
@@ -0,0 +1,154 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/FloatUtils.h"
+
+// Table-driven equivalents of frsqrte_expected and fres_expected.
+//
+// Both estimates only depend on a handful of input bits: frsqrte uses the top 15 mantissa bits
+// plus the exponent parity, fres uses the top 15 bits of the single-precision mantissa. All the
+// base/dec interpolation is therefore done once when the tables are built, and a lookup is left
+// with the special-case checks and some exponent arithmetic.
+//
+// The results are bit-identical to the reference functions in FloatUtils.h
+// (tools/reciprocal_table_check checks this exhaustively), so these can be used to generate
+// expected values in bulk.
+class ReciprocalTables
+{
+public:
+  // Builds the tables using the reference implementations. This takes a moment on the console,
+  // so use Get() rather than constructing these repeatedly.
+  ReciprocalTables() : m_frsqrte(FRSQRTE_TABLE_SIZE), m_fres(FRES_TABLE_SIZE)
+  {
+    for (u32 i = 0; i < FRSQRTE_TABLE_SIZE; ++i)
+    {
+      // Index bit 15 is set for odd exponents; 1.0 has an even exponent, 2.0 an odd one.
+      const u64 exponent = (i & 0x8000) ? 0x4000000000000000ULL : 0x3FF0000000000000ULL;
+      const u64 input = exponent | (static_cast<u64>(i & 0x7FFF) << 37);
+      const u64 result = Common::BitCast<u64>(frsqrte_expected(Common::BitCast<double>(input)));
+      m_frsqrte[i] = static_cast<u32>((result & DOUBLE_FRAC) >> 26);
+    }
+
+    for (u32 i = 0; i < FRES_TABLE_SIZE; ++i)
+    {
+      const u64 input = 0x3FF0000000000000ULL | (static_cast<u64>(i) << 37);
+      const u64 result = Common::BitCast<u64>(fres_expected(Common::BitCast<double>(input), false));
+      m_fres[i] =
+          static_cast<u32>((result & DOUBLE_FRAC) >> (DOUBLE_FRAC_WIDTH - FLOAT_FRAC_WIDTH));
+    }
+  }
+
+  static const ReciprocalTables& Get()
+  {
+    static const ReciprocalTables tables;
+    return tables;
+  }
+
+  double frsqrte(double val) const
+  {
+    const u64 bits = Common::BitCast<u64>(val);
+    u64 mantissa = bits & DOUBLE_FRAC;
+    const u64 sign = bits & DOUBLE_SIGN;
+    s64 exponent = static_cast<s64>(bits & DOUBLE_EXP);
+
+    // Special case 0
+    if (mantissa == 0 && exponent == 0)
+      return sign ? -std::numeric_limits<double>::infinity() :
+                    std::numeric_limits<double>::infinity();
+    // Special case NaN-ish numbers
+    if (exponent == static_cast<s64>(DOUBLE_EXP))
+    {
+      if (mantissa == 0)
+      {
+        if (sign)
+          return std::numeric_limits<double>::quiet_NaN();
+        return 0.0;
+      }
+      return 0.0 + val;
+    }
+    // Negative numbers return NaN
+    if (sign)
+      return std::numeric_limits<double>::quiet_NaN();
+
+    if (!exponent)
+    {
+      // Normalize denormal values in one step instead of one bit at a time
+      const int shift = Common::CountLeadingZeros(mantissa) - 11;
+      mantissa = (mantissa << shift) & DOUBLE_FRAC;
+      exponent = static_cast<s64>(1 - shift) * (1LL << 52);
+    }
+
+    const bool odd_exponent = !(exponent & (1LL << 52));
+    exponent = ((0x3FFLL << 52) - ((exponent - (0x3FELL << 52)) / 2)) & (0x7FFLL << 52);
+
+    const u32 index = static_cast<u32>(mantissa >> 37) | (odd_exponent ? 0x8000 : 0);
+    return Common::BitCast<double>(static_cast<u64>(exponent) |
+                                   (static_cast<u64>(m_frsqrte[index]) << 26));
+  }
+
+  double fres(double val, bool ni) const
+  {
+    const u64 full_bits = Common::BitCast<u64>(val);
+    const u32 sign = static_cast<u32>(full_bits >> 32) & FLOAT_SIGN;
+
+    // Special case 0
+    if ((full_bits & DOUBLE_EXP) <= 0x37e0000000000000)
+    {
+      if ((full_bits & ~DOUBLE_SIGN) == 0)
+      {
+        return sign ? -std::numeric_limits<double>::infinity() :
+                      std::numeric_limits<double>::infinity();
+      }
+      else
+      {
+        return sign ? -FLT_MAX : FLT_MAX;
+      }
+    }
+
+    const u64 max_float = ni ? 0x47d0000000000000ULL : 0x4940000000000000ULL;
+
+    // Special case huge and NaN-ish numbers
+    if ((full_bits & DOUBLE_EXP) >= max_float)
+    {
+      if (val == val)
+        return sign ? -0.0 : 0.0;
+      return 0.0 + val;
+    }
+
+    const s32 exponent =
+        253 - static_cast<s32>(((full_bits & DOUBLE_EXP) >> DOUBLE_FRAC_WIDTH) - 0x380);
+    const u32 new_mantissa = m_fres[(full_bits & DOUBLE_FRAC) >> 37];
+
+    u32 result;
+    if (exponent <= 0)
+    {
+      // Result is subnormal; NI mode flushes it to 0
+      const u32 shift = 1 + static_cast<u32>(-exponent);
+      if (ni)
+        result = sign;
+      else
+        result = sign | (((1 << FLOAT_FRAC_WIDTH) | new_mantissa) >> shift);
+    }
+    else
+    {
+      result = sign | static_cast<u32>(exponent << FLOAT_FRAC_WIDTH) | new_mantissa;
+    }
+    return static_cast<double>(Common::BitCast<float>(result));
+  }
+
+private:
+  static constexpr u32 FRSQRTE_TABLE_SIZE = 1 << 16;
+  static constexpr u32 FRES_TABLE_SIZE = 1 << 15;
+
+  // Result mantissa bits 51..26, indexed by input mantissa bits 51..37 and the exponent parity
+  std::vector<u32> m_frsqrte;
+  // Single-precision result mantissa, indexed by input mantissa bits 51..37
+  std::vector<u32> m_fres;
+};
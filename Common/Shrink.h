@@ -0,0 +1,98 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+// Minimizes a failing case of a randomized test, so that the report shows which inputs matter
+// instead of a random tuple.
+//
+// A case is any copyable struct describing one run. A test provides shrink steps, each of which
+// moves one part of the case a bit closer to a canonical value (zero operands, no scaling, ...)
+// and returns false if that part is already canonical. Shrink keeps applying steps as long as
+// the simplified case still fails, so the result fails and no single step simplifies it further.
+
+template <typename Case>
+using ShrinkStep = bool (*)(Case& c);
+
+template <typename Case>
+struct ShrinkResult
+{
+  Case minimal;
+  // Number of times the test was rerun, including the rerun of the original case
+  u32 runs;
+  // False if the original case passed when it was rerun, i.e. the failure is flaky
+  bool reproduced;
+};
+
+// fails(const Case&) reruns the test for a case and returns true if it still fails. Gives up
+// after max_runs reruns and returns the smallest case found so far.
+template <typename Case, size_t NumSteps, typename Fails>
+ShrinkResult<Case> Shrink(const Case& failing, const ShrinkStep<Case> (&steps)[NumSteps],
+                          Fails&& fails, u32 max_runs = 1000)
+{
+  ShrinkResult<Case> result{failing, 1, fails(failing)};
+  if (!result.reproduced)
+    return result;
+
+  bool progress = true;
+  while (progress && result.runs < max_runs)
+  {
+    progress = false;
+    for (ShrinkStep<Case> step : steps)
+    {
+      Case candidate = result.minimal;
+      if (!step(candidate))
+        continue;
+
+      ++result.runs;
+      if (fails(candidate))
+      {
+        result.minimal = candidate;
+        progress = true;
+        break;
+      }
+      if (result.runs >= max_runs)
+        break;
+    }
+  }
+
+  return result;
+}
+
+// Helpers for writing shrink steps. They return false if value is already canonical.
+
+// Jumps straight to the canonical value
+template <typename T>
+bool ShrinkToValue(T& value, T canonical)
+{
+  if (value == canonical)
+    return false;
+  value = canonical;
+  return true;
+}
+
+// Halves the distance to the canonical value, for when jumping there makes the case pass
+template <typename T>
+bool ShrinkHalfway(T& value, T canonical)
+{
+  if (value == canonical)
+    return false;
+  const T distance = value > canonical ? value - canonical : canonical - value;
+  const T step = distance / 2 != 0 ? distance / 2 : distance;
+  value = value > canonical ? value - step : value + step;
+  return true;
+}
+
+// Moves one step closer, to pin down the exact boundary once halving no longer helps
+template <typename T>
+bool ShrinkByOne(T& value, T canonical)
+{
+  if (value == canonical)
+    return false;
+  value = value > canonical ? value - 1 : value + 1;
+  return true;
+}
@@ -1,4 +1,5 @@
 #include "Common/hwtests.h"
+#include "Common/timebase.h"
 
 struct TestStatus
 {
@@ -21,6 +22,12 @@ static long long number_of_subtests;
 static int number_of_tests_passed = 0;
 static long long number_of_subtests_passed;
 
+static u64 test_seed;
+static bool has_fixed_seed = false;
+
+static TestHook start_hook = nullptr;
+static TestHook end_hook = nullptr;
+
 int client_socket;
 int server_socket;
 
@@ -52,6 +59,32 @@ void privStartTest(const char* file, int line)
   status = TestStatus(file, line);
 
   number_of_tests++;
+
+  // A seed from SetTestSeed only applies to the test that starts next
+  if (!has_fixed_seed)
+    test_seed = GetTimebase() * 0x9E3779B97F4A7C15ULL + number_of_tests;
+  has_fixed_seed = false;
+  network_printf("Test %d seed: 0x%016llx\n", number_of_tests, test_seed);
+
+  if (start_hook)
+    start_hook(file, number_of_tests);
+}
+
+u64 GetTestSeed()
+{
+  return test_seed;
+}
+
+void SetTestSeed(u64 seed)
+{
+  test_seed = seed;
+  has_fixed_seed = true;
+}
+
+void SetTestHooks(TestHook on_start, TestHook on_end)
+{
+  start_hook = on_start;
+  end_hook = on_end;
 }
 
 void privTestPassed()
@@ -69,6 +102,9 @@ void privTestFailed(const char* file, int line, const std::string& fail_msg)
 
 void privEndTest()
 {
+  if (end_hook)
+    end_hook(status.file, number_of_tests);
+
   if (0 == status.num_failures)
   {
     network_printf("Test %d passed (%lld subtests)\n", number_of_tests, status.num_subtests);
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <fmt/format.h>
 
+#include "Common/CommonTypes.h"
 #include "Common/FormatUtil.h"
 
 #define SERVER_PORT 16784
@@ -19,6 +20,17 @@
                                                           FMT_STRING(fail_msg), ##__VA_ARGS__)
 #define END_TEST() privEndTest()
 
+// Seed for the randomized parts of the current test, printed by START_TEST. By default every test
+// gets a new seed; call SetTestSeed before START_TEST to rerun with the seed of a failed run. The
+// seed only applies to the next test, later ones get new seeds again.
+u64 GetTestSeed();
+void SetTestSeed(u64 seed);
+
+// Called by START_TEST after the test's number was assigned and by END_TEST before the result is
+// reported, e.g. to record what each test does. Either may be null.
+typedef void (*TestHook)(const char* file, int test_number);
+void SetTestHooks(TestHook on_start, TestHook on_end);
+
 // private testing functions. Don't use these, but use the above macros, instead.
 void privStartTest(const char* file, int line);
 void privTestPassed();
@@ -4,102 +4,82 @@
 #include <wiiuse/wpad.h>
 
 #include "Common/BitUtils.h"
+#include "Common/ExpectedStream.h"
+#include "Common/FctiwBoundaries.h"
 #include "Common/FloatUtils.h"
 #include "Common/hwtests.h"
 
-// Algorithm adapted from Appendix C.4.2 in PowerPC Microprocessor Family:
-// The Programming Environments Manual for 32 and 64-bit Microprocessors
-static u64 fctiw_expected(double b, RoundingMode rounding_mode)
-{
-  const u64 upper_bits = 0xfff8000000000000ull;
-  if (std::isnan(b))
-    return upper_bits | 0x80000000;
+// Receive the expected results for the large number ranges from tools/expected_stream instead of
+// computing them on the console. Requires the tool to be connected instead of netcat.
+#define USE_EXPECTED_STREAM false
 
-  const u64 bi = Common::BitCast<u64>(b);
+static void FctiwTestExpected(u32 i, u64 expected)
+{
+  float input = Common::BitCast<float>(i);
+  u64 result = 0;
+  asm("fctiw %0, %1" : "=f"(result) : "f"(input));
 
-  s32 sign = static_cast<s32>((bi & DOUBLE_SIGN) >> 63);
-  s32 exp = static_cast<s32>((bi & DOUBLE_EXP) >> 52);
-  u64 frac = ((bi & DOUBLE_FRAC) << 11);
+  DO_TEST(result == expected, "fctiw 0x{:08x} ({}):\n"
+                              "     got 0x%{:16x} ({})\n"
+                              "expected 0x%{:16x} ({})",
+          i, input, result, static_cast<s32>(result), expected, static_cast<s32>(expected));
+}
 
-  if (exp > 0)
-    frac |= 1ull << 63;
+static void FctiwTestIndividual(u32 i, RoundingMode rounding_mode)
+{
+  FctiwTestExpected(i, fctiw_expected(Common::BitCast<float>(i), rounding_mode));
+}
 
-  if (exp > 0)
-    exp -= 1023;
-  else
-    exp = -1022;
+static void FctiwTestBothSigns(u32 i, RoundingMode rounding_mode)
+{
+  FctiwTestIndividual(i, rounding_mode);
+  FctiwTestIndividual(FLOAT_SIGN | i, rounding_mode);
+}
 
-  bool gbit = false;
-  bool rbit = false;
-  bool xbit = false;
-  for (s64 i = 0; i < 63 - exp; ++i)
-  {
-    xbit |= rbit;
-    rbit = gbit;
-    gbit = frac & 1;
-    frac >>= 1;
-  }
+// Tests count consecutive bit patterns starting at first. Returns false if aborted.
+static bool FctiwTestStreamed(u32 first, u32 count, RoundingMode rounding_mode,
+                              u32 progress_interval)
+{
+  ExpectedStream stream(ExpectedKind::Fctiw, static_cast<u32>(rounding_mode), first, count);
 
-  u32 inc = 0;
-  switch (rounding_mode)
+  u32 i = first;
+  const u64* expected;
+  while (const u32 size = stream.Next(&expected))
   {
-  case RoundingMode::Nearest:
-    if (gbit && ((frac & 1) || rbit || xbit))
-      inc = 1;
-    break;
-  case RoundingMode::TowardsZero:
-    // Nothing
-    break;
-  case RoundingMode::TowardsPositiveInfinity:
-    if (!sign && (gbit || rbit || xbit))
-      inc = 1;
-    break;
-  case RoundingMode::TowardsNegativeInfinity:
-    if (sign && (gbit || rbit || xbit))
-      inc = 1;
-    break;
-  }
+    for (u32 j = 0; j < size; ++j, ++i)
+      FctiwTestExpected(i, expected[j]);
 
-  frac += inc;
+    if ((i - first) % progress_interval < size)
+    {
+      network_printf("Progress 0x%08x: %u/%u\n", first, i - first, count);
 
-  if (!sign && frac > 0x7fffffff)
-  {
-    // Positive large operand or +inf
-    frac = 0x7fffffff;
-  }
-  else if (frac > 0x80000000)
-  {
-    // Negative large operand or -inf
-    frac = 0x80000000;
-  }
-  else if (sign)
-  {
-    // Appendix C.4.2 does not cast to 32-bit here, but doing so matches
-    // Broadway's behavior of setting bit 31 to 1 for negative zeroes.
-    // Bits 0-31 are undefined according to appendix C.4.2.
-    frac = static_cast<u64>(~static_cast<u32>(frac)) + 1;
+      WPAD_ScanPads();
+      if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+        return false;
+    }
   }
 
-  return upper_bits | frac;
+  DO_TEST(stream.Complete(), "Expected stream for 0x{:08x} ended early at 0x{:08x}", first, i);
+  return stream.Complete();
 }
 
-static void FctiwTestIndividual(u32 i, RoundingMode rounding_mode)
+static void RunFctiw(const u64* inputs, u64* results, u32 count)
 {
-  float input = Common::BitCast<float>(i);
-  u64 expected = fctiw_expected(input, rounding_mode);
-  u64 result = 0;
-  asm("fctiw %0, %1" : "=f"(result) : "f"(input));
-
-  DO_TEST(result == expected, "fctiw 0x{:08x} ({}):\n"
-                              "     got 0x%{:16x} ({})\n"
-                              "expected 0x%{:16x} ({})",
-          i, input, result, static_cast<s32>(result), expected, static_cast<s32>(expected));
+  for (u32 i = 0; i < count; ++i)
+  {
+    double result;
+    asm volatile("fctiw %0, %1" : "=f"(result) : "f"(Common::BitCast<double>(inputs[i])));
+    results[i] = Common::BitCast<u64>(result);
+  }
 }
 
-static void FctiwTestBothSigns(u32 i, RoundingMode rounding_mode)
+// Double inputs on and around the rounding boundaries, including the low mantissa bits that the
+// float inputs of FctiwTest never set
+static void FctiwBoundaryTest()
 {
-  FctiwTestIndividual(i, rounding_mode);
-  FctiwTestIndividual(FLOAT_SIGN | i, rounding_mode);
+  START_TEST();
+  FctiwTestAllBoundaries("fctiw", RunFctiw, fctiw_expected);
+  END_TEST();
 }
 
 // Float Convert To Integer Word
@@ -148,6 +128,19 @@ static void FctiwTest()
       }
     }
 
+    if (USE_EXPECTED_STREAM)
+    {
+      for (u32 sign : {0u, FLOAT_SIGN})
+      {
+        if (!FctiwTestStreamed(sign | large_numbers_start, large_numbers_end - large_numbers_start,
+                               static_cast<RoundingMode>(rounding_mode), progress_interval))
+        {
+          goto end;
+        }
+      }
+      continue;
+    }
+
     for (u32 i = large_numbers_start; i < large_numbers_end; ++i)
     {
       FctiwTestBothSigns(i, static_cast<RoundingMode>(rounding_mode));
@@ -174,6 +167,7 @@ int main()
   network_init();
   WPAD_Init();
 
+  FctiwBoundaryTest();
   FctiwTest();
 
   network_printf("Shutting down...\n");
@@ -1,5 +1,8 @@
 #include <gctypes.h>
 #include <wiiuse/wpad.h>
+#include "Common/BitUtils.h"
+#include "Common/FctiwBoundaries.h"
+#include "Common/FloatUtils.h"
 #include "Common/hwtests.h"
 
 // Float Convert To Integer Word with round-to-Zero
@@ -35,12 +38,34 @@ static void FctiwzTest()
   END_TEST();
 }
 
+static void RunFctiwz(const u64* inputs, u64* results, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    double result;
+    asm volatile("fctiwz %0, %1" : "=f"(result) : "f"(Common::BitCast<double>(inputs[i])));
+    results[i] = Common::BitCast<u64>(result);
+  }
+}
+
+// Double inputs on and around the rounding boundaries, under every FPSCR[RN] setting. fctiwz
+// ignores FPSCR[RN], so the result must always match rounding towards zero.
+static void FctiwzBoundaryTest()
+{
+  START_TEST();
+  FctiwTestAllBoundaries("fctiwz", RunFctiwz, [](double input, RoundingMode) {
+    return fctiw_expected(input, RoundingMode::TowardsZero);
+  });
+  END_TEST();
+}
+
 int main()
 {
   network_init();
   WPAD_Init();
 
   FctiwzTest();
+  FctiwzBoundaryTest();
 
   network_printf("Shutting down...\n");
   network_shutdown();
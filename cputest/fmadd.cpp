@@ -0,0 +1,107 @@
+#include <gctypes.h>
+#include <wiiuse/wpad.h>
+
+#include "Common/ExactFloat.h"
+#include "Common/FloatUtils.h"
+#include "Common/FmaInputs.h"
+#include "Common/PairedSingleKernel.h"
+#include "Common/Random.h"
+#include "Common/hwtests.h"
+
+// Compares the rounding of the fused multiply-add instructions against the exact model in
+// Common/ExactFloat.h, in all rounding modes, with and without NI. The operands come from
+// Common/FmaInputs.h and land on or right next to a rounding boundary of the target precision.
+
+constexpr u32 BLOCK_SIZE = 4096;
+constexpr u32 NUM_BLOCKS = 64;
+
+static Random s_random(0);
+
+PS_KERNEL(RunFmadd, "fmadd %0, %2, %3, %4")
+PS_KERNEL(RunFmsub, "fmsub %0, %2, %3, %4")
+PS_KERNEL(RunFnmadd, "fnmadd %0, %2, %3, %4")
+PS_KERNEL(RunFnmsub, "fnmsub %0, %2, %3, %4")
+PS_KERNEL(RunFmadds, "fmadds %0, %2, %3, %4")
+PS_KERNEL(RunFmsubs, "fmsubs %0, %2, %3, %4")
+PS_KERNEL(RunFnmadds, "fnmadds %0, %2, %3, %4")
+PS_KERNEL(RunFnmsubs, "fnmsubs %0, %2, %3, %4")
+
+template <bool negate_b, bool negate_result, FloatPrecision precision>
+static PairedSingle FMAExpected(const PSInputs& in, FPState& state)
+{
+  return {FloatMulAdd(in.a.ps0, in.c.ps0, in.b.ps0, negate_b, negate_result, precision, state),
+          0};
+}
+
+static const PSOperation OPERATIONS[] = {
+    {"fmadd", RunFmadd, FMAExpected<false, false, FloatPrecision::Double>, true},
+    {"fmsub", RunFmsub, FMAExpected<true, false, FloatPrecision::Double>, true},
+    {"fnmadd", RunFnmadd, FMAExpected<false, true, FloatPrecision::Double>, true},
+    {"fnmsub", RunFnmsub, FMAExpected<true, true, FloatPrecision::Double>, true},
+    {"fmadds", RunFmadds, FMAExpected<false, false, FloatPrecision::Single>, true},
+    {"fmsubs", RunFmsubs, FMAExpected<true, false, FloatPrecision::Single>, true},
+    {"fnmadds", RunFnmadds, FMAExpected<false, true, FloatPrecision::Single>, true},
+    {"fnmsubs", RunFnmsubs, FMAExpected<true, true, FloatPrecision::Single>, true},
+};
+
+static const u64 DEFAULT_FPSCR = 0;
+
+static PSInputs s_inputs[BLOCK_SIZE];
+static PairedSingle s_results[BLOCK_SIZE];
+
+static void FusedMultiplyAddTest()
+{
+  START_TEST();
+  s_random.Seed(GetTestSeed());
+
+  for (u32 ni = 0; ni < 2; ++ni)
+  {
+    for (u32 rounding_mode = 0; rounding_mode < 4; ++rounding_mode)
+    {
+      // Set FPSCR[NI] and FPSCR[RN] (and FPSCR[XE] but that's okay).
+      const u64 mtfsf_input = (ni << 2) | rounding_mode;
+      asm volatile("mtfsf 7, %0" ::"f"(mtfsf_input));
+
+      for (u32 block = 0; block < NUM_BLOCKS; ++block)
+      {
+        // Half of the inputs aim at double-precision boundaries, half at single-precision ones
+        for (u32 i = 0; i < BLOCK_SIZE; ++i)
+        {
+          const FloatPrecision target = i % 2 ? FloatPrecision::Single : FloatPrecision::Double;
+          const FMAInputs in = GenerateFMAInputs(s_random, target);
+          s_inputs[i] = {Pair(in.a), Pair(in.c), Pair(in.b)};
+        }
+
+        for (const PSOperation& operation : OPERATIONS)
+          CheckPSOperation(operation, s_inputs, s_results, BLOCK_SIZE, ni, rounding_mode);
+
+        network_printf("Progress NI=%u RN=%u: %u/%u\n", ni, rounding_mode,
+                       (block + 1) * BLOCK_SIZE, NUM_BLOCKS * BLOCK_SIZE);
+        WPAD_ScanPads();
+        if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+        {
+          asm volatile("mtfsf 7, %0" ::"f"(DEFAULT_FPSCR));
+          END_TEST();
+          return;
+        }
+      }
+    }
+  }
+
+  asm volatile("mtfsf 7, %0" ::"f"(DEFAULT_FPSCR));
+
+  END_TEST();
+}
+
+int main()
+{
+  network_init();
+  WPAD_Init();
+
+  FusedMultiplyAddTest();
+
+  network_printf("Shutting down...\n");
+  network_shutdown();
+
+  return 0;
+}
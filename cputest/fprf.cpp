@@ -2,8 +2,15 @@
 #include <limits>
 #include <wiiuse/wpad.h>
 #include "Common/BitUtils.h"
+#include "Common/ExpectedStream.h"
+#include "Common/FloatUtils.h"
+#include "Common/FprfSweep.h"
 #include "Common/hwtests.h"
 
+// Receive the expected results for the exhaustive sweep from tools/expected_stream instead of
+// computing them on the console. Requires the tool to be connected instead of netcat.
+#define USE_EXPECTED_STREAM false
+
 template <typename T>
 struct TestInstance
 {
@@ -168,6 +175,134 @@ static void FprfSingleTest()
   END_TEST();
 }
 
+// Inputs per block of the exhaustive sweep. The entries are laid out like the expected stream's:
+// the result and FPSCR of fadds x, -0.0 followed by those of fmuls x, x.
+constexpr u32 SWEEP_BLOCK_SIZE = EXPECTED_STREAM_BLOCK_ENTRIES / 4;
+static u64 s_sweep_results[SWEEP_BLOCK_SIZE * 4];
+static u64 s_sweep_expected[SWEEP_BLOCK_SIZE * 4];
+
+// Runs the sweep's instructions for count consecutive float bit patterns, each starting from a
+// cleared FPSCR with the given rounding mode.
+static void RunSweepBlock(u32 first, u32 count, RoundingMode rounding_mode)
+{
+  const u64 initial_fpscr = static_cast<u64>(rounding_mode);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 input = first + i;
+    double value, sum, product, add_fpscr, mul_fpscr;
+    asm volatile("lfs %0, 0(%5)\n"
+                 "mtfsf 0xFF, %6\n"
+                 "fadds %1, %0, %7\n"
+                 "mffs %3\n"
+                 "mtfsf 0xFF, %6\n"
+                 "fmuls %2, %0, %0\n"
+                 "mffs %4\n"
+                 : "=&f"(value), "=&f"(sum), "=&f"(product), "=&f"(add_fpscr), "=&f"(mul_fpscr)
+                 : "b"(&input), "f"(initial_fpscr), "f"(-0.0)
+                 : "memory");
+
+    u64* results = &s_sweep_results[4 * i];
+    results[0] = Common::BitCast<u64>(sum);
+    results[1] = static_cast<u32>(Common::BitCast<u64>(add_fpscr));
+    results[2] = Common::BitCast<u64>(product);
+    results[3] = static_cast<u32>(Common::BitCast<u64>(mul_fpscr));
+  }
+}
+
+static void CheckSweepBlock(u32 first, u32 count, RoundingMode rounding_mode, const u64* expected)
+{
+  const u32 rn = static_cast<u32>(rounding_mode);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u64* results = &s_sweep_results[4 * i];
+    const u64* expected_results = &expected[4 * i];
+
+    DO_TEST(results[0] == expected_results[0] && results[1] == expected_results[1],
+            "fadds 0x{:08x}, -0.0 (RN={}):\n"
+            "     got 0x{:016x} FPSCR 0x{:08x}\n"
+            "expected 0x{:016x} FPSCR 0x{:08x}",
+            first + i, rn, results[0], results[1], expected_results[0], expected_results[1]);
+
+    DO_TEST(results[2] == expected_results[2] && results[3] == expected_results[3],
+            "fmuls 0x{:08x}, 0x{:08x} (RN={}):\n"
+            "     got 0x{:016x} FPSCR 0x{:08x}\n"
+            "expected 0x{:016x} FPSCR 0x{:08x}",
+            first + i, first + i, rn, results[2], results[3], expected_results[2],
+            expected_results[3]);
+  }
+}
+
+// Checks the FPSCR after fadds and fmuls for every float bit pattern in one rounding mode.
+// Returns false if aborted.
+static bool FprfSweep(RoundingMode rounding_mode)
+{
+  const u32 rn = static_cast<u32>(rounding_mode);
+  const u64 num_inputs = 1ULL << 32;
+  const u32 progress_interval = 1 << 24;
+
+  if (USE_EXPECTED_STREAM)
+  {
+    ExpectedStream stream(ExpectedKind::Fprf, rn, 0, num_inputs);
+
+    u64 first = 0;
+    const u64* expected;
+    while (const u32 size = stream.Next(&expected))
+    {
+      const u32 count = size / 4;
+      RunSweepBlock(static_cast<u32>(first), count, rounding_mode);
+      CheckSweepBlock(static_cast<u32>(first), count, rounding_mode, expected);
+      first += count;
+
+      if (first % progress_interval < count)
+      {
+        network_printf("Progress RN=%u: %llu/%llu\n", rn, first, num_inputs);
+
+        WPAD_ScanPads();
+        if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+          return false;
+      }
+    }
+
+    DO_TEST(stream.Complete(), "Expected stream for RN={} ended early at 0x{:08x}", rn, first);
+    return stream.Complete();
+  }
+
+  for (u64 first = 0; first < num_inputs; first += SWEEP_BLOCK_SIZE)
+  {
+    RunSweepBlock(static_cast<u32>(first), SWEEP_BLOCK_SIZE, rounding_mode);
+    ComputeFprfSweepBlock(static_cast<u32>(first), SWEEP_BLOCK_SIZE, rounding_mode,
+                          s_sweep_expected);
+    CheckSweepBlock(static_cast<u32>(first), SWEEP_BLOCK_SIZE, rounding_mode, s_sweep_expected);
+
+    if ((first + SWEEP_BLOCK_SIZE) % progress_interval == 0)
+    {
+      network_printf("Progress RN=%u: %llu/%llu\n", rn, first + SWEEP_BLOCK_SIZE, num_inputs);
+
+      WPAD_ScanPads();
+      if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+        return false;
+    }
+  }
+  return true;
+}
+
+// Checks the FPSCR after fadds and fmuls for every float bit pattern against the model in
+// Common/ExactFloat.h, covering FPRF, FR, FI and the exception and summary bits. Overflow,
+// underflow and inexact results depend on the rounding mode, so all four are swept.
+static void FprfSweepTest()
+{
+  START_TEST();
+
+  for (u32 rn = 0; rn < 4; ++rn)
+  {
+    if (!FprfSweep(static_cast<RoundingMode>(rn)))
+      break;
+  }
+
+  asm("mtfsfi 7, 0");
+  END_TEST();
+}
+
 int main()
 {
   network_init();
@@ -175,6 +310,7 @@ int main()
 
   FprfDoubleTest();
   FprfSingleTest();
+  FprfSweepTest();
 
   network_printf("Shutting down...\n");
   network_shutdown();
@@ -0,0 +1,236 @@
+#include <gctypes.h>
+#include <iterator>
+#include <wiiuse/wpad.h>
+
+#include "Common/CodeBuffer.h"
+#include "Common/GekkoEncoder.h"
+#include "Common/IntegerArithModel.h"
+#include "Common/Random.h"
+#include "Common/hwtests.h"
+
+// Compares the results and the CA, OV, SO and CR0 updates of the integer arithmetic instructions
+// against the model in Common/IntegerArithModel.h, for every OE and Rc variant. The inputs are
+// all pairs of edge values with every combination of the XER flags, followed by random blocks.
+//
+// All variants are generated into one kernel that runs over a whole block of inputs, and the
+// block is then compared in a single pass.
+
+constexpr u32 BLOCK_SIZE = 2048;
+constexpr u32 NUM_RANDOM_BLOCKS = 512;
+
+// CR0 before each instruction, a combination no record form can produce
+constexpr u32 CR0_SENTINEL = CR0_LT | CR0_EQ;
+
+struct IntegerInputs
+{
+  u32 a;
+  u32 b;
+  u32 xer;
+};
+
+struct IntegerOutputs
+{
+  u32 rd;
+  u32 xer;
+  u32 cr;
+};
+
+struct IntegerVariant
+{
+  const IntegerArithInstruction* instruction;
+  bool oe;
+  bool rc;
+};
+
+static const u32 EDGE_VALUES[] = {
+    0x00000000, 0x00000001, 0x00000002, 0x0000FFFF, 0x00010000, 0x55555555,
+    0x7FFFFFFE, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xAAAAAAAA, 0xFFFF0000,
+    0xFFFF8000, 0xFFFFFFFE, 0xFFFFFFFF, 0x0000B505,
+};
+
+static const u32 XER_FLAG_COMBINATIONS[] = {
+    0, XER_CA, XER_OV, XER_OV | XER_CA, XER_SO, XER_SO | XER_CA, XER_SO | XER_OV,
+    XER_SO | XER_OV | XER_CA,
+};
+
+static_assert(std::size(EDGE_VALUES) * std::size(EDGE_VALUES) * std::size(XER_FLAG_COMBINATIONS) ==
+              BLOCK_SIZE);
+
+// Registers used by the kernel. r3 points to the inputs, r4 to the outputs and r5 holds the
+// number of inputs.
+constexpr u32 KERNEL_A = 6;
+constexpr u32 KERNEL_B = 7;
+constexpr u32 KERNEL_XER = 8;
+constexpr u32 KERNEL_RD = 9;
+constexpr u32 KERNEL_CR = 10;
+constexpr u32 KERNEL_CR0_SOURCE = 11;
+constexpr u32 KERNEL_INPUTS = 12;
+
+constexpr u32 KERNEL_WORDS_PER_VARIANT = 16;
+
+static IntegerVariant s_variants[2 * 2 * std::size(INTEGER_ARITH_INSTRUCTIONS)];
+static u32 s_num_variants = 0;
+
+static IntegerInputs s_inputs[BLOCK_SIZE];
+static IntegerOutputs s_outputs[std::size(s_variants)][BLOCK_SIZE];
+
+static void BuildVariants()
+{
+  s_num_variants = 0;
+  for (const IntegerArithInstruction& instruction : INTEGER_ARITH_INSTRUCTIONS)
+  {
+    for (bool oe : {false, true})
+    {
+      if (oe && !instruction.has_oe)
+        continue;
+      for (bool rc : {false, true})
+        s_variants[s_num_variants++] = {&instruction, oe, rc};
+    }
+  }
+}
+
+// Emits a function that runs every variant over the inputs, writing the outputs of each variant
+// after the ones of the previous variant
+static void EmitKernel(CodeBuffer& code)
+{
+  using namespace Gekko;
+
+  code.Reset();
+  code.Emit(MR(KERNEL_INPUTS, 3));
+  code.Emit(LIS(KERNEL_CR0_SOURCE, static_cast<s32>(CR0_SENTINEL << 12)));
+
+  for (u32 i = 0; i < s_num_variants; ++i)
+  {
+    const IntegerVariant& variant = s_variants[i];
+    code.Emit(MR(3, KERNEL_INPUTS));
+    code.Emit(MTCTR(5));
+
+    // Loop body
+    code.Emit(LWZ(KERNEL_A, 0, 3));
+    code.Emit(LWZ(KERNEL_B, 4, 3));
+    code.Emit(LWZ(KERNEL_XER, 8, 3));
+    code.Emit(MTXER(KERNEL_XER));
+    code.Emit(MTCRF(0x80, KERNEL_CR0_SOURCE));
+    code.Emit(EncodeIntegerArith(*variant.instruction, KERNEL_RD, KERNEL_A, KERNEL_B, variant.oe,
+                                 variant.rc));
+    code.Emit(MFXER(KERNEL_XER));
+    code.Emit(MFCR(KERNEL_CR));
+    code.Emit(STW(KERNEL_RD, 0, 4));
+    code.Emit(STW(KERNEL_XER, 4, 4));
+    code.Emit(STW(KERNEL_CR, 8, 4));
+    code.Emit(ADDI(3, 3, sizeof(IntegerInputs)));
+    code.Emit(ADDI(4, 4, sizeof(IntegerOutputs)));
+    code.Emit(BDNZ(-13 * 4));
+  }
+
+  code.Emit(BLR());
+  code.Flush();
+}
+
+static void GenerateEdgeInputs()
+{
+  u32 count = 0;
+  for (u32 a : EDGE_VALUES)
+  {
+    for (u32 b : EDGE_VALUES)
+    {
+      for (u32 xer : XER_FLAG_COMBINATIONS)
+        s_inputs[count++] = {a, b, xer};
+    }
+  }
+}
+
+static u32 RandomOperand(Random& random)
+{
+  switch (random.NextBelow(4))
+  {
+  case 0:
+    return EDGE_VALUES[random.NextBelow(std::size(EDGE_VALUES))];
+  case 1:
+    // Close to an edge value, where carries and overflows change
+    return EDGE_VALUES[random.NextBelow(std::size(EDGE_VALUES))] +
+           static_cast<u32>(random.NextInRange(-16, 16));
+  default:
+    return random.Next32();
+  }
+}
+
+static void GenerateRandomInputs(Random& random)
+{
+  for (IntegerInputs& inputs : s_inputs)
+  {
+    inputs.a = RandomOperand(random);
+    inputs.b = RandomOperand(random);
+    inputs.xer = XER_FLAG_COMBINATIONS[random.NextBelow(std::size(XER_FLAG_COMBINATIONS))];
+  }
+}
+
+static void CheckBlock()
+{
+  for (u32 i = 0; i < BLOCK_SIZE; ++i)
+  {
+    const IntegerInputs& in = s_inputs[i];
+    for (u32 j = 0; j < s_num_variants; ++j)
+    {
+      const IntegerVariant& variant = s_variants[j];
+      const IntegerOutputs& out = s_outputs[j][i];
+      const IntegerArithResult expected = ExecuteIntegerArith(
+          *variant.instruction, variant.oe, variant.rc, in.a, in.b, in.xer, CR0_SENTINEL);
+      const u32 cr0 = out.cr >> 28;
+
+      DO_TEST(out.rd == expected.rd && out.xer == expected.xer && cr0 == expected.cr0,
+              "{}{}{} a={:08x} b={:08x} xer={:08x}:\n"
+              "     got {:08x} xer={:08x} cr0={:x}\n"
+              "expected {:08x} xer={:08x} cr0={:x}",
+              variant.instruction->name, variant.oe ? "o" : "", variant.rc ? "." : "", in.a,
+              in.b, in.xer, out.rd, out.xer, cr0, expected.rd, expected.xer, expected.cr0);
+    }
+  }
+}
+
+static void IntegerFlagsTest()
+{
+  START_TEST();
+
+  BuildVariants();
+  CodeBuffer code(2 + s_num_variants * KERNEL_WORDS_PER_VARIANT + 1);
+  EmitKernel(code);
+  const auto kernel = code.GetFunction<void (*)(const IntegerInputs*, IntegerOutputs*, u32)>();
+
+  GenerateEdgeInputs();
+  kernel(s_inputs, &s_outputs[0][0], BLOCK_SIZE);
+  CheckBlock();
+  network_printf("Edge values done\n");
+
+  Random random(GetTestSeed());
+  for (u32 block = 0; block < NUM_RANDOM_BLOCKS; ++block)
+  {
+    GenerateRandomInputs(random);
+    kernel(s_inputs, &s_outputs[0][0], BLOCK_SIZE);
+    CheckBlock();
+
+    if ((block + 1) % 64 == 0)
+    {
+      network_printf("Progress: %u/%u\n", (block + 1) * BLOCK_SIZE,
+                     NUM_RANDOM_BLOCKS * BLOCK_SIZE);
+    }
+    WPAD_ScanPads();
+    if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+      break;
+  }
+
+  END_TEST();
+}
+
+int main()
+{
+  network_init();
+  WPAD_Init();
+
+  IntegerFlagsTest();
+
+  network_printf("Shutting down...\n");
+  network_shutdown();
+
+  return 0;
+}
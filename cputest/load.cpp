@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cstring>
 #include <gctypes.h>
 #include <wiiuse/wpad.h>
+#include "Common/CodeBuffer.h"
+#include "Common/GekkoEncoder.h"
+#include "Common/LoadStoreModel.h"
 #include "Common/hwtests.h"
 
 static void lwzTest()
@@ -410,9 +415,190 @@ static void lbzuxTest()
   }
   END_TEST();
 }
+
+// Registers used by the generated sweep kernels. r3 points to the SweepKernelInputs, r4 to the
+// outputs and r5 to the SweepEncodingValues. rA and rD/rS are reloaded before every encoding,
+// since update forms and loads overwrite them.
+constexpr u32 SWEEP_RA = 6;
+constexpr u32 SWEEP_RB = 7;
+constexpr u32 SWEEP_RD = 8;
+
+constexpr u32 SWEEP_BATCH_SIZE = 4096;
+constexpr u32 SWEEP_WORDS_PER_ENCODING = 7;
+
+// The memory the kernels access. rA points to its middle, so that every 16-bit displacement (or
+// rB offset) stays inside.
+constexpr u32 SWEEP_MEMORY_SIZE = 0x10000 + 32;
+constexpr u32 SWEEP_MEMORY_CENTER = 0x8000;
+
+struct SweepKernelInputs
+{
+  u32 ra_value;
+  u32 r0_value;
+};
+
+// Per-encoding initial values of rD/rS and rB
+struct SweepEncodingValues
+{
+  u32 rd_value;
+  u32 rb_value;
+};
+
+// Register choices for the sweep, including the invalid forms
+struct SweepRegisters
+{
+  u32 ra;
+  u32 rd;
+  const char* description;
+};
+
+static const SweepRegisters SWEEP_REGISTERS[] = {
+    {SWEEP_RA, SWEEP_RD, "rA!=rD"},
+    {SWEEP_RD, SWEEP_RD, "rA=rD"},
+    {0, SWEEP_RD, "rA=0"},
+};
+
+alignas(32) static u8 s_sweep_memory[SWEEP_MEMORY_SIZE];
+static u8 s_sweep_shadow[SWEEP_MEMORY_SIZE];
+static SweepEncodingValues s_sweep_values[SWEEP_BATCH_SIZE];
+static u32 s_sweep_outputs[SWEEP_BATCH_SIZE * 2];
+
+static void EmitSweepKernel(CodeBuffer& code, const LoadStoreInstruction& instruction,
+                            const SweepRegisters& registers, s32 first_d)
+{
+  using namespace Gekko;
+
+  code.Reset();
+  for (u32 i = 0; i < SWEEP_BATCH_SIZE; ++i)
+  {
+    const s32 values_offset = static_cast<s32>(i * sizeof(SweepEncodingValues));
+    code.Emit(LWZ(registers.rd, values_offset, 5));
+    if (registers.ra != 0)
+      code.Emit(LWZ(registers.ra, 0, 3));
+    else
+      code.Emit(LWZ(0, 4, 3));
+    if (instruction.indexed)
+      code.Emit(LWZ(SWEEP_RB, values_offset + 4, 5));
+
+    code.Emit(EncodeLoadStore(instruction, registers.rd, registers.ra, SWEEP_RB,
+                              first_d + static_cast<s32>(i)));
+
+    code.Emit(STW(registers.rd, 0, 4));
+    code.Emit(STW(registers.ra, 4, 4));
+    code.Emit(ADDI(4, 4, 8));
+  }
+  code.Emit(BLR());
+  code.Flush();
+}
+
+static void ResetSweepMemory()
+{
+  for (u32 i = 0; i < SWEEP_MEMORY_SIZE; ++i)
+    s_sweep_memory[i] = static_cast<u8>(i * 7 + (i >> 8) * 13 + 0x5A);
+  std::memcpy(s_sweep_shadow, s_sweep_memory, SWEEP_MEMORY_SIZE);
+}
+
+// Runs SWEEP_BATCH_SIZE encodings of the instruction, with displacements (or rB offsets) starting
+// at first_offset, and checks the registers and memory against LoadStoreModel.h.
+static void CheckSweepBatch(CodeBuffer& code, const LoadStoreInstruction& instruction,
+                            const SweepRegisters& registers, s32 first_offset)
+{
+  const u32 memory_base = (u32)&s_sweep_memory[0];
+  const u32 center = memory_base + SWEEP_MEMORY_CENTER;
+
+  // With rA=0 the whole address comes from rB; r0 is zero so that it's the same address if the
+  // update forms use r0 as a register instead.
+  const SweepKernelInputs inputs = {center, 0};
+  for (u32 i = 0; i < SWEEP_BATCH_SIZE; ++i)
+  {
+    const u32 offset = static_cast<u32>(first_offset) + i;
+    s_sweep_values[i].rd_value = (offset * 0x9E3779B1) ^ 0xA5A5A5A5;
+    s_sweep_values[i].rb_value = registers.ra == 0 ? center + offset : offset;
+  }
+
+  ResetSweepMemory();
+  EmitSweepKernel(code, instruction, registers, first_offset);
+  code.GetFunction<void (*)(const SweepKernelInputs*, u32*, const SweepEncodingValues*)>()(
+      &inputs, s_sweep_outputs, s_sweep_values);
+
+  LoadStoreState state = {};
+  state.memory = s_sweep_shadow;
+  state.memory_base = memory_base;
+  state.memory_size = SWEEP_MEMORY_SIZE;
+
+  for (u32 i = 0; i < SWEEP_BATCH_SIZE; ++i)
+  {
+    const s32 d = first_offset + static_cast<s32>(i);
+    state.gpr[registers.rd] = s_sweep_values[i].rd_value;
+    state.gpr[registers.ra] = registers.ra != 0 ? inputs.ra_value : inputs.r0_value;
+    state.gpr[SWEEP_RB] = s_sweep_values[i].rb_value;
+
+    const u32 encoding = EncodeLoadStore(instruction, registers.rd, registers.ra, SWEEP_RB, d);
+    const bool in_range =
+        ExecuteLoadStore(instruction, registers.rd, registers.ra, SWEEP_RB, d, state);
+
+    const u32 rd_result = s_sweep_outputs[2 * i];
+    const u32 ra_result = s_sweep_outputs[2 * i + 1];
+    DO_TEST(in_range && rd_result == state.gpr[registers.rd] &&
+                ra_result == state.gpr[registers.ra],
+            "{} ({}) 0x{:08x} d/rB={}:\n"
+            "\tgot rD/rS 0x{:08x} rA 0x{:08x}\n"
+            "\texpected rD/rS 0x{:08x} rA 0x{:08x}",
+            instruction.name, registers.description, encoding, d, rd_result, ra_result,
+            state.gpr[registers.rd], state.gpr[registers.ra]);
+  }
+
+  if (instruction.store)
+  {
+    u32 mismatch = 0;
+    while (mismatch < SWEEP_MEMORY_SIZE && s_sweep_memory[mismatch] == s_sweep_shadow[mismatch])
+      ++mismatch;
+    // DO_TEST formats its arguments even when it passes, so keep the index in bounds
+    const u32 shown = std::min(mismatch, SWEEP_MEMORY_SIZE - 1);
+    DO_TEST(mismatch == SWEEP_MEMORY_SIZE,
+            "{} ({}) d/rB={}..{}: memory at offset {} is 0x{:02x}, expected 0x{:02x}",
+            instruction.name, registers.description, first_offset,
+            first_offset + static_cast<s32>(SWEEP_BATCH_SIZE) - 1,
+            static_cast<s32>(shown - SWEEP_MEMORY_CENTER), s_sweep_memory[shown],
+            s_sweep_shadow[shown]);
+  }
+}
+
+// Every 16-bit displacement of the D-forms and every rB offset in the same range for the X-forms,
+// for every integer load and store, with rA and rD distinct, rA=rD and rA=0. With rA=0 the D-forms
+// would access the unmapped start of the address space, so only the X-forms are tested there.
+static void LoadStoreSweepTest()
+{
+  START_TEST();
+
+  CodeBuffer code(SWEEP_BATCH_SIZE * SWEEP_WORDS_PER_ENCODING + 1);
+
+  for (const LoadStoreInstruction& instruction : LOAD_STORE_INSTRUCTIONS)
+  {
+    for (const SweepRegisters& registers : SWEEP_REGISTERS)
+    {
+      if (registers.ra == 0 && !instruction.indexed)
+        continue;
+
+      for (s32 offset = -0x8000; offset < 0x8000; offset += SWEEP_BATCH_SIZE)
+        CheckSweepBatch(code, instruction, registers, offset);
+    }
+
+    network_printf("Progress: %s done\n", instruction.name);
+    WPAD_ScanPads();
+    if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+      break;
+  }
+
+  DO_TEST(!code.Overflowed(), "Generated code did not fit in {} instructions", code.Capacity());
+
+  END_TEST();
+}
+
 int main()
 {
   network_init();
+  WPAD_Init();
 
   lwzTest();
   lwzuTest();
@@ -433,6 +619,8 @@ int main()
   lbzuTest();
   lbzuxTest();
 
+  LoadStoreSweepTest();
+
   network_printf("Shutting down...\n");
   network_shutdown();
 
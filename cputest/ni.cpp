@@ -1,6 +1,12 @@
 #include <gctypes.h>
+#include <iterator>
 #include <wiiuse/wpad.h>
 #include "Common/BitUtils.h"
+#include "Common/ExactFloat.h"
+#include "Common/FloatUtils.h"
+#include "Common/PairedSingle.h"
+#include "Common/PairedSingleKernel.h"
+#include "Common/Random.h"
 #include "Common/hwtests.h"
 
 static const double zero = Common::BitCast<double>(0ULL);
@@ -76,12 +82,217 @@ static void NiTest()
   END_TEST();
 }
 
+// Sweep of the single-precision results around the denormal range, checked against the NI
+// handling in Common/ExactFloat.h: inputs are never flushed, results below the smallest normal
+// are flushed to zero before rounding in NI mode.
+//
+// Every binade from below the smallest denormal single to above the smallest normal single is
+// walked once per sign. Each op gets operands whose exact result in ps0 is the target, which has
+// the bits below single precision set to ties, their neighbors, zero or random bits. Products and
+// quotients use power-of-two factors, sums split the target into two exact parts, so no bits of
+// the target are lost. ps1 holds the operands truncated to single precision. A block of inputs
+// is run through all rounding modes with and without NI, so that FPSCR only changes once per mode
+// and block.
+
+constexpr u32 SWEEP_BLOCK_SIZE = 1024;
+
+// Biased double exponents of the walked binades
+constexpr s32 SWEEP_FIRST_EXPONENT = 1023 - 152;
+constexpr s32 SWEEP_LAST_EXPONENT = 1023 - 124;
+
+static Random s_random(0);
+
+// Same mantissa, exponent changed by shift
+static u64 Rescale(u64 bits, s32 shift)
+{
+  return MakeDouble((bits & DOUBLE_SIGN) != 0, GetExponent(bits) + shift, bits);
+}
+
+static u64 PowerOfTwo(s32 exponent)
+{
+  return MakeDouble(false, 1023 + exponent, 0);
+}
+
+// The i-th target in a binade: the single-precision part walks the binade, the bits below it are
+// a tie, a neighbor of a tie, zero or random
+static u64 SweepTarget(bool sign, s32 exponent, u32 i)
+{
+  constexpr u32 stride = (1 << FLOAT_FRAC_WIDTH) / SWEEP_BLOCK_SIZE;
+  const u64 single_part = i * stride + s_random.NextBelow(stride);
+  constexpr u64 half = 1ULL << (DOUBLE_FRAC_WIDTH - FLOAT_FRAC_WIDTH - 1);
+  static const u64 low_parts[] = {half, half - 1, half + 1, 0};
+  const u64 low_part =
+      i % 5 < std::size(low_parts) ? low_parts[i % 5] : s_random.Next64() & (2 * half - 1);
+  return MakeDouble(sign, exponent,
+                    (single_part << (DOUBLE_FRAC_WIDTH - FLOAT_FRAC_WIDTH)) | low_part);
+}
+
+// A random addend b below target that is a multiple of target's ulp, so that target - b is
+// exact. Returns b and stores target - b in rest.
+static u64 SplitTarget(u64 target, u64* rest)
+{
+  const s32 distance = 1 + static_cast<s32>(s_random.NextBelow(8));
+  const u64 low_bits = (1ULL << distance) - 1;
+  const u64 b = MakeDouble((target & DOUBLE_SIGN) != 0, GetExponent(target) - distance,
+                           s_random.Next64() & ~low_bits);
+  FPState state;
+  *rest = FloatSub(target, b, FloatPrecision::Double, state);
+  return b;
+}
+
+static PSInputs GenerateAdd(u64 target)
+{
+  u64 rest;
+  const u64 b = SplitTarget(target, &rest);
+  return {Pair(rest), Pair(0), Pair(b)};
+}
+
+static PSInputs GenerateMul(u64 target)
+{
+  const s32 shift = s_random.NextInRange(-40, 40);
+  return {Pair(Rescale(target, shift)), Pair(PowerOfTwo(-shift)), Pair(0)};
+}
+
+static PSInputs GenerateDiv(u64 target)
+{
+  const s32 shift = s_random.NextInRange(-40, 40);
+  return {Pair(Rescale(target, shift)), Pair(0), Pair(PowerOfTwo(shift))};
+}
+
+static PSInputs GenerateMadd(u64 target)
+{
+  u64 rest;
+  const u64 b = SplitTarget(target, &rest);
+  const s32 shift = s_random.NextInRange(-40, 40);
+  return {Pair(Rescale(rest, shift)), Pair(PowerOfTwo(-shift)), Pair(b)};
+}
+
+static PSInputs GenerateRound(u64 target)
+{
+  return {Pair(0), Pair(0), Pair(target)};
+}
+
+PS_KERNEL(RunFadds, "fadds %0, %2, %4")
+PS_KERNEL(RunFmuls, "fmuls %0, %2, %3")
+PS_KERNEL(RunFdivs, "fdivs %0, %2, %4")
+PS_KERNEL(RunFmadds, "fmadds %0, %2, %3, %4")
+PS_KERNEL(RunFrsp, "frsp %0, %4")
+PS_KERNEL(RunPsAdd, "ps_add %0, %2, %4")
+PS_KERNEL(RunPsMul, "ps_mul %0, %2, %3")
+PS_KERNEL(RunPsDiv, "ps_div %0, %2, %4")
+PS_KERNEL(RunPsMadd, "ps_madd %0, %2, %3, %4")
+
+struct NiOperation
+{
+  PSOperation operation;
+  PSInputs (*generate)(u64 target);
+};
+
+static const NiOperation NI_OPERATIONS[] = {
+    {{"fadds", RunFadds,
+      [](const PSInputs& in, FPState& state) -> PairedSingle {
+        return {FloatAdd(in.a.ps0, in.b.ps0, FloatPrecision::Single, state), 0};
+      },
+      true},
+     GenerateAdd},
+    {{"fmuls", RunFmuls,
+      [](const PSInputs& in, FPState& state) -> PairedSingle {
+        return {FloatMul(in.a.ps0, in.c.ps0, FloatPrecision::Single, state), 0};
+      },
+      true},
+     GenerateMul},
+    {{"fdivs", RunFdivs,
+      [](const PSInputs& in, FPState& state) -> PairedSingle {
+        return {FloatDiv(in.a.ps0, in.b.ps0, FloatPrecision::Single, state), 0};
+      },
+      true},
+     GenerateDiv},
+    {{"fmadds", RunFmadds,
+      [](const PSInputs& in, FPState& state) -> PairedSingle {
+        return {FloatMulAdd(in.a.ps0, in.c.ps0, in.b.ps0, false, false, FloatPrecision::Single,
+                            state),
+                0};
+      },
+      true},
+     GenerateMadd},
+    {{"frsp", RunFrsp,
+      [](const PSInputs& in, FPState& state) -> PairedSingle {
+        return {FloatRoundToSingle(in.b.ps0, state), 0};
+      },
+      true},
+     GenerateRound},
+    {{"ps_add", RunPsAdd,
+      [](const PSInputs& in, FPState& state) { return ps_add_expected(in.a, in.b, state); }},
+     GenerateAdd},
+    {{"ps_mul", RunPsMul,
+      [](const PSInputs& in, FPState& state) { return ps_mul_expected(in.a, in.c, state); }},
+     GenerateMul},
+    {{"ps_div", RunPsDiv,
+      [](const PSInputs& in, FPState& state) { return ps_div_expected(in.a, in.b, state); }},
+     GenerateDiv},
+    {{"ps_madd", RunPsMadd,
+      [](const PSInputs& in, FPState& state) {
+        return ps_madd_expected(in.a, in.c, in.b, state);
+      }},
+     GenerateMadd},
+};
+
+static const u64 DEFAULT_FPSCR = 0;
+
+static PSInputs s_sweep_inputs[std::size(NI_OPERATIONS)][SWEEP_BLOCK_SIZE];
+static PairedSingle s_sweep_results[SWEEP_BLOCK_SIZE];
+
+static void NiSweepTest()
+{
+  START_TEST();
+  s_random.Seed(GetTestSeed());
+
+  for (s32 exponent = SWEEP_FIRST_EXPONENT; exponent <= SWEEP_LAST_EXPONENT; ++exponent)
+  {
+    for (bool sign : {false, true})
+    {
+      for (u32 i = 0; i < SWEEP_BLOCK_SIZE; ++i)
+      {
+        const u64 target = SweepTarget(sign, exponent, i);
+        for (u32 j = 0; j < std::size(NI_OPERATIONS); ++j)
+          s_sweep_inputs[j][i] = NI_OPERATIONS[j].generate(target);
+      }
+
+      for (u32 ni = 0; ni < 2; ++ni)
+      {
+        for (u32 rounding_mode = 0; rounding_mode < 4; ++rounding_mode)
+        {
+          // Set FPSCR[NI] and FPSCR[RN] (and FPSCR[XE] but that's okay).
+          const u64 mtfsf_input = (ni << 2) | rounding_mode;
+          asm volatile("mtfsf 7, %0" ::"f"(mtfsf_input));
+
+          for (u32 j = 0; j < std::size(NI_OPERATIONS); ++j)
+          {
+            CheckPSOperation(NI_OPERATIONS[j].operation, s_sweep_inputs[j], s_sweep_results,
+                             SWEEP_BLOCK_SIZE, ni, rounding_mode);
+          }
+        }
+      }
+    }
+
+    asm volatile("mtfsf 7, %0" ::"f"(DEFAULT_FPSCR));
+
+    network_printf("Exponent %d done\n", exponent - 1023);
+    WPAD_ScanPads();
+    if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+      break;
+  }
+
+  END_TEST();
+}
+
 int main()
 {
   network_init();
   WPAD_Init();
 
   NiTest();
+  NiSweepTest();
 
   network_printf("Shutting down...\n");
   network_shutdown();
@@ -0,0 +1,282 @@
+#include <gctypes.h>
+#include <iterator>
+#include <wiiuse/wpad.h>
+
+#include "Common/BitUtils.h"
+#include "Common/FloatUtils.h"
+#include "Common/PairedSingle.h"
+#include "Common/PairedSingleKernel.h"
+#include "Common/Random.h"
+#include "Common/hwtests.h"
+
+// Compares the paired-single arithmetic instructions against the model in Common/PairedSingle.h,
+// using random operands mixed with special values in all rounding modes, with and without NI.
+//
+// Each mode starts with a block of edge values in both slots of c. The slots that ps_sum0 and
+// ps_sum1 only move are the interesting part there: ps_sum0 truncates c.ps1 like the merges do,
+// while ps_sum1 rounds c.ps0 even when it is an infinity or a NaN (RoundMantissaBitsAssumeFinite).
+// Most edge values sit on the rounding boundaries of the latter.
+
+constexpr u32 BLOCK_SIZE = 1024;
+constexpr u32 NUM_BLOCKS = 64;
+
+// Reseeded with the test seed when the test starts
+static Random s_random(0);
+
+static const u32 SPECIAL_SINGLES[] = {
+    0x00000000,  // zero
+    0x3F800000,  // one
+    0x7F800000,  // infinity
+    0x7FC00000,  // QNaN
+    0x7FA00000,  // SNaN
+    0x7FFFFFFF,  // QNaN with payload
+    0x7F800001,  // SNaN with payload
+    0x7F7FFFFF,  // largest normal
+    0x00800000,  // smallest normal
+    0x007FFFFF,  // largest denormal
+    0x00000001,  // smallest denormal
+    0x3F7FFFFF,  // one minus ulp
+};
+
+static const u64 SPECIAL_DOUBLES[] = {
+    0x0000000000000001,  // smallest denormal
+    0x000FFFFFFFFFFFFF,  // largest denormal
+    0x0010000000000000,  // smallest normal
+    0x7FEFFFFFFFFFFFFF,  // largest normal
+    0x47EFFFFFE0000000,  // largest single plus half an ulp, rounds to infinity
+    0x36A0000000000000,  // half the smallest single denormal
+    0x3FEFFFFFFFFFFFFF,  // one minus ulp
+};
+
+static const u64 EDGE_VALUES[] = {
+    0x0000000000000000,  // zero
+    0x3FF0000000000000,  // one
+    0x3FF0000010000000,  // one plus half a single ulp, a tie
+    0x3FF0000030000000,  // one and a half single ulps, a tie that rounds up
+    0x3FF000000FFFFFFF,  // just below the tie
+    0x3FF0000010000001,  // just above the tie
+    0x3FEFFFFFF0000000,  // rounds up to one
+    0x3FFFFFFFFFFFFFFF,  // rounds up into the next binade
+    0x47EFFFFFE0000000,  // largest single plus half an ulp
+    0x47EFFFFFEFFFFFFF,  // largest single plus a bit less than half an ulp
+    0x7FEFFFFFFFFFFFFF,  // largest double
+    0x7FF0000000000000,  // infinity
+    0x7FF0000010000000,  // SNaN whose payload is only below single precision
+    0x7FF0000030000000,  // SNaN that rounds differently from truncation
+    0x7FF8000000000000,  // QNaN
+    0x7FFFFFFFF0000000,  // QNaN that would carry into the sign if rounded up
+    0x7FFFFFFFFFFFFFFF,  // QNaN with all payload bits set
+    0x3810000000000000,  // smallest normal single
+    0x380FFFFFF0000000,  // largest denormal single, with bits below it
+    0x36A0000000000000,  // half the smallest denormal single
+    0x3690000000000000,  // a quarter of the smallest denormal single
+    0x0010000000000000,  // smallest normal double
+    0x000FFFFFFFFFFFFF,  // largest denormal double
+    0x0000000000000001,  // smallest denormal double
+};
+
+// Random operands for each edge value
+constexpr u32 EDGE_REPEATS = 8;
+static_assert(std::size(EDGE_VALUES) * 2 * EDGE_REPEATS <= BLOCK_SIZE);
+
+static u32 RandomSingleBits()
+{
+  const u64 random = s_random.Next64();
+  const u32 sign = static_cast<u32>(random >> 63) << 31;
+  switch ((random >> 56) & 7)
+  {
+  case 0:
+    return sign | SPECIAL_SINGLES[(random >> 32) % std::size(SPECIAL_SINGLES)];
+  case 1:
+    // Any bit pattern, including denormals and NaNs
+    return static_cast<u32>(random);
+  default:
+  {
+    // Exponents close to each other, so that operations neither overflow nor underflow much
+    const u32 exp = 127 - 24 + static_cast<u32>((random >> 32) % 49);
+    return sign | (exp << FLOAT_FRAC_WIDTH) | (static_cast<u32>(random) & FLOAT_FRAC);
+  }
+  }
+}
+
+static u64 RandomSingle()
+{
+  return ConvertFloatBitsToDouble(RandomSingleBits());
+}
+
+static u64 RandomDouble()
+{
+  const u64 random = s_random.Next64();
+  switch (random & 7)
+  {
+  case 0:
+    return (random & DOUBLE_SIGN) | SPECIAL_DOUBLES[(random >> 8) % std::size(SPECIAL_DOUBLES)];
+  case 1:
+  {
+    // Bits below single precision, in and around the single-precision exponent range
+    const u64 exp = 1023 - 160 + (random >> 8) % 320;
+    return (s_random.Next64() & (DOUBLE_SIGN | DOUBLE_FRAC)) | (exp << DOUBLE_FRAC_WIDTH);
+  }
+  case 2:
+  {
+    // Bits below single precision, with the usual exponents
+    const u64 exp = 1023 - 24 + (random >> 8) % 49;
+    return (s_random.Next64() & (DOUBLE_SIGN | DOUBLE_FRAC)) | (exp << DOUBLE_FRAC_WIDTH);
+  }
+  default:
+    return RandomSingle();
+  }
+}
+
+// Every edge value (with both signs) in both slots of c, which ps_sum0 and ps_sum1 move, with
+// random a and b. ps1 is loaded through a merge, so it holds the truncated value.
+static u32 GenerateEdgeInputs(PSInputs* inputs)
+{
+  u32 count = 0;
+  for (u64 value : EDGE_VALUES)
+  {
+    for (u64 sign : {u64{0}, DOUBLE_SIGN})
+    {
+      for (u32 i = 0; i < EDGE_REPEATS; ++i)
+      {
+        PSInputs& in = inputs[count++];
+        in.a = {RandomDouble(), RandomSingle()};
+        in.c = {sign | value, TruncateMantissaBits(sign | value)};
+        in.b = {RandomDouble(), RandomSingle()};
+      }
+    }
+  }
+  return count;
+}
+
+static void GenerateInputs(PSInputs* inputs, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    PSInputs& in = inputs[i];
+    const u32 a_ps1 = RandomSingleBits();
+    in.a = {RandomDouble(), ConvertFloatBitsToDouble(a_ps1)};
+    in.c = {RandomDouble(), RandomSingle()};
+    in.b = {RandomDouble(), RandomSingle()};
+
+    // Sometimes make the addend cancel most of the other operand
+    if ((s_random.Next64() & 7) == 0)
+    {
+      in.b.ps0 = (in.a.ps0 ^ DOUBLE_SIGN) + (s_random.Next64() & 0xFFFFFFFF);
+      in.b.ps1 = ConvertFloatBitsToDouble((a_ps1 ^ FLOAT_SIGN) + (s_random.Next64() & 0xF));
+    }
+  }
+}
+
+PS_KERNEL(RunPsAdd, "ps_add %0, %2, %4")
+PS_KERNEL(RunPsSub, "ps_sub %0, %2, %4")
+PS_KERNEL(RunPsMul, "ps_mul %0, %2, %3")
+PS_KERNEL(RunPsMuls0, "ps_muls0 %0, %2, %3")
+PS_KERNEL(RunPsMuls1, "ps_muls1 %0, %2, %3")
+PS_KERNEL(RunPsDiv, "ps_div %0, %2, %4")
+PS_KERNEL(RunPsMadd, "ps_madd %0, %2, %3, %4")
+PS_KERNEL(RunPsMadds0, "ps_madds0 %0, %2, %3, %4")
+PS_KERNEL(RunPsMadds1, "ps_madds1 %0, %2, %3, %4")
+PS_KERNEL(RunPsSum0, "ps_sum0 %0, %2, %3, %4")
+PS_KERNEL(RunPsSum1, "ps_sum1 %0, %2, %3, %4")
+PS_KERNEL(RunPsMerge00, "ps_merge00 %0, %2, %4")
+PS_KERNEL(RunPsMerge01, "ps_merge01 %0, %2, %4")
+PS_KERNEL(RunPsMerge10, "ps_merge10 %0, %2, %4")
+PS_KERNEL(RunPsMerge11, "ps_merge11 %0, %2, %4")
+
+static const PSOperation OPERATIONS[] = {
+    {"ps_add", RunPsAdd,
+     [](const PSInputs& in, FPState& state) { return ps_add_expected(in.a, in.b, state); }},
+    {"ps_sub", RunPsSub,
+     [](const PSInputs& in, FPState& state) { return ps_sub_expected(in.a, in.b, state); }},
+    {"ps_mul", RunPsMul,
+     [](const PSInputs& in, FPState& state) { return ps_mul_expected(in.a, in.c, state); }},
+    {"ps_muls0", RunPsMuls0,
+     [](const PSInputs& in, FPState& state) { return ps_muls0_expected(in.a, in.c, state); }},
+    {"ps_muls1", RunPsMuls1,
+     [](const PSInputs& in, FPState& state) { return ps_muls1_expected(in.a, in.c, state); }},
+    {"ps_div", RunPsDiv,
+     [](const PSInputs& in, FPState& state) { return ps_div_expected(in.a, in.b, state); }},
+    {"ps_madd", RunPsMadd,
+     [](const PSInputs& in, FPState& state) { return ps_madd_expected(in.a, in.c, in.b, state); }},
+    {"ps_madds0", RunPsMadds0,
+     [](const PSInputs& in, FPState& state) {
+       return ps_madds0_expected(in.a, in.c, in.b, state);
+     }},
+    {"ps_madds1", RunPsMadds1,
+     [](const PSInputs& in, FPState& state) {
+       return ps_madds1_expected(in.a, in.c, in.b, state);
+     }},
+    {"ps_sum0", RunPsSum0,
+     [](const PSInputs& in, FPState& state) { return ps_sum0_expected(in.a, in.c, in.b, state); }},
+    {"ps_sum1", RunPsSum1,
+     [](const PSInputs& in, FPState& state) { return ps_sum1_expected(in.a, in.c, in.b, state); }},
+    {"ps_merge00", RunPsMerge00,
+     [](const PSInputs& in, FPState& state) { return ps_merge00_expected(in.a, in.b, state); }},
+    {"ps_merge01", RunPsMerge01,
+     [](const PSInputs& in, FPState& state) { return ps_merge01_expected(in.a, in.b, state); }},
+    {"ps_merge10", RunPsMerge10,
+     [](const PSInputs& in, FPState& state) { return ps_merge10_expected(in.a, in.b, state); }},
+    {"ps_merge11", RunPsMerge11,
+     [](const PSInputs& in, FPState& state) { return ps_merge11_expected(in.a, in.b, state); }},
+};
+
+static const u64 DEFAULT_FPSCR = 0;
+
+static PSInputs s_inputs[BLOCK_SIZE];
+static PairedSingle s_results[BLOCK_SIZE];
+
+static void PSArithTest()
+{
+  START_TEST();
+  s_random.Seed(GetTestSeed());
+
+  for (u32 ni = 0; ni < 2; ++ni)
+  {
+    for (u32 rounding_mode = 0; rounding_mode < 4; ++rounding_mode)
+    {
+      // Set FPSCR[NI] and FPSCR[RN] (and FPSCR[XE] but that's okay).
+      const u64 mtfsf_input = (ni << 2) | rounding_mode;
+      asm volatile("mtfsf 7, %0" ::"f"(mtfsf_input));
+
+      const u32 num_edge_inputs = GenerateEdgeInputs(s_inputs);
+      for (const PSOperation& operation : OPERATIONS)
+        CheckPSOperation(operation, s_inputs, s_results, num_edge_inputs, ni, rounding_mode);
+
+      for (u32 block = 0; block < NUM_BLOCKS; ++block)
+      {
+        GenerateInputs(s_inputs, BLOCK_SIZE);
+
+        for (const PSOperation& operation : OPERATIONS)
+          CheckPSOperation(operation, s_inputs, s_results, BLOCK_SIZE, ni, rounding_mode);
+
+        network_printf("Progress NI=%u RN=%u: %u/%u\n", ni, rounding_mode,
+                       (block + 1) * BLOCK_SIZE, NUM_BLOCKS * BLOCK_SIZE);
+        WPAD_ScanPads();
+        if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+        {
+          asm volatile("mtfsf 7, %0" ::"f"(DEFAULT_FPSCR));
+          END_TEST();
+          return;
+        }
+      }
+    }
+  }
+
+  asm volatile("mtfsf 7, %0" ::"f"(DEFAULT_FPSCR));
+
+  END_TEST();
+}
+
+int main()
+{
+  network_init();
+  WPAD_Init();
+
+  PSArithTest();
+
+  network_printf("Shutting down...\n");
+  network_shutdown();
+
+  return 0;
+}
@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <cmath>
+#include <gctypes.h>
+#include <iterator>
+#include <wiiuse/wpad.h>
+
+#include "Common/BitUtils.h"
+#include "Common/FloatUtils.h"
+#include "Common/PairedSingle.h"
+#include "Common/hwtests.h"
+
+// Compares psq_l and psq_st against the quantization model in Common/FloatUtils.h, for every load
+// and store type and every scale. GQR2 is set up to load and store plain floats and GQR3 holds
+// the type under test.
+
+constexpr u32 BLOCK_SIZE = 4096;
+
+// Step through the float bit patterns for the float type, since all of them would take too long
+constexpr u32 FLOAT_STRIDE = 65521;
+
+constexpr u64 DOUBLE_ONE = 0x3FF0000000000000ULL;
+
+static const QuantizeType INTEGER_TYPES[] = {QuantizeType::U8, QuantizeType::U16,
+                                             QuantizeType::S8, QuantizeType::S16};
+
+static const u32 SPECIAL_SINGLES[] = {
+    0x00000000,  // zero
+    0x3F800000,  // one
+    0x3F000000,  // one half
+    0x3F7FFFFF,  // one minus ulp
+    0x7F800000,  // infinity
+    0x7F7FFFFF,  // largest normal
+    0x00800000,  // smallest normal
+    0x007FFFFF,  // largest denormal
+    0x00000001,  // smallest denormal
+    0x4F000000,  // 2^31
+    0x4F800000,  // 2^32
+};
+
+static const char* QuantizeTypeName(QuantizeType type)
+{
+  switch (type)
+  {
+  case QuantizeType::U8:
+    return "u8";
+  case QuantizeType::U16:
+    return "u16";
+  case QuantizeType::S8:
+    return "s8";
+  case QuantizeType::S16:
+    return "s16";
+  default:
+    return "float";
+  }
+}
+
+static void SetGQR3(u32 value)
+{
+  asm volatile("mtspr 915, %0\n"
+               "isync\n" ::"r"(value));
+}
+
+static u8 s_raw[BLOCK_SIZE * 4];
+static u8 s_expected_raw[BLOCK_SIZE * 4];
+static float s_values[BLOCK_SIZE];
+static float s_expected_values[BLOCK_SIZE];
+static PairedSingle s_results[BLOCK_SIZE];
+
+// Elements are stored big-endian, like the console does natively
+static void WriteRaw(u8* dst, u32 index, u32 size, u32 value)
+{
+  for (u32 j = 0; j < size; ++j)
+    dst[index * size + j] = static_cast<u8>(value >> (8 * (size - 1 - j)));
+}
+
+static u32 ReadRaw(const u8* src, u32 index, u32 size)
+{
+  u32 value = 0;
+  for (u32 j = 0; j < size; ++j)
+    value = (value << 8) | src[index * size + j];
+  return value;
+}
+
+// Loads pairs of elements from src with GQR3
+static void RunLoadPairs(const u8* src, u32 size, PairedSingle* results, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    double ps0, ps1;
+    asm volatile("psq_l %0, 0(%2), 0, 3\n"
+                 "ps_merge11 %1, %0, %0\n"
+                 : "=&f"(ps0), "=&f"(ps1)
+                 : "b"(src + 2 * i * size)
+                 : "memory");
+    results[i] = {Common::BitCast<u64>(ps0), Common::BitCast<u64>(ps1)};
+  }
+}
+
+// Loads single elements from src with GQR3, which sets ps1 to 1.0
+static void RunLoadSingles(const u8* src, u32 size, PairedSingle* results, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    double ps0, ps1;
+    asm volatile("psq_l %0, 0(%2), 1, 3\n"
+                 "ps_merge11 %1, %0, %0\n"
+                 : "=&f"(ps0), "=&f"(ps1)
+                 : "b"(src + i * size)
+                 : "memory");
+    results[i] = {Common::BitCast<u64>(ps0), Common::BitCast<u64>(ps1)};
+  }
+}
+
+// Loads pairs of floats from src with GQR2 and stores them to dst with GQR3
+static void RunStorePairs(const float* src, u8* dst, u32 size, u32 count)
+{
+  for (u32 i = 0; i < count; i += 2)
+  {
+    double temp;
+    asm volatile("psq_l %0, 0(%1), 0, 2\n"
+                 "psq_st %0, 0(%2), 0, 3\n"
+                 : "=&f"(temp)
+                 : "b"(src + i), "b"(dst + i * size)
+                 : "memory");
+  }
+}
+
+static u64 ExpectedLoadedBits(float value)
+{
+  return ConvertFloatBitsToDouble(Common::BitCast<u32>(value));
+}
+
+// Checks a block of loads of raw elements, both in pairs and one at a time
+static void CheckLoadBlock(QuantizeType type, u32 scale, u32 count)
+{
+  const u32 size = QuantizeTypeSize(type);
+  DequantizeBatch(s_raw, s_expected_values, count, type, scale);
+
+  RunLoadPairs(s_raw, size, s_results, count / 2);
+  for (u32 i = 0; i < count / 2; ++i)
+  {
+    const PairedSingle expected = {ExpectedLoadedBits(s_expected_values[2 * i]),
+                                   ExpectedLoadedBits(s_expected_values[2 * i + 1])};
+    DO_TEST(s_results[i] == expected,
+            "psq_l {} scale {} W=0 element {}:\n"
+            "     got {:016x} {:016x}\n"
+            "expected {:016x} {:016x}",
+            QuantizeTypeName(type), scale, 2 * i, s_results[i].ps0, s_results[i].ps1,
+            expected.ps0, expected.ps1);
+  }
+
+  RunLoadSingles(s_raw, size, s_results, count);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const PairedSingle expected = {ExpectedLoadedBits(s_expected_values[i]), DOUBLE_ONE};
+    DO_TEST(s_results[i] == expected,
+            "psq_l {} scale {} W=1 element {}:\n"
+            "     got {:016x} {:016x}\n"
+            "expected {:016x} {:016x}",
+            QuantizeTypeName(type), scale, i, s_results[i].ps0, s_results[i].ps1, expected.ps0,
+            expected.ps1);
+  }
+}
+
+// Checks a block of stores of the floats in s_values
+static void CheckStoreBlock(QuantizeType type, u32 scale, u32 count)
+{
+  const u32 size = QuantizeTypeSize(type);
+  QuantizeBatch(s_values, s_expected_raw, count, type, scale);
+
+  RunStorePairs(s_values, s_raw, size, count);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 result = ReadRaw(s_raw, i, size);
+    const u32 expected = ReadRaw(s_expected_raw, i, size);
+    DO_TEST(result == expected, "psq_st {} scale {} of {:08x}: got {:x}, expected {:x}",
+            QuantizeTypeName(type), scale, Common::BitCast<u32>(s_values[i]), result, expected);
+  }
+}
+
+static bool ShouldAbort()
+{
+  WPAD_ScanPads();
+  return (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME) != 0;
+}
+
+// Every raw value of every integer type with every scale
+static bool IntegerLoadSweep()
+{
+  for (QuantizeType type : INTEGER_TYPES)
+  {
+    const u32 size = QuantizeTypeSize(type);
+    const u32 num_values = 1U << (8 * size);
+
+    for (u32 scale = 0; scale < 64; ++scale)
+    {
+      SetGQR3(MakeGQR(type, scale, type, scale));
+
+      for (u32 start = 0; start < num_values; start += BLOCK_SIZE)
+      {
+        const u32 count = std::min(BLOCK_SIZE, num_values - start);
+        for (u32 i = 0; i < count; ++i)
+          WriteRaw(s_raw, i, size, start + i);
+        CheckLoadBlock(type, scale, count);
+      }
+
+      if (ShouldAbort())
+        return false;
+    }
+
+    network_printf("Loads of %s done\n", QuantizeTypeName(type));
+  }
+  return true;
+}
+
+// Special values followed by values spaced a quarter apart after scaling, from a bit below the
+// smallest representable value to a bit above the largest. Returns the number of values, which is
+// always even, and zero once all values have been generated.
+static u32 GenerateStoreInputs(QuantizeType type, u32 scale, u32* next_step)
+{
+  const bool is_signed = type == QuantizeType::S8 || type == QuantizeType::S16;
+  const u32 size = QuantizeTypeSize(type);
+  const s32 min = is_signed ? -(1 << (8 * size - 1)) : 0;
+  const s32 max = is_signed ? (1 << (8 * size - 1)) - 1 : (1 << (8 * size)) - 1;
+  const s32 first = 4 * min - 64;
+  const u32 num_steps = static_cast<u32>(4 * max + 64 - first + 1);
+  const float factor = DequantizeFactor(scale);
+
+  u32 count = 0;
+  if (*next_step == 0)
+  {
+    for (u32 special : SPECIAL_SINGLES)
+    {
+      s_values[count++] = Common::BitCast<float>(special);
+      s_values[count++] = Common::BitCast<float>(special | FLOAT_SIGN);
+    }
+  }
+
+  for (; *next_step < num_steps && count < BLOCK_SIZE; ++*next_step)
+    s_values[count++] = static_cast<float>(first + static_cast<s32>(*next_step)) * 0.25f * factor;
+
+  // psq_st stores pairs, so repeat the last value if needed
+  if (count % 2 != 0)
+  {
+    s_values[count] = s_values[count - 1];
+    ++count;
+  }
+
+  return count;
+}
+
+// Stores of all integer types with every scale
+static bool IntegerStoreSweep()
+{
+  for (QuantizeType type : INTEGER_TYPES)
+  {
+    for (u32 scale = 0; scale < 64; ++scale)
+    {
+      SetGQR3(MakeGQR(type, scale, type, scale));
+
+      u32 next_step = 0;
+      while (const u32 count = GenerateStoreInputs(type, scale, &next_step))
+        CheckStoreBlock(type, scale, count);
+
+      if (ShouldAbort())
+        return false;
+    }
+
+    network_printf("Stores of %s done\n", QuantizeTypeName(type));
+  }
+  return true;
+}
+
+// A sample of all float bit patterns, loaded and stored with the float type. NaNs are only
+// loaded, since what psq_st does with them isn't modeled.
+static bool FloatSweep()
+{
+  SetGQR3(MakeGQR(QuantizeType::Float, 0, QuantizeType::Float, 0));
+
+  u64 bits = 0;
+  bool first_block = true;
+  while (bits <= 0xFFFFFFFF)
+  {
+    u32 count = 0;
+    if (first_block)
+    {
+      for (u32 special : SPECIAL_SINGLES)
+      {
+        WriteRaw(s_raw, count++, 4, special);
+        WriteRaw(s_raw, count++, 4, special | FLOAT_SIGN);
+      }
+      first_block = false;
+    }
+    for (; count < BLOCK_SIZE && bits <= 0xFFFFFFFF; bits += FLOAT_STRIDE)
+      WriteRaw(s_raw, count++, 4, static_cast<u32>(bits));
+    count &= ~1U;
+
+    CheckLoadBlock(QuantizeType::Float, 0, count);
+
+    u32 num_values = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+      const float value = Common::BitCast<float>(ReadRaw(s_raw, i, 4));
+      if (!std::isnan(value))
+        s_values[num_values++] = value;
+    }
+    CheckStoreBlock(QuantizeType::Float, 0, num_values & ~1U);
+
+    if (ShouldAbort())
+      return false;
+  }
+
+  network_printf("Float loads and stores done\n");
+  return true;
+}
+
+static void QuantizeSweepTest()
+{
+  START_TEST();
+
+  u32 old_gqr2, old_gqr3;
+  asm volatile("mfspr %0, 914\n"
+               "mfspr %1, 915\n"
+               : "=r"(old_gqr2), "=r"(old_gqr3));
+  asm volatile("mtspr 914, %0\n"
+               "isync\n" ::"r"(MakeGQR(QuantizeType::Float, 0, QuantizeType::Float, 0)));
+
+  if (IntegerLoadSweep() && IntegerStoreSweep())
+    FloatSweep();
+
+  asm volatile("mtspr 914, %0\n"
+               "mtspr 915, %1\n"
+               "isync\n" ::"r"(old_gqr2),
+               "r"(old_gqr3));
+
+  END_TEST();
+}
+
+int main()
+{
+  network_init();
+  WPAD_Init();
+
+  QuantizeSweepTest();
+
+  network_printf("Shutting down...\n");
+  network_shutdown();
+
+  return 0;
+}
@@ -9,9 +9,14 @@
 #include <ppu_intrinsics.h>
 #include <wiiuse/wpad.h>
 
+#include "Common/ExpectedStream.h"
 #include "Common/FloatUtils.h"
 #include "Common/hwtests.h"
 
+// Receive the expected results from tools/expected_stream instead of computing them on the
+// console. Requires the tool to be connected instead of netcat.
+#define USE_EXPECTED_STREAM false
+
 static inline double fres_intrinsic(double val)
 {
   double estimate;
@@ -67,12 +72,59 @@ static void ReciprocalTest()
   END_TEST();
 }
 
+// Same as ReciprocalTest, but with the expected values computed on the host
+static void ReciprocalStreamedTest()
+{
+  START_TEST();
+
+  ExpectedStream stream(ExpectedKind::Reciprocal, true, 0, 0x100000000ULL);
+
+  u64 i = 0;
+  const u64* expected;
+  while (const u32 size = stream.Next(&expected))
+  {
+    for (u32 j = 0; j < size; j += 2, ++i)
+    {
+      const double input = Common::BitCast<double>(i << 32);
+
+      const u64 frsqrte = Common::BitCast<u64>(__frsqrte(input));
+      DO_TEST(frsqrte == expected[j], "Bad frsqrte {:016x}: got {:016x}, expected {:016x}",
+              i << 32, frsqrte, expected[j]);
+      if (frsqrte != expected[j])
+        goto end;
+
+      const u64 fres = Common::BitCast<u64>(fres_intrinsic(input));
+      DO_TEST(fres == expected[j + 1], "Bad fres {:016x}: got {:016x}, expected {:016x}",
+              i << 32, fres, expected[j + 1]);
+      if (fres != expected[j + 1])
+        goto end;
+    }
+
+    if (!(i & ((1 << 22) - 1)))
+    {
+      network_printf("Progress %lld\n", i);
+      WPAD_ScanPads();
+
+      if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+        goto end;
+    }
+  }
+
+  DO_TEST(stream.Complete(), "Expected stream ended early at input {}", i);
+
+end:
+  END_TEST();
+}
+
 int main()
 {
   network_init();
   WPAD_Init();
 
-  ReciprocalTest();
+  if (USE_EXPECTED_STREAM)
+    ReciprocalStreamedTest();
+  else
+    ReciprocalTest();
 
   network_printf("Shutting down...\n");
   network_shutdown();
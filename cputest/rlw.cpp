@@ -1,6 +1,8 @@
 #include <gctypes.h>
 #include <wiiuse/wpad.h>
+#include "Common/CodeBuffer.h"
 #include "Common/CommonFuncs.h"
+#include "Common/GekkoEncoder.h"
 #include "Common/hwtests.h"
 
 // Generates a bitmask from the ten bits encoded in the instruction.
@@ -187,13 +189,211 @@ static void rlwnmxTest()
   RLWNMX_TEST(31, 31);
   END_TEST();
 }
+
+// Primary opcodes of the rotate instructions
+constexpr u32 OPCODE_RLWIMI = 20;
+constexpr u32 OPCODE_RLWINM = 21;
+constexpr u32 OPCODE_RLWNM = 23;
+
+// Registers used by the generated code: the kernels load rS, the initial rA and rB from the input
+// array once, then run every encoding on a copy of rA.
+constexpr u32 SWEEP_RS = 5;
+constexpr u32 SWEEP_RA = 8;
+constexpr u32 SWEEP_RB = 7;
+constexpr u32 SWEEP_RA_INITIAL = 6;
+constexpr u32 SWEEP_CR = 9;
+constexpr u32 SWEEP_CR0_SOURCE = 10;
+
+// Encodings per generated kernel. Each kernel is flushed once and run on all inputs.
+constexpr u32 SWEEP_BATCH_SIZE = 4096;
+constexpr u32 SWEEP_WORDS_PER_ENCODING = 7;
+
+// CR0 is set to this before each encoding. An Rc=1 encoding can never produce it, since exactly
+// one of LT, GT and EQ is set and SO is clear; an Rc=0 encoding has to keep it.
+constexpr u32 SWEEP_CR0_SENTINEL = 0xF;
+
+struct RlwInputs
+{
+  u32 s;
+  u32 a;
+  u32 b;
+};
+
+static u32 s_sweep_outputs[SWEEP_BATCH_SIZE * 2];
+
+static void EmitSweepKernel(CodeBuffer& code, const u32* encodings, u32 count)
+{
+  using namespace Gekko;
+
+  // r3 points to the RlwInputs, r4 to the outputs
+  code.Reset();
+  code.Emit(LWZ(SWEEP_RS, 0, 3));
+  code.Emit(LWZ(SWEEP_RA_INITIAL, 4, 3));
+  code.Emit(LWZ(SWEEP_RB, 8, 3));
+  code.Emit(LI(0, 0));
+  code.Emit(MTXER(0));
+  code.Emit(LIS(SWEEP_CR0_SOURCE, static_cast<s32>(SWEEP_CR0_SENTINEL << 12)));
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    code.Emit(MR(SWEEP_RA, SWEEP_RA_INITIAL));
+    code.Emit(MTCRF(0x80, SWEEP_CR0_SOURCE));
+    code.Emit(encodings[i]);
+    code.Emit(MFCR(SWEEP_CR));
+    code.Emit(STW(SWEEP_RA, 0, 4));
+    code.Emit(STW(SWEEP_CR, 4, 4));
+    code.Emit(ADDI(4, 4, 8));
+  }
+
+  code.Emit(BLR());
+  code.Flush();
+}
+
+static u32 ExpectedRlwResult(u32 instruction, const RlwInputs& inputs)
+{
+  const u32 opcode = instruction >> 26;
+  const u32 sh = (instruction >> 11) & 0x1F;
+  const u32 mask = GetHelperMask((instruction >> 6) & 0x1F, (instruction >> 1) & 0x1F);
+
+  switch (opcode)
+  {
+  case OPCODE_RLWIMI:
+    return (inputs.a & ~mask) | (_rotl(inputs.s, sh) & mask);
+  case OPCODE_RLWINM:
+    return _rotl(inputs.s, sh) & mask;
+  default:
+    return _rotl(inputs.s, inputs.b & 0x1F) & mask;
+  }
+}
+
+static u32 ExpectedCr0(u32 instruction, u32 result)
+{
+  if ((instruction & 1) == 0)
+    return SWEEP_CR0_SENTINEL;
+  if (static_cast<s32>(result) < 0)
+    return 0x8;
+  return result == 0 ? 0x2 : 0x4;
+}
+
+static const char* GetRlwName(u32 instruction)
+{
+  switch (instruction >> 26)
+  {
+  case OPCODE_RLWIMI:
+    return (instruction & 1) ? "rlwimi." : "rlwimi";
+  case OPCODE_RLWINM:
+    return (instruction & 1) ? "rlwinm." : "rlwinm";
+  default:
+    return (instruction & 1) ? "rlwnm." : "rlwnm";
+  }
+}
+
+// Runs a batch of encodings on every input and compares rA and CR0 against the model
+static void CheckSweepBatch(CodeBuffer& code, const u32* encodings, u32 count,
+                            const RlwInputs* inputs, u32 num_inputs)
+{
+  EmitSweepKernel(code, encodings, count);
+  const auto kernel = code.GetFunction<void (*)(const RlwInputs*, u32*)>();
+
+  for (u32 j = 0; j < num_inputs; ++j)
+  {
+    kernel(&inputs[j], s_sweep_outputs);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      const u32 result = s_sweep_outputs[2 * i];
+      const u32 cr0 = s_sweep_outputs[2 * i + 1] >> 28;
+      const u32 expected = ExpectedRlwResult(encodings[i], inputs[j]);
+      const u32 expected_cr0 = ExpectedCr0(encodings[i], expected);
+
+      DO_TEST(result == expected && cr0 == expected_cr0,
+              "{} (0x{:08x}) rA={:08x} rS={:08x} rB={:08x} sh={} mb={} me={}\n"
+              "\tgot: {:08x} cr0={:x}\n"
+              "\texpected: {:08x} cr0={:x}\n",
+              GetRlwName(encodings[i]), encodings[i], inputs[j].a, inputs[j].s, inputs[j].b,
+              (encodings[i] >> 11) & 0x1F, (encodings[i] >> 6) & 0x1F, (encodings[i] >> 1) & 0x1F,
+              result, cr0, expected, expected_cr0);
+    }
+  }
+}
+
+// Every sh, mb and me of rlwimi and rlwinm and every mb and me of rlwnm, with and without Rc,
+// generated at runtime
+static void rlwSweepTest()
+{
+  START_TEST();
+
+  static const u32 values[] = {
+      0xFFFFFFFF, 0x44444444, 0x41414141, 0x12345678,
+      0x90ABCDEF, 0x00000000, 0x80000000, 0x00000001,
+  };
+  static const u32 initial_a_values[] = {0x41414141, 0xFFFFFFFF, 0x00000000};
+
+  // rlwnm only uses the low 5 bits of rB
+  static const u32 shift_values[] = {0, 1, 7, 15, 16, 31, 32, 0xFFFFFFE5};
+
+  constexpr u32 num_values = sizeof(values) / sizeof(values[0]);
+  constexpr u32 num_initial_a = sizeof(initial_a_values) / sizeof(initial_a_values[0]);
+  constexpr u32 num_shifts = sizeof(shift_values) / sizeof(shift_values[0]);
+
+  static RlwInputs immediate_inputs[num_values * num_initial_a];
+  static RlwInputs register_inputs[num_values * num_shifts];
+  for (u32 i = 0; i < num_values; ++i)
+  {
+    for (u32 j = 0; j < num_initial_a; ++j)
+      immediate_inputs[i * num_initial_a + j] = {values[i], initial_a_values[j], 0};
+    for (u32 j = 0; j < num_shifts; ++j)
+      register_inputs[i * num_shifts + j] = {values[i], 0x41414141, shift_values[j]};
+  }
+
+  CodeBuffer code(6 + SWEEP_BATCH_SIZE * SWEEP_WORDS_PER_ENCODING + 1);
+  static u32 encodings[SWEEP_BATCH_SIZE];
+
+  for (u32 opcode : {OPCODE_RLWIMI, OPCODE_RLWINM})
+  {
+    // sh, mb, me and Rc make up the low 16 bits of the index
+    for (u32 batch = 0; batch < 0x10000; batch += SWEEP_BATCH_SIZE)
+    {
+      for (u32 i = 0; i < SWEEP_BATCH_SIZE; ++i)
+      {
+        const u32 index = batch + i;
+        encodings[i] = Gekko::MForm(opcode, SWEEP_RS, SWEEP_RA, index >> 11, (index >> 6) & 0x1F,
+                                    (index >> 1) & 0x1F, index & 1);
+      }
+      CheckSweepBatch(code, encodings, SWEEP_BATCH_SIZE, immediate_inputs,
+                      num_values * num_initial_a);
+    }
+
+    network_printf("Progress: opcode %u done\n", opcode);
+    WPAD_ScanPads();
+    if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
+    {
+      END_TEST();
+      return;
+    }
+  }
+
+  for (u32 i = 0; i < 0x800; ++i)
+  {
+    encodings[i] = Gekko::RLWNM(SWEEP_RA, SWEEP_RS, SWEEP_RB, (i >> 6) & 0x1F, (i >> 1) & 0x1F,
+                                i & 1);
+  }
+  CheckSweepBatch(code, encodings, 0x800, register_inputs, num_values * num_shifts);
+
+  DO_TEST(!code.Overflowed(), "Generated code did not fit in {} instructions", code.Capacity());
+
+  END_TEST();
+}
+
 int main()
 {
   network_init();
+  WPAD_Init();
 
   rlwimixTest();
   rlwinmxTest();
   rlwnmxTest();
+  rlwSweepTest();
 
   network_printf("Shutting down...\n");
   network_shutdown();
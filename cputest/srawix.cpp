@@ -1,7 +1,7 @@
 #include <gctypes.h>
 #include <limits.h>
-#include <stdlib.h>
 #include <wiiuse/wpad.h>
+#include "Common/Random.h"
 #include "Common/hwtests.h"
 
 static int GetCarry(int value, int shift)
@@ -16,7 +16,7 @@ static int GetCarry(int value, int shift)
   {                                                                                                \
     for (int i = 0; i < 0x1000; i++)                                                               \
     {                                                                                              \
-      s32 input = i ? rand() : INT_MIN;                                                            \
+      s32 input = i ? static_cast<s32>(random.Next32()) : INT_MIN;                                 \
       s32 output = input;                                                                          \
       s32 carry = 0;                                                                               \
       asm("srawi %0, %0, %2;"                                                                      \
@@ -36,6 +36,7 @@ int main()
   WPAD_Init();
 
   START_TEST();
+  Random random(GetTestSeed());
   SRAWIX_TEST(0);
   SRAWIX_TEST(1);
   SRAWIX_TEST(2);
@@ -0,0 +1,20 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gxtest/BPMemory.h"
+
+#include "Common/BitUtils.h"
+
+float FogParam0::FloatValue() const
+{
+  // scale mantissa from 11 to 23 bits
+  const u32 integral = (sign << 31) | (exp << 23) | (mant << 12);
+  return Common::BitCast<float>(integral);
+}
+
+float FogParam3::FloatValue() const
+{
+  // scale mantissa from 11 to 23 bits
+  const u32 integral = (c_sign << 31) | (c_exp << 23) | (c_mant << 12);
+  return Common::BitCast<float>(integral);
+}
@@ -7,6 +7,7 @@
 
 //#include "Common.h"
 #include "Common/BitField.h"
+#include "Common/CommonTypes.h"
 
 // Vertex array numbers
 enum
@@ -0,0 +1,117 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Destination of the GX commands that CGX and the gxtest helpers emit.
+// On the console, commands go to the write-gather pipe, and can additionally be captured into
+// memory. On the host, they're always captured, which lets the command stream of the helpers be
+// checked and measured without a console (see tools/cgx_stream_check.cpp).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+
+#ifdef GEKKO
+#include <ogc/cache.h>
+#include <ogc/gx.h>
+#include <ogc/system.h>
+#endif
+
+typedef float f32;
+
+class CGXCommandSink
+{
+public:
+  void U8(u8 value)
+  {
+#ifdef GEKKO
+    wgPipe->U8 = value;
+#endif
+    if (capturing)
+      capture.push_back(value);
+  }
+
+  void S8(s8 value) { U8(static_cast<u8>(value)); }
+
+  void U16(u16 value)
+  {
+#ifdef GEKKO
+    wgPipe->U16 = value;
+#endif
+    if (capturing)
+    {
+      capture.push_back(value >> 8);
+      capture.push_back(value & 0xff);
+    }
+  }
+
+  void U32(u32 value)
+  {
+#ifdef GEKKO
+    wgPipe->U32 = value;
+#endif
+    if (capturing)
+    {
+      capture.push_back(value >> 24);
+      capture.push_back((value >> 16) & 0xff);
+      capture.push_back((value >> 8) & 0xff);
+      capture.push_back(value & 0xff);
+    }
+  }
+
+  void F32(f32 value) { U32(Common::BitCast<u32>(value)); }
+
+  // Makes the GPU run the commands at list, after flushing them from the data cache
+  void CallDisplayList(const void* list, u32 size)
+  {
+#ifdef GEKKO
+    DCFlushRange(const_cast<void*>(list), size);
+#endif
+    U8(0x40);
+    U32(GetGPUAddress(list));
+    U32(size);
+  }
+
+  // The physical address the GPU knows memory by
+  static u32 GetGPUAddress(const void* ptr)
+  {
+#ifdef GEKKO
+    return MEM_VIRTUAL_TO_PHYSICAL(ptr);
+#else
+    // There's no GPU memory on the host, the captured address only identifies the memory
+    return static_cast<u32>(reinterpret_cast<std::uintptr_t>(ptr));
+#endif
+  }
+
+  // Adds commands that reached the GPU some other way to the capture
+  void Capture(const u8* data, size_t size)
+  {
+    if (capturing)
+      capture.insert(capture.end(), data, data + size);
+  }
+
+  // On the console, capturing starts out disabled
+  void StartCapture() { capturing = true; }
+  void StopCapture() { capturing = IsHost(); }
+  const std::vector<u8>& GetCapture() const { return capture; }
+  void ClearCapture() { capture.clear(); }
+
+private:
+  static constexpr bool IsHost()
+  {
+#ifdef GEKKO
+    return false;
+#else
+    return true;
+#endif
+  }
+
+  std::vector<u8> capture;
+  bool capturing = IsHost();
+};
+
+extern CGXCommandSink cgx_sink;
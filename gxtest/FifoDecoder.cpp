@@ -0,0 +1,692 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gxtest/FifoDecoder.h"
+
+#include <cstring>
+#include <fmt/format.h>
+
+#include "Common/BitUtils.h"
+#include "gxtest/BPMemory.h"
+#include "gxtest/CPMemory.h"
+
+static u16 ReadU16(const u8* data)
+{
+  return static_cast<u16>((data[0] << 8) | data[1]);
+}
+
+static u32 ReadU32(const u8* data)
+{
+  return (u32{data[0]} << 24) | (u32{data[1]} << 16) | (u32{data[2]} << 8) | data[3];
+}
+
+FifoDecoder::FifoDecoder(FifoHandler& handler) : handler(handler)
+{
+}
+
+size_t FifoDecoder::Decode(const u8* data, size_t size)
+{
+  size_t offset = 0;
+  while (!failed && offset < size)
+  {
+    const u8* command = data + offset;
+    const size_t available = size - offset;
+    const u8 opcode = command[0];
+
+    if (opcode == GX_CMD_NOP)
+    {
+      handler.OnNop();
+      offset += 1;
+    }
+    else if (opcode == GX_CMD_LOAD_CP_REG)
+    {
+      if (available < 6)
+        break;
+      const u8 addr = command[1];
+      const u32 value = ReadU32(command + 2);
+      UpdateVertexFormat(addr, value);
+      handler.OnCP(addr, value);
+      offset += 6;
+    }
+    else if (opcode == GX_CMD_LOAD_XF_REGS)
+    {
+      if (available < 5)
+        break;
+      const u32 header = ReadU32(command + 1);
+      const u32 count = (header >> 16) + 1;
+      if (available < 5 + 4 * count)
+        break;
+
+      xf_values.resize(count);
+      for (u32 i = 0; i < count; ++i)
+        xf_values[i] = ReadU32(command + 5 + 4 * i);
+      handler.OnXF(header & 0xffff, xf_values.data(), count);
+      offset += 5 + 4 * count;
+    }
+    else if (opcode == GX_CMD_LOAD_INDEXED_A || opcode == GX_CMD_LOAD_INDEXED_B ||
+             opcode == GX_CMD_LOAD_INDEXED_C || opcode == GX_CMD_LOAD_INDEXED_D)
+    {
+      if (available < 5)
+        break;
+      handler.OnLoadIndexed(opcode, ReadU32(command + 1));
+      offset += 5;
+    }
+    else if (opcode == GX_CMD_CALL_DISPLAY_LIST)
+    {
+      if (available < 9)
+        break;
+      handler.OnCallDisplayList(ReadU32(command + 1), ReadU32(command + 5));
+      offset += 9;
+    }
+    else if (opcode == GX_CMD_INVALIDATE_VERTEX_CACHE)
+    {
+      handler.OnInvalidateVertexCache();
+      offset += 1;
+    }
+    else if (opcode == GX_CMD_LOAD_BP_REG)
+    {
+      if (available < 5)
+        break;
+      handler.OnBP(ReadU32(command + 1));
+      offset += 5;
+    }
+    else if (opcode >= GX_CMD_DRAW && opcode < 0xc0)
+    {
+      if (available < 3)
+        break;
+      const u16 num_vertices = ReadU16(command + 1);
+      const u32 vertex_size = GetVertexSize(opcode & 7);
+      const size_t data_size = size_t{num_vertices} * vertex_size;
+      if (available < 3 + data_size)
+        break;
+      handler.OnDraw(opcode, num_vertices, vertex_size, command + 3);
+      offset += 3 + data_size;
+    }
+    else
+    {
+      handler.OnUnknown(opcode);
+      failed = true;
+    }
+  }
+  return offset;
+}
+
+static u32 GetComponentSize(u32 format)
+{
+  switch (format)
+  {
+  case VA_FMT_U8:
+  case VA_FMT_S8:
+    return 1;
+  case VA_FMT_U16:
+  case VA_FMT_S16:
+    return 2;
+  default:
+    return 4;
+  }
+}
+
+static u32 GetIndexSize(u32 desc)
+{
+  return desc == VTXATTR_INDEX8 ? 1 : desc == VTXATTR_INDEX16 ? 2 : 0;
+}
+
+static u32 GetColorSize(u32 format)
+{
+  switch (format)
+  {
+  case VA_FMT_RGB565:
+  case VA_FMT_RGBA4:
+    return 2;
+  case VA_FMT_RGB8:
+  case VA_FMT_RGBA6:
+    return 3;
+  default:
+    return 4;
+  }
+}
+
+void FifoDecoder::UpdateVertexFormat(u8 addr, u32 value)
+{
+  // The VCD is split between two registers, the texture coordinates are in the second one
+  if ((addr & 0xf0) == 0x50)
+    vtx_desc = (vtx_desc & ~u64{0x1ffff}) | (value & 0x1ffff);
+  else if ((addr & 0xf0) == 0x60)
+    vtx_desc = (vtx_desc & 0x1ffff) | (u64{value} << 17);
+  else if ((addr & 0xf0) == 0x70)
+    vat_a[addr & 7] = value;
+  else if ((addr & 0xf0) == 0x80)
+    vat_b[addr & 7] = value;
+  else if ((addr & 0xf0) == 0x90)
+    vat_c[addr & 7] = value;
+}
+
+void FifoDecoder::LoadCPState(const u32* cp_mem)
+{
+  UpdateVertexFormat(0x50, cp_mem[0x50]);
+  UpdateVertexFormat(0x60, cp_mem[0x60]);
+  for (u8 vat = 0; vat < 8; ++vat)
+  {
+    UpdateVertexFormat(0x70 | vat, cp_mem[0x70 | vat]);
+    UpdateVertexFormat(0x80 | vat, cp_mem[0x80 | vat]);
+    UpdateVertexFormat(0x90 | vat, cp_mem[0x90 | vat]);
+  }
+}
+
+u32 FifoDecoder::GetVertexSize(u8 vat) const
+{
+  TVtxDesc desc;
+  desc.Hex = vtx_desc;
+  UVAT_group0 g0;
+  g0.Hex = vat_a[vat];
+  UVAT_group1 g1;
+  g1.Hex = vat_b[vat];
+  UVAT_group2 g2;
+  g2.Hex = vat_c[vat];
+
+  // One byte per matrix index
+  u32 size = 0;
+  for (u32 i = 0; i < 9; ++i)
+    size += (vtx_desc >> i) & 1;
+
+  if (desc.Position == VTXATTR_DIRECT)
+    size += (g0.PosElements ? 3 : 2) * GetComponentSize(g0.PosFormat);
+  else
+    size += GetIndexSize(desc.Position);
+
+  // With NBT, there are three normals, which can also have an index each
+  if (desc.Normal == VTXATTR_DIRECT)
+    size += (g0.NormalElements ? 9 : 3) * GetComponentSize(g0.NormalFormat);
+  else
+    size += (g0.NormalElements && g0.NormalIndex3 ? 3 : 1) * GetIndexSize(desc.Normal);
+
+  const u32 color_desc[2] = {static_cast<u32>(desc.Color0), static_cast<u32>(desc.Color1)};
+  const u32 color_comp[2] = {g0.Color0Comp, g0.Color1Comp};
+  for (u32 i = 0; i < 2; ++i)
+  {
+    if (color_desc[i] == VTXATTR_DIRECT)
+      size += GetColorSize(color_comp[i]);
+    else
+      size += GetIndexSize(color_desc[i]);
+  }
+
+  u32 tex_desc[8];
+  for (u32 i = 0; i < 8; ++i)
+    tex_desc[i] = (vtx_desc >> (17 + 2 * i)) & 3;
+  const u32 tex_elements[8] = {g0.Tex0CoordElements, g1.Tex1CoordElements, g1.Tex2CoordElements,
+                               g1.Tex3CoordElements, g1.Tex4CoordElements, g2.Tex5CoordElements,
+                               g2.Tex6CoordElements, g2.Tex7CoordElements};
+  const u32 tex_format[8] = {g0.Tex0CoordFormat, g1.Tex1CoordFormat, g1.Tex2CoordFormat,
+                             g1.Tex3CoordFormat, g1.Tex4CoordFormat, g2.Tex5CoordFormat,
+                             g2.Tex6CoordFormat, g2.Tex7CoordFormat};
+  for (u32 i = 0; i < 8; ++i)
+  {
+    if (tex_desc[i] == VTXATTR_DIRECT)
+      size += (tex_elements[i] ? 2 : 1) * GetComponentSize(tex_format[i]);
+    else
+      size += GetIndexSize(tex_desc[i]);
+  }
+
+  return size;
+}
+
+std::string GetBPRegName(u8 addr)
+{
+  static const char* const TEX_UNIT_REGS[] = {"TexMode0", "TexMode1", "TexImage0", "TexImage1",
+                                              "TexImage2", "TexImage3", "TexTLUT", "Unknown"};
+
+  if (addr >= BPMEM_DISPLAYCOPYFILTER && addr < BPMEM_DISPLAYCOPYFILTER + 4)
+    return fmt::format("Display copy filter {}", addr - BPMEM_DISPLAYCOPYFILTER);
+  if (addr >= BPMEM_IND_MTXA && addr < BPMEM_IND_MTXA + 9)
+  {
+    static const char* const IND_MTX_REGS[] = {"A", "B", "C"};
+    const u32 index = addr - BPMEM_IND_MTXA;
+    return fmt::format("Indirect matrix {} {}", index / 3, IND_MTX_REGS[index % 3]);
+  }
+  if (addr >= BPMEM_IND_CMD && addr < BPMEM_IND_CMD + 16)
+    return fmt::format("TEV stage {} indirect", addr - BPMEM_IND_CMD);
+  if (addr >= BPMEM_TREF && addr < BPMEM_TREF + 8)
+    return fmt::format("TEV stages {} and {} orders", (addr - BPMEM_TREF) * 2,
+                       (addr - BPMEM_TREF) * 2 + 1);
+  if (addr >= BPMEM_SU_SSIZE && addr < BPMEM_SU_SSIZE + 16)
+    return fmt::format("Tex coord {} {} size", (addr - BPMEM_SU_SSIZE) / 2, addr & 1 ? "T" : "S");
+  if (addr >= BPMEM_TX_SETMODE0 && addr < BPMEM_TX_SETMODE0 + 0x40)
+  {
+    const u32 unit = (addr & 3) + ((addr & 0x20) ? 4 : 0);
+    return fmt::format("Texture unit {} {}", unit, TEX_UNIT_REGS[(addr >> 2) & 7]);
+  }
+  if (addr >= BPMEM_TEV_COLOR_ENV && addr < BPMEM_TEV_COLOR_ENV + 32)
+    return fmt::format("TEV stage {} {} combiner", (addr - BPMEM_TEV_COLOR_ENV) / 2,
+                       addr & 1 ? "alpha" : "color");
+  if (addr >= BPMEM_TEV_COLOR_RA && addr < BPMEM_TEV_COLOR_RA + 8)
+    return fmt::format("TEV register {} {}", (addr - BPMEM_TEV_COLOR_RA) / 2,
+                       addr & 1 ? "BG" : "RA");
+  if (addr > BPMEM_FOGRANGE && addr < BPMEM_FOGPARAM0)
+    return fmt::format("Fog range K{}", addr - BPMEM_FOGRANGE - 1);
+  if (addr >= BPMEM_TEV_KSEL && addr < BPMEM_TEV_KSEL + 8)
+    return fmt::format("TEV konst selection {}", addr - BPMEM_TEV_KSEL);
+
+  switch (addr)
+  {
+  case BPMEM_GENMODE:
+    return "GenMode";
+  case BPMEM_IND_IMASK:
+    return "Indirect mask";
+  case BPMEM_SCISSORTL:
+    return "Scissor top left";
+  case BPMEM_SCISSORBR:
+    return "Scissor bottom right";
+  case BPMEM_LINEPTWIDTH:
+    return "Line and point width";
+  case BPMEM_PERF0_TRI:
+    return "Performance counter 0 (triangles)";
+  case BPMEM_PERF0_QUAD:
+    return "Performance counter 0 (quads)";
+  case BPMEM_RAS1_SS0:
+    return "Indirect tex coord scale 0";
+  case BPMEM_RAS1_SS1:
+    return "Indirect tex coord scale 1";
+  case BPMEM_IREF:
+    return "Indirect tex stage orders";
+  case BPMEM_ZMODE:
+    return "ZMode";
+  case BPMEM_BLENDMODE:
+    return "BlendMode";
+  case BPMEM_CONSTANTALPHA:
+    return "Constant alpha";
+  case BPMEM_ZCOMPARE:
+    return "PE control";
+  case BPMEM_FIELDMASK:
+    return "Field mask";
+  case BPMEM_SETDRAWDONE:
+    return "Draw done";
+  case BPMEM_BUSCLOCK0:
+    return "Bus clock 0";
+  case BPMEM_PE_TOKEN_ID:
+    return "PE token";
+  case BPMEM_PE_TOKEN_INT_ID:
+    return "PE token with interrupt";
+  case BPMEM_EFB_TL:
+    return "EFB copy source top left";
+  case BPMEM_EFB_WH:
+    return "EFB copy source size";
+  case BPMEM_EFB_ADDR:
+    return "EFB copy destination";
+  case BPMEM_MIPMAP_STRIDE:
+    return "EFB copy destination stride";
+  case BPMEM_COPYYSCALE:
+    return "Display copy Y scale";
+  case BPMEM_CLEAR_AR:
+    return "Clear color AR";
+  case BPMEM_CLEAR_GB:
+    return "Clear color GB";
+  case BPMEM_CLEAR_Z:
+    return "Clear Z";
+  case BPMEM_TRIGGER_EFB_COPY:
+    return "EFB copy";
+  case BPMEM_COPYFILTER0:
+    return "Copy filter 0";
+  case BPMEM_COPYFILTER1:
+    return "Copy filter 1";
+  case BPMEM_CLEARBBOX1:
+    return "Bounding box X";
+  case BPMEM_CLEARBBOX2:
+    return "Bounding box Y";
+  case BPMEM_CLEAR_PIXEL_PERF:
+    return "Clear pixel performance counters";
+  case BPMEM_REVBITS:
+    return "Revision bits";
+  case BPMEM_SCISSOROFFSET:
+    return "Scissor offset";
+  case BPMEM_PRELOAD_ADDR:
+    return "TMEM preload address";
+  case BPMEM_PRELOAD_TMEMEVEN:
+    return "TMEM preload even";
+  case BPMEM_PRELOAD_TMEMODD:
+    return "TMEM preload odd";
+  case BPMEM_PRELOAD_MODE:
+    return "TMEM preload";
+  case BPMEM_LOADTLUT0:
+    return "TLUT load source";
+  case BPMEM_LOADTLUT1:
+    return "TLUT load";
+  case BPMEM_TEXINVALIDATE:
+    return "Texture cache invalidate";
+  case BPMEM_PERF1:
+    return "Performance counter 1";
+  case BPMEM_FIELDMODE:
+    return "Field mode";
+  case BPMEM_BUSCLOCK1:
+    return "Bus clock 1";
+  case BPMEM_FOGRANGE:
+    return "Fog range";
+  case BPMEM_FOGPARAM0:
+    return "Fog A";
+  case BPMEM_FOGBMAGNITUDE:
+    return "Fog B magnitude";
+  case BPMEM_FOGBEXPONENT:
+    return "Fog B exponent";
+  case BPMEM_FOGPARAM3:
+    return "Fog C, projection and type";
+  case BPMEM_FOGCOLOR:
+    return "Fog color";
+  case BPMEM_ALPHACOMPARE:
+    return "Alpha test";
+  case BPMEM_BIAS:
+    return "Z texture bias";
+  case BPMEM_ZTEX2:
+    return "Z texture";
+  case BPMEM_BP_MASK:
+    return "BP mask";
+  default:
+    return "Unknown";
+  }
+}
+
+// The register unions of BPMemory.h all fit into the 32 bit value, the address included
+template <typename T>
+static std::string Describe(u32 value)
+{
+  static_assert(sizeof(T) == sizeof(u32));
+  T reg;
+  std::memcpy(&reg, &value, sizeof(u32));
+  return fmt::format("{}", reg);
+}
+
+// Scissor corners have X in the upper half
+static std::string DescribeX12Y12(u32 value)
+{
+  X12Y12 xy;
+  xy.hex = value;
+  return fmt::format("X: {}\nY: {}", xy.x, xy.y);
+}
+
+// EFB copy rectangles and the scissor offset have X in the lower half
+static std::string DescribeX10Y10(u32 value)
+{
+  X10Y10 xy;
+  xy.hex = value;
+  return fmt::format("X: {}\nY: {}", xy.x, xy.y);
+}
+
+std::string DescribeBPReg(u32 value)
+{
+  const u8 addr = value >> 24;
+
+  if (addr >= BPMEM_IND_MTXA && addr < BPMEM_IND_MTXA + 9)
+  {
+    switch ((addr - BPMEM_IND_MTXA) % 3)
+    {
+    case 0:
+      return Describe<IND_MTXA>(value);
+    case 1:
+      return Describe<IND_MTXB>(value);
+    default:
+      return Describe<IND_MTXC>(value);
+    }
+  }
+  if (addr >= BPMEM_IND_CMD && addr < BPMEM_IND_CMD + 16)
+    return Describe<TevStageIndirect>(value);
+  if (addr >= BPMEM_TREF && addr < BPMEM_TREF + 8)
+    return Describe<TwoTevStageOrders>(value);
+  if (addr >= BPMEM_SU_SSIZE && addr < BPMEM_SU_SSIZE + 16)
+    return Describe<TCInfo>(value);
+  if (addr >= BPMEM_TX_SETMODE0 && addr < BPMEM_TX_SETMODE0 + 0x40)
+  {
+    switch ((addr >> 2) & 7)
+    {
+    case 0:
+      return Describe<TexMode0>(value);
+    case 1:
+      return Describe<TexMode1>(value);
+    case 2:
+      return Describe<TexImage0>(value);
+    case 3:
+      return Describe<TexImage1>(value);
+    case 4:
+      return Describe<TexImage2>(value);
+    case 5:
+      return Describe<TexImage3>(value);
+    case 6:
+      return Describe<TexTLUT>(value);
+    default:
+      return "";
+    }
+  }
+  if (addr >= BPMEM_TEV_COLOR_ENV && addr < BPMEM_TEV_COLOR_ENV + 32)
+  {
+    if (addr & 1)
+      return Describe<TevStageCombiner::AlphaCombiner>(value);
+    return Describe<TevStageCombiner::ColorCombiner>(value);
+  }
+  if (addr >= BPMEM_TEV_COLOR_RA && addr < BPMEM_TEV_COLOR_RA + 8)
+  {
+    if (addr & 1)
+      return Describe<TevReg::BG>(value);
+    return Describe<TevReg::RA>(value);
+  }
+  if (addr > BPMEM_FOGRANGE && addr < BPMEM_FOGPARAM0)
+    return Describe<FogRangeKElement>(value);
+  if (addr >= BPMEM_TEV_KSEL && addr < BPMEM_TEV_KSEL + 8)
+    return Describe<TevKSel>(value);
+
+  switch (addr)
+  {
+  case BPMEM_GENMODE:
+    return Describe<GenMode>(value);
+  case BPMEM_SCISSORTL:
+  case BPMEM_SCISSORBR:
+    return DescribeX12Y12(value);
+  case BPMEM_LINEPTWIDTH:
+    return Describe<LPSize>(value);
+  case BPMEM_RAS1_SS0:
+  case BPMEM_RAS1_SS1:
+    return Describe<TEXSCALE>(value);
+  case BPMEM_IREF:
+    return Describe<RAS1_IREF>(value);
+  case BPMEM_ZMODE:
+    return Describe<ZMode>(value);
+  case BPMEM_BLENDMODE:
+    return Describe<BlendMode>(value);
+  case BPMEM_CONSTANTALPHA:
+    return Describe<ConstantAlpha>(value);
+  case BPMEM_ZCOMPARE:
+    return Describe<PEControl>(value);
+  case BPMEM_FIELDMASK:
+    return Describe<FieldMask>(value);
+  case BPMEM_EFB_TL:
+  case BPMEM_EFB_WH:
+  case BPMEM_SCISSOROFFSET:
+    return DescribeX10Y10(value);
+  case BPMEM_EFB_ADDR:
+    return fmt::format("Address: {:08x}", (value & 0xffffff) << 5);
+  case BPMEM_TRIGGER_EFB_COPY:
+    return Describe<UPE_Copy>(value);
+  case BPMEM_PRELOAD_MODE:
+    return Describe<BPU_PreloadTileInfo>(value);
+  case BPMEM_FIELDMODE:
+    return Describe<FieldMode>(value);
+  case BPMEM_FOGRANGE:
+    return Describe<FogRangeParams::RangeBase>(value);
+  case BPMEM_FOGPARAM0:
+    return Describe<FogParam0>(value);
+  case BPMEM_FOGPARAM3:
+    return Describe<FogParam3>(value);
+  case BPMEM_FOGCOLOR:
+    return Describe<FogParams::FogColor>(value);
+  case BPMEM_ALPHACOMPARE:
+    return Describe<AlphaTest>(value);
+  case BPMEM_ZTEX2:
+    return Describe<ZTex2>(value);
+  default:
+    return "";
+  }
+}
+
+std::string GetCPRegName(u8 addr)
+{
+  switch (addr & 0xf0)
+  {
+  case 0x30:
+    return "Matrix index A";
+  case 0x40:
+    return "Matrix index B";
+  case 0x50:
+    return "VCD low";
+  case 0x60:
+    return "VCD high";
+  case 0x70:
+    return fmt::format("VAT {} group 0", addr & 7);
+  case 0x80:
+    return fmt::format("VAT {} group 1", addr & 7);
+  case 0x90:
+    return fmt::format("VAT {} group 2", addr & 7);
+  case 0xa0:
+    return fmt::format("Array {} base", addr & 0xf);
+  case 0xb0:
+    return fmt::format("Array {} stride", addr & 0xf);
+  default:
+    return "Unknown";
+  }
+}
+
+static const char* GetVertexAttributeDesc(u32 desc)
+{
+  static const char* const DESCS[] = {"none", "direct", "index8", "index16"};
+  return DESCS[desc & 3];
+}
+
+std::string DescribeCPReg(u8 addr, u32 value)
+{
+  if ((addr & 0xf0) == 0x50)
+  {
+    TVtxDesc desc;
+    desc.Hex = value;
+    return fmt::format("Matrix indices: {:09b}\nPosition: {}\nNormal: {}\nColor 0: {}\nColor 1: {}",
+                       value & 0x1ff, GetVertexAttributeDesc(desc.Position),
+                       GetVertexAttributeDesc(desc.Normal), GetVertexAttributeDesc(desc.Color0),
+                       GetVertexAttributeDesc(desc.Color1));
+  }
+  if ((addr & 0xf0) == 0x60)
+  {
+    std::string description;
+    for (u32 i = 0; i < 8; ++i)
+    {
+      description += fmt::format("{}Tex coord {}: {}", i ? "\n" : "", i,
+                                 GetVertexAttributeDesc(value >> (2 * i)));
+    }
+    return description;
+  }
+  if ((addr & 0xf0) == 0x70)
+  {
+    UVAT_group0 g0;
+    g0.Hex = value;
+    return fmt::format("Position: {} elements, format {}, frac {}\n"
+                       "Normal: {} elements, format {}\n"
+                       "Color 0: {} elements, format {}\n"
+                       "Color 1: {} elements, format {}\n"
+                       "Tex coord 0: {} elements, format {}, frac {}\n"
+                       "Byte dequant: {}\n"
+                       "Normal index 3: {}",
+                       g0.PosElements, g0.PosFormat, g0.PosFrac, g0.NormalElements,
+                       g0.NormalFormat, g0.Color0Elements, g0.Color0Comp, g0.Color1Elements,
+                       g0.Color1Comp, g0.Tex0CoordElements, g0.Tex0CoordFormat, g0.Tex0Frac,
+                       g0.ByteDequant, g0.NormalIndex3);
+  }
+  return "";
+}
+
+std::string GetXFRegName(u16 addr)
+{
+  static const char* const VIEWPORT_REGS[] = {"Viewport scale X",  "Viewport scale Y",
+                                              "Viewport scale Z",  "Viewport offset X",
+                                              "Viewport offset Y", "Viewport offset Z"};
+
+  if (addr < 0x100)
+    return fmt::format("Position/texture matrix {} row {}", addr / 12, addr % 12 / 4);
+  if (addr >= 0x400 && addr < 0x460)
+    return fmt::format("Normal matrix {} row {}", (addr - 0x400) / 9, (addr - 0x400) % 9 / 3);
+  if (addr >= 0x500 && addr < 0x600)
+    return fmt::format("Post-transform matrix {} row {}", (addr - 0x500) / 12,
+                       (addr - 0x500) % 12 / 4);
+  if (addr >= 0x600 && addr < 0x680)
+    return fmt::format("Light {} word {}", (addr - 0x600) / 16, (addr - 0x600) % 16);
+  if (addr >= 0x101a && addr < 0x1020)
+    return VIEWPORT_REGS[addr - 0x101a];
+  if (addr >= 0x1020 && addr < 0x1026)
+    return fmt::format("Projection parameter {}", addr - 0x1020);
+  if (addr >= 0x100e && addr < 0x1012)
+    return fmt::format("{} channel {} control", addr < 0x1010 ? "Color" : "Alpha", addr & 1);
+  if (addr >= 0x1040 && addr < 0x1048)
+    return fmt::format("Tex gen {}", addr - 0x1040);
+  if (addr >= 0x1050 && addr < 0x1058)
+    return fmt::format("Post-transform tex gen {}", addr - 0x1050);
+
+  switch (addr)
+  {
+  case 0x1000:
+    return "Error";
+  case 0x1001:
+    return "Diagnostics";
+  case 0x1002:
+    return "State 0";
+  case 0x1003:
+    return "State 1";
+  case 0x1004:
+    return "Clock";
+  case 0x1005:
+    return "Clip disable";
+  case 0x1006:
+    return "Performance 0";
+  case 0x1007:
+    return "Performance 1";
+  case 0x1008:
+    return "Input vertex spec";
+  case 0x1009:
+    return "Num color channels";
+  case 0x100a:
+    return "Channel 0 ambient color";
+  case 0x100b:
+    return "Channel 1 ambient color";
+  case 0x100c:
+    return "Channel 0 material color";
+  case 0x100d:
+    return "Channel 1 material color";
+  case 0x1018:
+    return "Matrix index A";
+  case 0x1019:
+    return "Matrix index B";
+  case 0x1026:
+    return "Projection type";
+  case 0x103f:
+    return "Num tex gens";
+  default:
+    return "Unknown";
+  }
+}
+
+std::string DescribeXFReg(u16 addr, u32 value)
+{
+  // Matrices, lights (past their color), the viewport and the projection are floats
+  const bool is_float = addr < 0x600 || (addr >= 0x600 && addr < 0x680 && (addr & 0xf) >= 4) ||
+                        (addr >= 0x101a && addr < 0x1026);
+  if (is_float)
+    return fmt::format("{}", Common::BitCast<float>(value));
+
+  if (addr >= 0x100e && addr < 0x1012)
+  {
+    return fmt::format("Material source: {}\nLighting: {}\nLight mask: {:08b}\n"
+                       "Ambient source: {}\nDiffuse function: {}\nAttenuation function: {}",
+                       value & 1, (value >> 1) & 1, ((value >> 2) & 0xf) | ((value >> 7) & 0xf0),
+                       (value >> 6) & 1, (value >> 7) & 3, (value >> 9) & 3);
+  }
+  return "";
+}
+
+const char* GetPrimitiveName(u8 command)
+{
+  static const char* const PRIMITIVES[] = {"Quads",          "Quads (alternative)", "Triangles",
+                                           "Triangle strip", "Triangle fan",        "Lines",
+                                           "Line strip",     "Points"};
+  return PRIMITIVES[(command >> 3) & 7];
+}
@@ -0,0 +1,100 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Decoder for GX command streams, like the ones cgx_sink captures. It splits the stream into
+// commands and hands them to a FifoHandler. The size of the vertex data of draws depends on the
+// VCD and VAT registers, which the decoder keeps track of from the CP loads it sees.
+// Nothing here depends on the console, it's meant for host tools (see tools/fifo_trace.cpp).
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Command opcodes, the draws also carry the primitive and the VAT index
+enum
+{
+  GX_CMD_NOP = 0x00,
+  GX_CMD_LOAD_CP_REG = 0x08,
+  GX_CMD_LOAD_XF_REGS = 0x10,
+  GX_CMD_LOAD_INDEXED_A = 0x20,
+  GX_CMD_LOAD_INDEXED_B = 0x28,
+  GX_CMD_LOAD_INDEXED_C = 0x30,
+  GX_CMD_LOAD_INDEXED_D = 0x38,
+  GX_CMD_CALL_DISPLAY_LIST = 0x40,
+  GX_CMD_INVALIDATE_VERTEX_CACHE = 0x48,
+  GX_CMD_LOAD_BP_REG = 0x61,
+  GX_CMD_DRAW = 0x80,  // 0x80 + (primitive << 3) + VAT index, up to 0xbf
+};
+
+class FifoHandler
+{
+public:
+  virtual ~FifoHandler() = default;
+
+  virtual void OnNop() {}
+  virtual void OnBP(u32 /*value*/) {}
+  virtual void OnCP(u8 /*addr*/, u32 /*value*/) {}
+  // values are in host byte order
+  virtual void OnXF(u16 /*addr*/, const u32* /*values*/, u32 /*count*/) {}
+  virtual void OnLoadIndexed(u8 /*command*/, u32 /*value*/) {}
+  virtual void OnCallDisplayList(u32 /*address*/, u32 /*size*/) {}
+  virtual void OnInvalidateVertexCache() {}
+  // vertices points to the raw vertex data, num_vertices * vertex_size bytes of it
+  virtual void OnDraw(u8 /*command*/, u16 /*num_vertices*/, u32 /*vertex_size*/,
+                      const u8* /*vertices*/)
+  {
+  }
+  // The rest of the stream can't be decoded after an unknown command, so decoding stops there
+  virtual void OnUnknown(u8 /*command*/) {}
+};
+
+class FifoDecoder
+{
+public:
+  explicit FifoDecoder(FifoHandler& handler);
+
+  // Decodes the complete commands at the start of data and returns how many bytes they took.
+  // The rest has to be passed again, followed by more data, once it's available.
+  // After an unknown command, nothing more is decoded and the return value is always 0.
+  size_t Decode(const u8* data, size_t size);
+
+  bool Failed() const { return failed; }
+
+  // Size of a vertex with the given VAT, according to the CP loads decoded so far
+  u32 GetVertexSize(u8 vat) const;
+
+  // Sets the VCD and VAT registers as if cp_mem (indexed by CP address, like the registers a FIFO
+  // log starts with) had been loaded
+  void LoadCPState(const u32* cp_mem);
+
+private:
+  void UpdateVertexFormat(u8 addr, u32 value);
+
+  FifoHandler& handler;
+  bool failed = false;
+
+  u64 vtx_desc = 0;
+  u32 vat_a[8] = {};
+  u32 vat_b[8] = {};
+  u32 vat_c[8] = {};
+
+  std::vector<u32> xf_values;
+};
+
+// Name of a register, e.g. "GenMode" or "Viewport scale X"
+std::string GetBPRegName(u8 addr);
+std::string GetCPRegName(u8 addr);
+std::string GetXFRegName(u16 addr);
+
+// Value of a register, decoded through the formatters of BPMemory.h where there is one. Multiple
+// fields are put on separate lines.
+std::string DescribeBPReg(u32 value);
+std::string DescribeCPReg(u8 addr, u32 value);
+std::string DescribeXFReg(u16 addr, u32 value);
+
+// Name of the primitive of a draw command
+const char* GetPrimitiveName(u8 command);
@@ -0,0 +1,196 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gxtest/FifoLog.h"
+
+#include <cstring>
+
+// Layout of Dolphin's FifoDataFile, version 5
+constexpr u32 FILE_ID = 0x0d01f1f0;
+constexpr u32 FILE_VERSION = 5;
+constexpr u32 MIN_LOADER_VERSION = 1;
+constexpr u32 FLAG_IS_WII = 1;
+constexpr u32 MEM1_SIZE = 0x01800000;
+constexpr u32 MEM2_SIZE = 0x04000000;
+
+constexpr size_t HEADER_SIZE = 128;
+constexpr size_t FRAME_INFO_SIZE = 64;
+constexpr size_t MEMORY_UPDATE_SIZE = 24;
+
+// Offsets of the fields. Dolphin packs the structs to 4 bytes, so u64 fields aren't 8-aligned.
+constexpr size_t HEADER_FILE_ID = 0;
+constexpr size_t HEADER_FILE_VERSION = 4;
+constexpr size_t HEADER_MIN_LOADER_VERSION = 8;
+constexpr size_t HEADER_BP_MEM = 12;  // offset (u64) and size (u32) for each array
+constexpr size_t HEADER_CP_MEM = 24;
+constexpr size_t HEADER_XF_MEM = 36;
+constexpr size_t HEADER_XF_REGS = 48;
+constexpr size_t HEADER_FRAME_LIST = 60;
+constexpr size_t HEADER_FLAGS = 72;
+constexpr size_t HEADER_TEX_MEM = 76;
+constexpr size_t HEADER_MEM1_SIZE = 88;
+constexpr size_t HEADER_MEM2_SIZE = 92;
+
+constexpr size_t FRAME_FIFO_DATA_OFFSET = 0;
+constexpr size_t FRAME_FIFO_DATA_SIZE = 8;
+constexpr size_t FRAME_FIFO_START = 12;
+constexpr size_t FRAME_FIFO_END = 16;
+constexpr size_t FRAME_MEMORY_UPDATES_OFFSET = 20;
+constexpr size_t FRAME_NUM_MEMORY_UPDATES = 28;
+
+constexpr size_t UPDATE_FIFO_POSITION = 0;
+constexpr size_t UPDATE_ADDRESS = 4;
+constexpr size_t UPDATE_DATA_OFFSET = 8;
+constexpr size_t UPDATE_DATA_SIZE = 16;
+constexpr size_t UPDATE_TYPE = 20;
+
+static void PutU32(std::vector<u8>& file, size_t offset, u32 value)
+{
+  for (int i = 0; i < 4; ++i)
+    file[offset + i] = static_cast<u8>(value >> (8 * i));
+}
+
+static void PutU64(std::vector<u8>& file, size_t offset, u64 value)
+{
+  PutU32(file, offset, static_cast<u32>(value));
+  PutU32(file, offset + 4, static_cast<u32>(value >> 32));
+}
+
+static u32 GetU32(const u8* data, size_t offset)
+{
+  return u32{data[offset]} | (u32{data[offset + 1]} << 8) | (u32{data[offset + 2]} << 16) |
+         (u32{data[offset + 3]} << 24);
+}
+
+static u64 GetU64(const u8* data, size_t offset)
+{
+  return GetU32(data, offset) | (u64{GetU32(data, offset + 4)} << 32);
+}
+
+// Appends an array of u32 and puts its offset and size into the header
+static void AppendArray(std::vector<u8>& file, size_t header_field, const u32* values, u32 count)
+{
+  const size_t offset = file.size();
+  file.resize(offset + 4 * count);
+  for (u32 i = 0; i < count; ++i)
+    PutU32(file, offset + 4 * i, values[i]);
+
+  PutU64(file, header_field, offset);
+  PutU32(file, header_field + 8, count * 4);
+}
+
+std::vector<u8> SerializeFifoLog(const FifoLog& log)
+{
+  std::vector<u8> file(HEADER_SIZE + FRAME_INFO_SIZE);
+  PutU32(file, HEADER_FILE_ID, FILE_ID);
+  PutU32(file, HEADER_FILE_VERSION, FILE_VERSION);
+  PutU32(file, HEADER_MIN_LOADER_VERSION, MIN_LOADER_VERSION);
+  PutU32(file, HEADER_FLAGS, FLAG_IS_WII);
+  PutU32(file, HEADER_MEM1_SIZE, MEM1_SIZE);
+  PutU32(file, HEADER_MEM2_SIZE, MEM2_SIZE);
+
+  // The frame list only has one frame, right after the header
+  PutU64(file, HEADER_FRAME_LIST, HEADER_SIZE);
+  PutU32(file, HEADER_FRAME_LIST + 8, 1);
+
+  const FifoLogRegisters& regs = log.registers;
+  AppendArray(file, HEADER_BP_MEM, regs.bp_mem, FIFO_LOG_BP_MEM_SIZE);
+  AppendArray(file, HEADER_CP_MEM, regs.cp_mem, FIFO_LOG_CP_MEM_SIZE);
+  AppendArray(file, HEADER_XF_MEM, regs.xf_mem, FIFO_LOG_XF_MEM_SIZE);
+  AppendArray(file, HEADER_XF_REGS, regs.xf_regs, FIFO_LOG_XF_REGS_SIZE);
+  // TMEM isn't known, the texture memory array stays empty
+
+  const size_t frame = HEADER_SIZE;
+  PutU64(file, frame + FRAME_FIFO_DATA_OFFSET, file.size());
+  PutU32(file, frame + FRAME_FIFO_DATA_SIZE, static_cast<u32>(log.fifo_data.size()));
+  PutU32(file, frame + FRAME_FIFO_START, log.fifo_start);
+  PutU32(file, frame + FRAME_FIFO_END, log.fifo_end);
+  file.insert(file.end(), log.fifo_data.begin(), log.fifo_data.end());
+
+  const size_t update_list = file.size();
+  PutU64(file, frame + FRAME_MEMORY_UPDATES_OFFSET, update_list);
+  PutU32(file, frame + FRAME_NUM_MEMORY_UPDATES, static_cast<u32>(log.memory_updates.size()));
+  file.resize(update_list + log.memory_updates.size() * MEMORY_UPDATE_SIZE);
+
+  for (size_t i = 0; i < log.memory_updates.size(); ++i)
+  {
+    const FifoLogMemoryUpdate& update = log.memory_updates[i];
+    const size_t entry = update_list + i * MEMORY_UPDATE_SIZE;
+    PutU32(file, entry + UPDATE_FIFO_POSITION, update.fifo_position);
+    PutU32(file, entry + UPDATE_ADDRESS, update.address);
+    PutU64(file, entry + UPDATE_DATA_OFFSET, file.size());
+    PutU32(file, entry + UPDATE_DATA_SIZE, static_cast<u32>(update.data.size()));
+    file[entry + UPDATE_TYPE] = static_cast<u8>(update.type);
+    file.insert(file.end(), update.data.begin(), update.data.end());
+  }
+
+  return file;
+}
+
+static bool ReadArray(const u8* data, size_t size, size_t header_field, u32* values, u32 count)
+{
+  const u64 offset = GetU64(data, header_field);
+  const u32 num_bytes = GetU32(data, header_field + 8);
+  if (num_bytes > count * 4 || offset > size || size - offset < num_bytes)
+    return false;
+
+  std::memset(values, 0, count * 4);
+  for (u32 i = 0; i < num_bytes / 4; ++i)
+    values[i] = GetU32(data, offset + 4 * i);
+  return true;
+}
+
+bool IsFifoLog(const u8* data, size_t size)
+{
+  return size >= 4 && GetU32(data, HEADER_FILE_ID) == FILE_ID;
+}
+
+bool ParseFifoLog(const u8* data, size_t size, FifoLog* log)
+{
+  if (size < HEADER_SIZE || !IsFifoLog(data, size))
+    return false;
+
+  FifoLogRegisters& regs = log->registers;
+  if (!ReadArray(data, size, HEADER_BP_MEM, regs.bp_mem, FIFO_LOG_BP_MEM_SIZE) ||
+      !ReadArray(data, size, HEADER_CP_MEM, regs.cp_mem, FIFO_LOG_CP_MEM_SIZE) ||
+      !ReadArray(data, size, HEADER_XF_MEM, regs.xf_mem, FIFO_LOG_XF_MEM_SIZE) ||
+      !ReadArray(data, size, HEADER_XF_REGS, regs.xf_regs, FIFO_LOG_XF_REGS_SIZE))
+  {
+    return false;
+  }
+
+  const u64 frame = GetU64(data, HEADER_FRAME_LIST);
+  if (GetU32(data, HEADER_FRAME_LIST + 8) == 0 || frame > size || size - frame < FRAME_INFO_SIZE)
+    return false;
+
+  const u64 fifo_offset = GetU64(data, frame + FRAME_FIFO_DATA_OFFSET);
+  const u32 fifo_size = GetU32(data, frame + FRAME_FIFO_DATA_SIZE);
+  if (fifo_offset > size || size - fifo_offset < fifo_size)
+    return false;
+  log->fifo_data.assign(data + fifo_offset, data + fifo_offset + fifo_size);
+  log->fifo_start = GetU32(data, frame + FRAME_FIFO_START);
+  log->fifo_end = GetU32(data, frame + FRAME_FIFO_END);
+
+  const u64 update_list = GetU64(data, frame + FRAME_MEMORY_UPDATES_OFFSET);
+  const u32 num_updates = GetU32(data, frame + FRAME_NUM_MEMORY_UPDATES);
+  if (update_list > size || (size - update_list) / MEMORY_UPDATE_SIZE < num_updates)
+    return false;
+
+  log->memory_updates.resize(num_updates);
+  for (u32 i = 0; i < num_updates; ++i)
+  {
+    const size_t entry = update_list + i * MEMORY_UPDATE_SIZE;
+    FifoLogMemoryUpdate& update = log->memory_updates[i];
+    update.fifo_position = GetU32(data, entry + UPDATE_FIFO_POSITION);
+    update.address = GetU32(data, entry + UPDATE_ADDRESS);
+    update.type = static_cast<FifoLogMemoryType>(data[entry + UPDATE_TYPE]);
+
+    const u64 data_offset = GetU64(data, entry + UPDATE_DATA_OFFSET);
+    const u32 data_size = GetU32(data, entry + UPDATE_DATA_SIZE);
+    if (data_offset > size || size - data_offset < data_size)
+      return false;
+    update.data.assign(data + data_offset, data + data_offset + data_size);
+  }
+
+  return true;
+}
@@ -0,0 +1,66 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// FIFO logs in the format of Dolphin's FIFO player (.dff): the register state at the start, the
+// command stream of one frame, and the memory the GPU reads while running it. The file is
+// little-endian, it's written byte by byte so that the console and the host produce the same file.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+constexpr u32 FIFO_LOG_BP_MEM_SIZE = 0x100;
+constexpr u32 FIFO_LOG_CP_MEM_SIZE = 0x100;
+constexpr u32 FIFO_LOG_XF_MEM_SIZE = 0x1000;
+constexpr u32 FIFO_LOG_XF_REGS_SIZE = 0x58;
+
+// What the memory of an update is, as in Dolphin's MemoryUpdate::Type. EFB copy results are
+// recorded as texture memory, which is what they are to the draws that sample them.
+enum class FifoLogMemoryType : u8
+{
+  TextureMap = 0x01,
+  XFData = 0x02,
+  VertexStream = 0x04,
+  TMEM = 0x08,
+};
+
+// Registers as the FIFO player loads them before the frame. BP values don't include the address,
+// CP values are indexed by their address and XF registers start at 0x1000.
+struct FifoLogRegisters
+{
+  u32 bp_mem[FIFO_LOG_BP_MEM_SIZE];
+  u32 cp_mem[FIFO_LOG_CP_MEM_SIZE];
+  u32 xf_mem[FIFO_LOG_XF_MEM_SIZE];
+  u32 xf_regs[FIFO_LOG_XF_REGS_SIZE];
+};
+
+// data is written to the physical address right before the command at fifo_position
+struct FifoLogMemoryUpdate
+{
+  u32 fifo_position;
+  u32 address;
+  FifoLogMemoryType type;
+  std::vector<u8> data;
+};
+
+struct FifoLog
+{
+  FifoLogRegisters registers;
+  std::vector<u8> fifo_data;
+  std::vector<FifoLogMemoryUpdate> memory_updates;
+  // Physical start and end of the FIFO buffer the commands were recorded from
+  u32 fifo_start = 0;
+  u32 fifo_end = 0;
+};
+
+// Produces a .dff file with the log as its only frame
+std::vector<u8> SerializeFifoLog(const FifoLog& log);
+
+// Whether data starts like a .dff file. Raw command streams never do, 0xf0 isn't a command.
+bool IsFifoLog(const u8* data, size_t size);
+
+// Reads the first frame of a .dff file. Returns false if data isn't a (complete) FIFO log.
+bool ParseFifoLog(const u8* data, size_t size, FifoLog* log);
@@ -11,6 +11,7 @@
 #include <ogc/system.h>
 #include <string.h>
 
+#include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
 #include "gxtest/BPMemory.h"
 #include "gxtest/CPMemory.h"
@@ -41,31 +42,14 @@ GXFifoObj* GX_Init(void* base, u32 size);
 }
 
 static void __CGXFinishInterruptHandler(u32 irq, void* ctx);
+static void __CGXTokenInterruptHandler(u32 irq, void* ctx);
 static vu16* const _peReg = (u16*)0xCC001000;
+static vu32* const _piReg = (u32*)0xCC003000;
 static lwpq_t _cgxwaitfinish;
 static vu32 _cgxfinished = 0;
-
-#define CGX_LOAD_BP_REG(x)                                                                         \
-  do                                                                                               \
-  {                                                                                                \
-    wgPipe->U8 = 0x61;                                                                             \
-    wgPipe->U32 = (u32)(x);                                                                        \
-  } while (0)
-
-#define CGX_LOAD_CP_REG(x, y)                                                                      \
-  do                                                                                               \
-  {                                                                                                \
-    wgPipe->U8 = 0x08;                                                                             \
-    wgPipe->U8 = (u8)(x);                                                                          \
-    wgPipe->U32 = (u32)(y);                                                                        \
-  } while (0)
-
-#define CGX_BEGIN_LOAD_XF_REGS(x, n)                                                               \
-  do                                                                                               \
-  {                                                                                                \
-    wgPipe->U8 = 0x10;                                                                             \
-    wgPipe->U32 = (u32)(((((n)&0xffff) - 1) << 16) | ((x)&0xffff));                                \
-  } while (0)
+static lwpq_t _cgxwaittoken;
+static vu16 _cgxlasttoken = 0;
+static u16 _cgxnexttoken = 0;
 
 void CGX_Init()
 {
@@ -75,59 +59,25 @@ void CGX_Init()
   memset(gp_fifo, 0, 256 * 1024);
 
   GX_Init(gp_fifo, 256 * 1024);
+  CGX_InvalidateShadowRegs();
 
   LWP_InitQueue(&_cgxwaitfinish);
+  LWP_InitQueue(&_cgxwaittoken);
 
   IRQ_Request(IRQ_PI_PEFINISH, __CGXFinishInterruptHandler, NULL);
   __UnmaskIrq(IRQMASK(IRQ_PI_PEFINISH));
+  IRQ_Request(IRQ_PI_PETOKEN, __CGXTokenInterruptHandler, NULL);
+  __UnmaskIrq(IRQMASK(IRQ_PI_PETOKEN));
   _peReg[5] = 0x0F;
 }
 
-void CGX_SetViewport(float origin_x, float origin_y, float width, float height, float near, f32 far)
-{
-  CGX_BEGIN_LOAD_XF_REGS(0x101a, 6);
-  wgPipe->F32 = width * 0.5f;
-  wgPipe->F32 = -height * 0.5f;
-  wgPipe->F32 = (far - near) * 16777215.0f;
-  wgPipe->F32 = 342.0f + origin_x + width * 0.5f;
-  wgPipe->F32 = 342.0f + origin_y + height * 0.5f;
-  wgPipe->F32 = far * 16777215.0f;
-}
-
 void CGX_LoadPosMatrixDirect(f32 mt[3][4], u32 index)
 {
-  // Untested
-  /*	CGX_BEGIN_LOAD_XF_REGS((index<<2)&0xFF, 12);
-    WriteMtxPS4x2(mt, (void*)wgPipe);*/
-  GX_LoadPosMtxImm(mt, index);
-}
-
-void CGX_LoadProjectionMatrixPerspective(float mtx[4][4])
-{
-  // Untested
-  /*	CGX_BEGIN_LOAD_XF_REGS(0x1020, 7);
-    wgPipe->F32 = mtx[0][0];
-    wgPipe->F32 = mtx[0][2];
-    wgPipe->F32 = mtx[1][1];
-    wgPipe->F32 = mtx[1][2];
-    wgPipe->F32 = mtx[2][2];
-    wgPipe->F32 = mtx[2][3];
-    wgPipe->U32 = 0;*/
-  GX_LoadProjectionMtx(mtx, 0);
-}
-
-void CGX_LoadProjectionMatrixOrthographic(float mtx[4][4])
-{
-  // Untested
-  /*	CGX_BEGIN_LOAD_XF_REGS(0x1020, 7);
-    wgPipe->F32 = mtx[0][0];
-    wgPipe->F32 = mtx[0][3];
-    wgPipe->F32 = mtx[1][1];
-    wgPipe->F32 = mtx[1][3];
-    wgPipe->F32 = mtx[2][2];
-    wgPipe->F32 = mtx[2][3];
-    wgPipe->U32 = 1;*/
-  GX_LoadProjectionMtx(mtx, 1);
+  // Same as GX_LoadPosMtxImm: index counts rows of 4 values
+  u32 values[12];
+  for (int i = 0; i < 12; ++i)
+    values[i] = Common::BitCast<u32>(mt[i / 4][i % 4]);
+  CGX_LoadXFRegs(index * 4, values, 12);
 }
 
 void CGX_DoEfbCopyTex(u16 left, u16 top, u16 width, u16 height, void* dest, const EFBCopyParams& params)
@@ -171,7 +121,9 @@ void CGX_DoEfbCopyTex(u16 left, u16 top, u16 width, u16 height, void* dest, cons
   reg.auto_conv = params.auto_conv;
   CGX_LOAD_BP_REG(reg.Hex);
 
-  DCInvalidateRange(dest, GX_GetTexBufferSize(width, height, GX_TF_RGBA8, GX_FALSE, 1));
+  const u32 size = GX_GetTexBufferSize(width, height, GX_TF_RGBA8, GX_FALSE, 1);
+  DCInvalidateRange(dest, size);
+  CGX_FifoLogEfbCopy(dest, size);
 }
 
 void CGX_DoEfbCopyXfb(u16 left, u16 top, u16 width, u16 src_height, u16 dst_height, void* dest,
@@ -201,22 +153,68 @@ void CGX_DoEfbCopyXfb(u16 left, u16 top, u16 width, u16 src_height, u16 dst_heig
     CGX_LOAD_BP_REG((BPMEM_MIPMAP_STRIDE<<24) | (width >> 4));
     CGX_LOAD_BP_REG(reg.Hex);*/
 
+  CGX_BeginLibogcCommands();
   GX_SetDispCopySrc(left, top, width, src_height);
   GX_SetDispCopyDst(width, dst_height);
   // SetCopyFilter, SetFieldMode, SetDispCopyGamma
   GX_CopyDisp(dest, clear);
+  CGX_EndLibogcCommands();
+  CGX_InvalidateShadowRegs();
 }
 
-void CGX_ForcePipelineFlush()
+// Physical address bits of the PI FIFO registers, the write pointer also has a wrap bit above
+#define PI_FIFO_ADDRESS_MASK 0x1fffffe0
+
+static u32 _cgxlibogcstart = 0;
+
+// Pushes everything written so far into the FIFO and returns where the next command will go
+static u32 __CGXFlushFifo()
 {
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
-  wgPipe->U32 = 0;
+  CGX_ForcePipelineFlush();
+  ppcsync();
+  return _piReg[5] & PI_FIFO_ADDRESS_MASK;
+}
+
+static u32 __CGXGetFifoBase()
+{
+  return _piReg[3] & PI_FIFO_ADDRESS_MASK;
+}
+
+// The end register has the address of the last word in the FIFO, this is the address after it
+static u32 __CGXGetFifoBufferEnd()
+{
+  return (_piReg[4] & PI_FIFO_ADDRESS_MASK) + 32;
+}
+
+// Adds the commands in the FIFO from start up to end to cgx_sink's capture
+static void __CGXCaptureFifo(u32 start, u32 end)
+{
+  if (end < start)
+  {
+    cgx_sink.Capture((const u8*)MEM_PHYSICAL_TO_K1(start), __CGXGetFifoBufferEnd() - start);
+    start = __CGXGetFifoBase();
+  }
+  cgx_sink.Capture((const u8*)MEM_PHYSICAL_TO_K1(start), end - start);
+}
+
+void CGX_CaptureInitCommands(u32* fifo_start, u32* fifo_end)
+{
+  *fifo_start = __CGXGetFifoBase();
+  *fifo_end = __CGXGetFifoBufferEnd() - 4;
+  // Assumes the FIFO hasn't wrapped around since GX_Init
+  __CGXCaptureFifo(*fifo_start, __CGXFlushFifo());
+}
+
+void CGX_BeginLibogcCommands()
+{
+  if (CGX_FifoLogsEnabled())
+    _cgxlibogcstart = __CGXFlushFifo();
+}
+
+void CGX_EndLibogcCommands()
+{
+  if (CGX_FifoLogsEnabled())
+    __CGXCaptureFifo(_cgxlibogcstart, __CGXFlushFifo());
 }
 
 static void __CGXFinishInterruptHandler([[maybe_unused]] u32 irq, [[maybe_unused]] void* ctx)
@@ -242,6 +240,51 @@ void CGX_WaitForGpuToFinish()
     LWP_ThreadSleep(_cgxwaitfinish);
 
   _CPU_ISR_Restore(level);
+
+  CGX_FifoLogGpuFinished();
+}
+
+static void __CGXTokenInterruptHandler([[maybe_unused]] u32 irq, [[maybe_unused]] void* ctx)
+{
+  // Tokens that arrive in quick succession can share an interrupt, so only the last one counts
+  _cgxlasttoken = _peReg[7];
+  _peReg[5] = (_peReg[5] & ~0x04) | 0x04;
+
+  LWP_ThreadBroadcast(_cgxwaittoken);
+}
+
+u16 CGX_SendToken()
+{
+  u32 level;
+
+  _CPU_ISR_Disable(level);
+  const u16 token = ++_cgxnexttoken;
+  CGX_LOAD_BP_REG((BPMEM_PE_TOKEN_INT_ID << 24) | token);
+  CGX_LOAD_BP_REG((BPMEM_PE_TOKEN_ID << 24) | token);
+  CGX_ForcePipelineFlush();
+  _CPU_ISR_Restore(level);
+
+  CGX_FifoLogToken(token);
+
+  return token;
+}
+
+bool CGX_TokenReached(u16 token)
+{
+  // Tokens wrap around, so compare their distance instead of their values
+  return static_cast<s16>(_cgxlasttoken - token) >= 0;
+}
+
+void CGX_WaitForToken(u16 token)
+{
+  u32 level;
+
+  _CPU_ISR_Disable(level);
+  while (!CGX_TokenReached(token))
+    LWP_ThreadSleep(_cgxwaittoken);
+  _CPU_ISR_Restore(level);
+
+  CGX_FifoLogTokenReached(token);
 }
 
 void CGX_PEPokeAlphaMode(CompareMode func, u8 threshold)
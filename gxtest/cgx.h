@@ -11,10 +11,10 @@
 // They are based directly on Dolphin's register definitions, hence
 // (hopefully) minimizing potential for mistakes.
 
-#include <ogc/gx.h>
-
 #include "Common/CommonTypes.h"
 #include "gxtest/BPMemory.h"
+#include "gxtest/CommandSink.h"
+#include "gxtest/FifoLog.h"
 
 #pragma once
 
@@ -40,26 +40,47 @@ typedef union
 static CWGPipe* const wgPipe = (CWGPipe*)0xCC008000;
 */
 
-#define CGX_LOAD_BP_REG(x)                                                                         \
-  do                                                                                               \
-  {                                                                                                \
-    wgPipe->U8 = 0x61;                                                                             \
-    wgPipe->U32 = (u32)(x);                                                                        \
-  } while (0)
+// BP, CP and XF registers written through these go through a shadow of the last value written
+// to each register, and writes that wouldn't change anything are dropped. Registers whose writes
+// have side effects (triggers, tokens, the TEV color registers, which share addresses with the
+// konst colors, and the register after a BPMEM_BP_MASK write) are always written.
+// Tests that rewrite a register on purpose use the Force variants. Anything that writes registers
+// behind the shadow's back (libogc, raw FIFO writes) must invalidate it afterwards.
+void CGX_LoadBPReg(u32 value);
+void CGX_ForceLoadBPReg(u32 value);
+void CGX_LoadCPReg(u8 addr, u32 value);
+void CGX_ForceLoadCPReg(u8 addr, u32 value);
+void CGX_LoadXFRegs(u16 addr, const u32* values, u32 count);
+void CGX_ForceLoadXFRegs(u16 addr, const u32* values, u32 count);
+void CGX_LoadXFReg(u16 addr, u32 value);
+
+void CGX_InvalidateXFShadow(u16 addr, u32 count);
+void CGX_InvalidateShadowRegs();
+
+struct CGXShadowStats
+{
+  u32 suppressed_bp_writes = 0;
+  u32 suppressed_cp_writes = 0;
+  u32 suppressed_xf_writes = 0;  // in registers, a partially suppressed block counts the rest
+  u32 suppressed_bytes = 0;      // FIFO bytes that weren't sent
+};
 
-#define CGX_LOAD_CP_REG(x, y)                                                                      \
-  do                                                                                               \
-  {                                                                                                \
-    wgPipe->U8 = 0x08;                                                                             \
-    wgPipe->U8 = (u8)(x);                                                                          \
-    wgPipe->U32 = (u32)(y);                                                                        \
-  } while (0)
+const CGXShadowStats& CGX_GetShadowStats();
+void CGX_ResetShadowStats();
 
+#define CGX_LOAD_BP_REG(x) CGX_LoadBPReg((u32)(x))
+#define CGX_FORCE_LOAD_BP_REG(x) CGX_ForceLoadBPReg((u32)(x))
+#define CGX_LOAD_CP_REG(x, y) CGX_LoadCPReg((u8)(x), (u32)(y))
+#define CGX_FORCE_LOAD_CP_REG(x, y) CGX_ForceLoadCPReg((u8)(x), (u32)(y))
+
+// The values that follow this are written raw through cgx_sink, so the shadow forgets the
+// registers they cover
 #define CGX_BEGIN_LOAD_XF_REGS(x, n)                                                               \
   do                                                                                               \
   {                                                                                                \
-    wgPipe->U8 = 0x10;                                                                             \
-    wgPipe->U32 = (u32)(((((n)&0xffff) - 1) << 16) | ((x)&0xffff));                                \
+    CGX_InvalidateXFShadow((x), (n));                                                              \
+    cgx_sink.U8(0x10);                                                                             \
+    cgx_sink.U32((u32)(((((n)&0xffff) - 1) << 16) | ((x)&0xffff)));                                \
   } while (0)
 
 void CGX_Init();
@@ -95,8 +116,108 @@ void CGX_DoEfbCopyXfb(u16 left, u16 top, u16 width, u16 src_height, u16 dst_heig
 
 void CGX_ForcePipelineFlush();
 
+// Makes the GPU fetch and run the commands at list, which is flushed from the data cache first.
+// list and size must be 32-byte aligned.
+void CGX_CallDisplayList(const void* list, u32 size);
+
+// Records BP/CP/XF loads and draws into a 32-byte aligned buffer, which Call() then hands to the
+// GPU with a single call-display-list command. Setups that are repeated every iteration of a test
+// only need to be built once that way.
+// The Load functions return the offset of the (first) value they record, which Patch can change
+// in place between calls. BP values must keep their register address. Only patch once the GPU is
+// done with the previous call.
+// Registers written by the list are forgotten by the shadow registers when it's called.
+class CGXDisplayList
+{
+public:
+  explicit CGXDisplayList(u32 capacity);
+  ~CGXDisplayList();
+
+  CGXDisplayList(const CGXDisplayList&) = delete;
+  CGXDisplayList& operator=(const CGXDisplayList&) = delete;
+
+  void Clear();
+
+  u32 LoadBPReg(u32 value);
+  u32 LoadCPReg(u8 addr, u32 value);
+  u32 LoadXFRegs(u16 addr, const u32* values, u32 count);
+  u32 LoadXFReg(u16 addr, u32 value);
+
+  // Same parameters as CGX_SetViewport and CGX_LoadProjectionMatrixOrthographic
+  u32 SetViewport(float origin_x, float origin_y, float width, float height, float near, f32 far);
+  u32 LoadProjectionMatrixOrthographic(float mtx[4][4]);
+
+  // Starts a draw command, e.g. 0x80 for quads with vertex format 0. The vertex data follows
+  // through the Write functions.
+  void BeginDraw(u8 command, u16 num_vertices);
+  u32 WriteU8(u8 value);
+  u32 WriteU16(u16 value);
+  u32 WriteU32(u32 value);
+  u32 WriteF32(f32 value);
+
+  void Patch(u32 offset, u32 value);
+  void PatchF32(u32 offset, f32 value);
+  void PatchViewport(u32 offset, float origin_x, float origin_y, float width, float height,
+                     float near, f32 far);
+
+  void Call();
+
+private:
+  u8* buffer;
+  u32 capacity;
+  u32 size;
+
+  bool bp_written[0x100];
+  bool cp_written[0x100];
+  bool xf_written[0x100];
+  bool has_bp_writes;
+  bool ends_with_bp_mask;
+};
+
 void CGX_WaitForGpuToFinish();
 
+// PE tokens let the CPU keep queueing work while it waits for earlier work to finish, e.g. check
+// the result of one EFB copy while the GPU renders and copies the next one.
+// CGX_SendToken queues a token (via BPMEM_PE_TOKEN_INT_ID) and returns it. The token is reached
+// once the GPU has processed everything queued before it, including EFB copies. Tokens are
+// counted modulo 2^16, so no more than 32767 of them may be outstanding.
+u16 CGX_SendToken();
+bool CGX_TokenReached(u16 token);
+void CGX_WaitForToken(u16 token);
+
+// FIFO logs in the format of Dolphin's FIFO player (see FifoLog.h), which replay what a test sent
+// to the GPU. Every EFB copy ends a log: it has the commands since the previous copy and starts
+// with the registers as they were then. Once the GPU is done with the copy, i.e. after
+// CGX_WaitForGpuToFinish or CGX_WaitForToken for a token sent after the copy, its result is added
+// to the end of the log and to the start of the next one, where draws might sample it. The log is
+// then handed to the handler, along with the number of the copy (counting from 0). This happens
+// with interrupts enabled, since it copies the result and the handler may write files.
+// Called display lists are inlined into the logs. Any other memory the GPU reads, like textures
+// the CPU wrote, has to be added with CGX_FifoLogMemory. TMEM isn't known and EFB pokes aren't
+// commands, so neither is in the logs.
+// On the console, the commands since GX_Init are read back from the FIFO when logs are enabled,
+// so the registers libogc wrote are known as well. Later libogc calls that write registers go
+// between CGX_BeginLibogcCommands and CGX_EndLibogcCommands, which do the same for them.
+// cgx_sink's capture mustn't be cleared while logs are enabled.
+typedef void (*CGXFifoLogHandler)(u32 copy, const FifoLog& log);
+void CGX_EnableFifoLogs(CGXFifoLogHandler handler);
+bool CGX_FifoLogsEnabled();
+void CGX_FifoLogMemory(const void* data, u32 size, FifoLogMemoryType type);
+// Writes a log to path and returns whether that worked
+bool CGX_WriteFifoLog(const FifoLog& log, const char* path);
+void CGX_BeginLibogcCommands();
+void CGX_EndLibogcCommands();
+
+// Hooks for the rest of CGX, they do nothing unless logs are enabled
+void CGX_FifoLogDisplayList(const void* list, u32 size);
+void CGX_FifoLogEfbCopy(const void* dest, u32 size);
+void CGX_FifoLogToken(u16 token);
+void CGX_FifoLogTokenReached(u16 token);
+void CGX_FifoLogGpuFinished();
+// Console only: adds the commands from the start of the FIFO to the capture, and gets the
+// physical bounds of the FIFO
+void CGX_CaptureInitCommands(u32* fifo_start, u32* fifo_end);
+
 void CGX_PEPokeAlphaMode(CompareMode func, u8 threshold);
 void CGX_PEPokeAlphaUpdate(bool enable);
 void CGX_PEPokeColorUpdate(bool enable);
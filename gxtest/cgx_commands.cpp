@@ -0,0 +1,406 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// The parts of CGX that only emit commands through cgx_sink. Unlike cgx.cpp, these also build on
+// the host.
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "gxtest/BPMemory.h"
+#include "gxtest/CommandSink.h"
+#include "gxtest/cgx.h"
+
+CGXCommandSink cgx_sink;
+
+// Shadow registers, see cgx.h. The XF shadow covers the registers at 0x1000-0x10ff.
+static u32 _cgxbpshadow[0x100];
+static bool _cgxbpknown[0x100];
+static bool _cgxbpmaskpending = false;
+static u32 _cgxcpshadow[0x100];
+static bool _cgxcpknown[0x100];
+static u32 _cgxxfshadow[0x100];
+static bool _cgxxfknown[0x100];
+static CGXShadowStats _cgxshadowstats;
+
+static bool __CGXIsBPRegCached(u8 addr)
+{
+  switch (addr)
+  {
+  case BPMEM_PERF0_TRI:
+  case BPMEM_PERF0_QUAD:
+  case BPMEM_SETDRAWDONE:
+  case BPMEM_PE_TOKEN_ID:
+  case BPMEM_PE_TOKEN_INT_ID:
+  case BPMEM_TRIGGER_EFB_COPY:
+  case BPMEM_CLEARBBOX1:
+  case BPMEM_CLEARBBOX2:
+  case BPMEM_CLEAR_PIXEL_PERF:
+  case BPMEM_PRELOAD_MODE:
+  case BPMEM_LOADTLUT0:
+  case BPMEM_LOADTLUT1:
+  case BPMEM_TEXINVALIDATE:
+  case BPMEM_PERF1:
+  case BPMEM_BP_MASK:
+    return false;
+  default:
+    // The ra and bg halves of the TEV color registers select between the color and the konst
+    // registers, and bg is written several times on purpose
+    return addr < BPMEM_TEV_COLOR_RA || addr >= BPMEM_FOGRANGE;
+  }
+}
+
+void CGX_LoadBPReg(u32 value)
+{
+  const u8 addr = value >> 24;
+  if (!_cgxbpmaskpending && __CGXIsBPRegCached(addr) && _cgxbpknown[addr] &&
+      _cgxbpshadow[addr] == value)
+  {
+    ++_cgxshadowstats.suppressed_bp_writes;
+    _cgxshadowstats.suppressed_bytes += 5;
+    return;
+  }
+  CGX_ForceLoadBPReg(value);
+}
+
+void CGX_ForceLoadBPReg(u32 value)
+{
+  cgx_sink.U8(0x61);
+  cgx_sink.U32(value);
+
+  // A masked write only changes some of the bits, so the register is unknown afterwards
+  const u8 addr = value >> 24;
+  _cgxbpshadow[addr] = value;
+  _cgxbpknown[addr] = !_cgxbpmaskpending;
+  _cgxbpmaskpending = addr == BPMEM_BP_MASK && (value & 0xffffff) != 0xffffff;
+}
+
+void CGX_LoadCPReg(u8 addr, u32 value)
+{
+  if (_cgxcpknown[addr] && _cgxcpshadow[addr] == value)
+  {
+    ++_cgxshadowstats.suppressed_cp_writes;
+    _cgxshadowstats.suppressed_bytes += 6;
+    return;
+  }
+  CGX_ForceLoadCPReg(addr, value);
+}
+
+void CGX_ForceLoadCPReg(u8 addr, u32 value)
+{
+  cgx_sink.U8(0x08);
+  cgx_sink.U8(addr);
+  cgx_sink.U32(value);
+
+  _cgxcpshadow[addr] = value;
+  _cgxcpknown[addr] = true;
+}
+
+static bool __CGXXFShadowMatches(u16 addr, u32 value)
+{
+  const u32 index = addr - 0x1000u;
+  return index < 0x100 && _cgxxfknown[index] && _cgxxfshadow[index] == value;
+}
+
+static void __CGXUpdateXFShadow(u16 addr, const u32* values, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 index = addr + i - 0x1000u;
+    if (index < 0x100)
+    {
+      _cgxxfshadow[index] = values[i];
+      _cgxxfknown[index] = true;
+    }
+  }
+}
+
+void CGX_LoadXFRegs(u16 addr, const u32* values, u32 count)
+{
+  // Only the registers from the first to the last changed one are sent
+  u32 first = 0;
+  while (first < count && __CGXXFShadowMatches(addr + first, values[first]))
+    ++first;
+  u32 end = count;
+  while (end > first && __CGXXFShadowMatches(addr + end - 1, values[end - 1]))
+    --end;
+
+  const u32 suppressed = count - (end - first);
+  _cgxshadowstats.suppressed_xf_writes += suppressed;
+  _cgxshadowstats.suppressed_bytes += 4 * suppressed;
+  if (first == end)
+  {
+    _cgxshadowstats.suppressed_bytes += 5;
+    return;
+  }
+  CGX_ForceLoadXFRegs(addr + first, values + first, end - first);
+}
+
+void CGX_ForceLoadXFRegs(u16 addr, const u32* values, u32 count)
+{
+  cgx_sink.U8(0x10);
+  cgx_sink.U32(((count - 1) << 16) | addr);
+  for (u32 i = 0; i < count; ++i)
+    cgx_sink.U32(values[i]);
+
+  __CGXUpdateXFShadow(addr, values, count);
+}
+
+void CGX_LoadXFReg(u16 addr, u32 value)
+{
+  CGX_LoadXFRegs(addr, &value, 1);
+}
+
+void CGX_InvalidateXFShadow(u16 addr, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 index = addr + i - 0x1000u;
+    if (index < 0x100)
+      _cgxxfknown[index] = false;
+  }
+}
+
+void CGX_InvalidateShadowRegs()
+{
+  memset(_cgxbpknown, 0, sizeof(_cgxbpknown));
+  memset(_cgxcpknown, 0, sizeof(_cgxcpknown));
+  memset(_cgxxfknown, 0, sizeof(_cgxxfknown));
+  _cgxbpmaskpending = false;
+}
+
+const CGXShadowStats& CGX_GetShadowStats()
+{
+  return _cgxshadowstats;
+}
+
+void CGX_ResetShadowStats()
+{
+  _cgxshadowstats = {};
+}
+
+static void __CGXGetViewportRegs(float origin_x, float origin_y, float width, float height,
+                                 float near, f32 far, u32 (&values)[6])
+{
+  values[0] = Common::BitCast<u32>(width * 0.5f);
+  values[1] = Common::BitCast<u32>(-height * 0.5f);
+  values[2] = Common::BitCast<u32>((far - near) * 16777215.0f);
+  values[3] = Common::BitCast<u32>(342.0f + origin_x + width * 0.5f);
+  values[4] = Common::BitCast<u32>(342.0f + origin_y + height * 0.5f);
+  values[5] = Common::BitCast<u32>(far * 16777215.0f);
+}
+
+void CGX_SetViewport(float origin_x, float origin_y, float width, float height, float near, f32 far)
+{
+  u32 values[6];
+  __CGXGetViewportRegs(origin_x, origin_y, width, height, near, far, values);
+  CGX_LoadXFRegs(0x101a, values, 6);
+}
+
+void CGX_LoadProjectionMatrixPerspective(float mtx[4][4])
+{
+  const u32 values[7] = {
+      Common::BitCast<u32>(mtx[0][0]), Common::BitCast<u32>(mtx[0][2]),
+      Common::BitCast<u32>(mtx[1][1]), Common::BitCast<u32>(mtx[1][2]),
+      Common::BitCast<u32>(mtx[2][2]), Common::BitCast<u32>(mtx[2][3]),
+      0,
+  };
+  CGX_LoadXFRegs(0x1020, values, 7);
+}
+
+static void __CGXGetProjectionRegsOrthographic(float mtx[4][4], u32 (&values)[7])
+{
+  values[0] = Common::BitCast<u32>(mtx[0][0]);
+  values[1] = Common::BitCast<u32>(mtx[0][3]);
+  values[2] = Common::BitCast<u32>(mtx[1][1]);
+  values[3] = Common::BitCast<u32>(mtx[1][3]);
+  values[4] = Common::BitCast<u32>(mtx[2][2]);
+  values[5] = Common::BitCast<u32>(mtx[2][3]);
+  values[6] = 1;
+}
+
+void CGX_LoadProjectionMatrixOrthographic(float mtx[4][4])
+{
+  u32 values[7];
+  __CGXGetProjectionRegsOrthographic(mtx, values);
+  CGX_LoadXFRegs(0x1020, values, 7);
+}
+
+void CGX_ForcePipelineFlush()
+{
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+  cgx_sink.U32(0);
+}
+
+void CGX_CallDisplayList(const void* list, u32 size)
+{
+  assert((reinterpret_cast<std::uintptr_t>(list) & 31) == 0);
+  assert((size & 31) == 0);
+
+  CGX_FifoLogDisplayList(list, size);
+  cgx_sink.CallDisplayList(list, size);
+}
+
+CGXDisplayList::CGXDisplayList(u32 capacity) : capacity((capacity + 31) & ~31)
+{
+  buffer = (u8*)memalign(32, this->capacity);
+  Clear();
+}
+
+CGXDisplayList::~CGXDisplayList()
+{
+  free(buffer);
+}
+
+void CGXDisplayList::Clear()
+{
+  size = 0;
+  memset(bp_written, 0, sizeof(bp_written));
+  memset(cp_written, 0, sizeof(cp_written));
+  memset(xf_written, 0, sizeof(xf_written));
+  has_bp_writes = false;
+  ends_with_bp_mask = false;
+}
+
+u32 CGXDisplayList::LoadBPReg(u32 value)
+{
+  const u8 addr = value >> 24;
+  bp_written[addr] = true;
+  has_bp_writes = true;
+  ends_with_bp_mask = addr == BPMEM_BP_MASK && (value & 0xffffff) != 0xffffff;
+
+  WriteU8(0x61);
+  return WriteU32(value);
+}
+
+u32 CGXDisplayList::LoadCPReg(u8 addr, u32 value)
+{
+  cp_written[addr] = true;
+
+  WriteU8(0x08);
+  WriteU8(addr);
+  return WriteU32(value);
+}
+
+u32 CGXDisplayList::LoadXFRegs(u16 addr, const u32* values, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 index = addr + i - 0x1000u;
+    if (index < 0x100)
+      xf_written[index] = true;
+  }
+
+  WriteU8(0x10);
+  WriteU32(((count - 1) << 16) | addr);
+  const u32 offset = size;
+  for (u32 i = 0; i < count; ++i)
+    WriteU32(values[i]);
+  return offset;
+}
+
+u32 CGXDisplayList::LoadXFReg(u16 addr, u32 value)
+{
+  return LoadXFRegs(addr, &value, 1);
+}
+
+u32 CGXDisplayList::SetViewport(float origin_x, float origin_y, float width, float height,
+                                float near, f32 far)
+{
+  u32 values[6];
+  __CGXGetViewportRegs(origin_x, origin_y, width, height, near, far, values);
+  return LoadXFRegs(0x101a, values, 6);
+}
+
+u32 CGXDisplayList::LoadProjectionMatrixOrthographic(float mtx[4][4])
+{
+  u32 values[7];
+  __CGXGetProjectionRegsOrthographic(mtx, values);
+  return LoadXFRegs(0x1020, values, 7);
+}
+
+void CGXDisplayList::BeginDraw(u8 command, u16 num_vertices)
+{
+  WriteU8(command);
+  WriteU16(num_vertices);
+}
+
+// Values are stored big-endian and unaligned, like they go through the write-gather pipe
+u32 CGXDisplayList::WriteU8(u8 value)
+{
+  assert(size < capacity);
+  buffer[size] = value;
+  return size++;
+}
+
+u32 CGXDisplayList::WriteU16(u16 value)
+{
+  const u32 offset = WriteU8(value >> 8);
+  WriteU8(value & 0xff);
+  return offset;
+}
+
+u32 CGXDisplayList::WriteU32(u32 value)
+{
+  const u32 offset = WriteU16(value >> 16);
+  WriteU16(value & 0xffff);
+  return offset;
+}
+
+u32 CGXDisplayList::WriteF32(f32 value)
+{
+  return WriteU32(Common::BitCast<u32>(value));
+}
+
+void CGXDisplayList::Patch(u32 offset, u32 value)
+{
+  assert(offset + 4 <= size);
+  buffer[offset] = value >> 24;
+  buffer[offset + 1] = (value >> 16) & 0xff;
+  buffer[offset + 2] = (value >> 8) & 0xff;
+  buffer[offset + 3] = value & 0xff;
+}
+
+void CGXDisplayList::PatchF32(u32 offset, f32 value)
+{
+  Patch(offset, Common::BitCast<u32>(value));
+}
+
+void CGXDisplayList::PatchViewport(u32 offset, float origin_x, float origin_y, float width,
+                                   float height, float near, f32 far)
+{
+  u32 values[6];
+  __CGXGetViewportRegs(origin_x, origin_y, width, height, near, far, values);
+  for (u32 i = 0; i < 6; ++i)
+    Patch(offset + 4 * i, values[i]);
+}
+
+void CGXDisplayList::Call()
+{
+  if (size == 0)
+    return;
+
+  // Pad with NOPs up to the next 32-byte boundary
+  const u32 padded_size = (size + 31) & ~31;
+  memset(buffer + size, 0, padded_size - size);
+  CGX_CallDisplayList(buffer, padded_size);
+
+  for (u32 i = 0; i < 0x100; ++i)
+  {
+    _cgxbpknown[i] = _cgxbpknown[i] && !bp_written[i];
+    _cgxcpknown[i] = _cgxcpknown[i] && !cp_written[i];
+    _cgxxfknown[i] = _cgxxfknown[i] && !xf_written[i];
+  }
+  if (has_bp_writes)
+    _cgxbpmaskpending = ends_with_bp_mask;
+}
@@ -0,0 +1,235 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// FIFO logs of what CGX emits, see CGX_EnableFifoLogs in cgx.h. Like cgx_commands.cpp, this also
+// builds on the host.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "gxtest/BPMemory.h"
+#include "gxtest/CommandSink.h"
+#include "gxtest/FifoDecoder.h"
+#include "gxtest/FifoLog.h"
+#include "gxtest/cgx.h"
+
+namespace
+{
+// Applies the register writes of the decoded commands to the registers a log starts with
+class FifoStateTracker : public FifoHandler
+{
+public:
+  void OnBP(u32 value) override
+  {
+    const u8 addr = value >> 24;
+    if (addr == BPMEM_BP_MASK)
+    {
+      bp_mask = value & 0xffffff;
+      registers.bp_mem[addr] = bp_mask;
+      return;
+    }
+    registers.bp_mem[addr] = (registers.bp_mem[addr] & ~bp_mask) | (value & bp_mask);
+    bp_mask = 0xffffff;
+  }
+
+  void OnCP(u8 addr, u32 value) override { registers.cp_mem[addr] = value; }
+
+  void OnXF(u16 addr, const u32* values, u32 count) override
+  {
+    for (u32 i = 0; i < count; ++i)
+    {
+      const u32 reg = addr + i;
+      if (reg < FIFO_LOG_XF_MEM_SIZE)
+        registers.xf_mem[reg] = values[i];
+      else if (reg - 0x1000 < FIFO_LOG_XF_REGS_SIZE)
+        registers.xf_regs[reg - 0x1000] = values[i];
+    }
+  }
+
+  FifoLogRegisters registers = {};
+
+private:
+  u32 bp_mask = 0xffffff;
+};
+
+// A log that ends with an EFB copy the GPU might not have done yet
+struct PendingFifoLog
+{
+  u32 copy;
+  FifoLog log;
+  const void* dest;
+};
+}  // namespace
+
+static bool _cgxfifologsenabled = false;
+static CGXFifoLogHandler _cgxfifologhandler = nullptr;
+static FifoStateTracker _cgxfifostate;
+static FifoDecoder _cgxfifodecoder(_cgxfifostate);
+
+// The log of the commands since the last copy. Its commands up to _cgxfifodecoded have been
+// applied to _cgxfifostate.
+static FifoLog _cgxfifolog;
+static size_t _cgxfifodecoded = 0;
+// Number of copies so far, which is also the number of the current log
+static u32 _cgxfifologcopies = 0;
+// Bytes of the capture that called a display list whose contents are in the log instead
+static u32 _cgxfifologskip = 0;
+static u32 _cgxfifostart = 0;
+static u32 _cgxfifoend = 0;
+
+static std::vector<PendingFifoLog> _cgxpendinglogs;
+// Tokens sent while logging, with the number of copies queued before them
+static std::vector<std::pair<u16, u32>> _cgxfifologtokens;
+
+// Moves what cgx_sink captured into the current log and applies it to the register state
+static void __CGXTakeCapture()
+{
+  const std::vector<u8>& capture = cgx_sink.GetCapture();
+  const size_t skip = std::min<size_t>(_cgxfifologskip, capture.size());
+  _cgxfifolog.fifo_data.insert(_cgxfifolog.fifo_data.end(), capture.begin() + skip,
+                               capture.end());
+  _cgxfifologskip -= skip;
+  cgx_sink.ClearCapture();
+
+  const std::vector<u8>& fifo = _cgxfifolog.fifo_data;
+  _cgxfifodecoded += _cgxfifodecoder.Decode(fifo.data() + _cgxfifodecoded,
+                                            fifo.size() - _cgxfifodecoded);
+}
+
+// Starts the next log with the registers as they are now
+static void __CGXStartFifoLog()
+{
+  _cgxfifolog.registers = _cgxfifostate.registers;
+  _cgxfifolog.fifo_data.clear();
+  _cgxfifolog.memory_updates.clear();
+  _cgxfifolog.fifo_start = _cgxfifostart;
+  _cgxfifolog.fifo_end = _cgxfifoend;
+  _cgxfifodecoded = 0;
+}
+
+// Fills in the result of the oldest pending copy and hands its log over. The copy's result is
+// also the first memory update of the log after it.
+static void __CGXFinishOldestFifoLog()
+{
+  PendingFifoLog& pending = _cgxpendinglogs.front();
+  std::vector<u8>& result = pending.log.memory_updates.back().data;
+#ifdef GEKKO
+  DCInvalidateRange(const_cast<void*>(pending.dest), result.size());
+#endif
+  std::memcpy(result.data(), pending.dest, result.size());
+
+  FifoLog& next = _cgxpendinglogs.size() > 1 ? _cgxpendinglogs[1].log : _cgxfifolog;
+  next.memory_updates.front().data = result;
+
+  if (_cgxfifologhandler)
+    _cgxfifologhandler(pending.copy, pending.log);
+  _cgxpendinglogs.erase(_cgxpendinglogs.begin());
+}
+
+void CGX_EnableFifoLogs(CGXFifoLogHandler handler)
+{
+  _cgxfifologsenabled = true;
+  _cgxfifologhandler = handler;
+  cgx_sink.ClearCapture();
+  cgx_sink.StartCapture();
+
+#ifdef GEKKO
+  // Everything since GX_Init, most of which libogc wrote
+  CGX_CaptureInitCommands(&_cgxfifostart, &_cgxfifoend);
+#endif
+  __CGXTakeCapture();
+  __CGXStartFifoLog();
+}
+
+bool CGX_FifoLogsEnabled()
+{
+  return _cgxfifologsenabled;
+}
+
+void CGX_FifoLogMemory(const void* data, u32 size, FifoLogMemoryType type)
+{
+  if (!_cgxfifologsenabled)
+    return;
+
+  __CGXTakeCapture();
+  const u8* bytes = static_cast<const u8*>(data);
+  _cgxfifolog.memory_updates.push_back({static_cast<u32>(_cgxfifolog.fifo_data.size()),
+                                        CGXCommandSink::GetGPUAddress(data), type,
+                                        std::vector<u8>(bytes, bytes + size)});
+}
+
+bool CGX_WriteFifoLog(const FifoLog& log, const char* path)
+{
+  const std::vector<u8> file = SerializeFifoLog(log);
+
+  std::FILE* out = std::fopen(path, "wb");
+  if (!out)
+    return false;
+  const bool written = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+  return std::fclose(out) == 0 && written;
+}
+
+void CGX_FifoLogDisplayList(const void* list, u32 size)
+{
+  if (!_cgxfifologsenabled)
+    return;
+
+  // The FIFO player has no display list memory, so the list's commands go where it's called
+  __CGXTakeCapture();
+  const u8* bytes = static_cast<const u8*>(list);
+  _cgxfifolog.fifo_data.insert(_cgxfifolog.fifo_data.end(), bytes, bytes + size);
+  _cgxfifologskip = 9;
+  __CGXTakeCapture();
+}
+
+void CGX_FifoLogEfbCopy(const void* dest, u32 size)
+{
+  if (!_cgxfifologsenabled)
+    return;
+
+  // The copy ends the log. Its result is only valid once the GPU has done the copy, until then
+  // the updates are placeholders of the right size.
+  __CGXTakeCapture();
+  const u32 address = CGXCommandSink::GetGPUAddress(dest);
+  _cgxfifolog.memory_updates.push_back({static_cast<u32>(_cgxfifolog.fifo_data.size()), address,
+                                        FifoLogMemoryType::TextureMap, std::vector<u8>(size)});
+  _cgxpendinglogs.push_back({_cgxfifologcopies++, std::move(_cgxfifolog), dest});
+
+  __CGXStartFifoLog();
+  _cgxfifolog.memory_updates.push_back(
+      {0, address, FifoLogMemoryType::TextureMap, std::vector<u8>(size)});
+}
+
+void CGX_FifoLogToken(u16 token)
+{
+  if (_cgxfifologsenabled)
+    _cgxfifologtokens.emplace_back(token, _cgxfifologcopies);
+}
+
+void CGX_FifoLogTokenReached(u16 token)
+{
+  auto it = std::find_if(_cgxfifologtokens.begin(), _cgxfifologtokens.end(),
+                         [token](const auto& sent) { return sent.first == token; });
+  if (it == _cgxfifologtokens.end())
+    return;
+
+  // Every copy queued before the token is done, and so are the ones of earlier tokens
+  const u32 copies = it->second;
+  _cgxfifologtokens.erase(_cgxfifologtokens.begin(), it + 1);
+  while (!_cgxpendinglogs.empty() && _cgxpendinglogs.front().copy < copies)
+    __CGXFinishOldestFifoLog();
+}
+
+void CGX_FifoLogGpuFinished()
+{
+  if (!_cgxfifologsenabled)
+    return;
+
+  _cgxfifologtokens.clear();
+  while (!_cgxpendinglogs.empty())
+    __CGXFinishOldestFifoLog();
+}
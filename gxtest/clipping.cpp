@@ -4,15 +4,72 @@
 
 #include <initializer_list>
 #include <math.h>
+#include <ogc/lwp_watchdog.h>
 #include <ogcsys.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wiiuse/wpad.h>
 #include "Common/hwtests.h"
+#include "Common/timebase.h"
 #include "gxtest/cgx.h"
 #include "gxtest/cgx_defaults.h"
 #include "gxtest/util.h"
 
+// Clears the screen and loads the state for drawing the testing quad, into list if there is one
+// and straight to the FIFO otherwise
+static void SendClearSetup(CGXDisplayList* list)
+{
+  const auto load_bp_reg = [list](u32 value) {
+    if (list)
+      list->LoadBPReg(value);
+    else
+      CGX_LOAD_BP_REG(value);
+  };
+  const auto set_viewport = [list](float origin_x, float width) {
+    if (list)
+      list->SetViewport(origin_x, 0.0f, width, 50.0f, 0.0f, 1.0f);
+    else
+      CGX_SetViewport(origin_x, 0.0f, width, 50.0f, 0.0f, 1.0f);
+  };
+  const auto draw = [list](GXTest::Quad& quad) {
+    if (list)
+      quad.Draw(*list);
+    else
+      quad.Draw();
+  };
+
+  auto zmode = CGXDefault<ZMode>();
+  load_bp_reg(zmode.hex);
+
+  // First off, clear previous screen contents
+  set_viewport(0.0f, 201.0f);  // stuff which really should not be filled
+  auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
+  cc.d = TevColorArg::RasColor;
+  load_bp_reg(cc.hex);
+  draw(GXTest::Quad().ColorRGBA(0, 0, 0, 0xff));
+
+  set_viewport(75.0f, 100.0f);  // guardband
+  draw(GXTest::Quad().ColorRGBA(0, 0x7f, 0, 0xff));
+
+  set_viewport(100.0f, 50.0f);  // viewport
+  draw(GXTest::Quad().ColorRGBA(0, 0xff, 0, 0xff));
+
+  // Now, enable testing viewport and draw the (red) testing quad
+  cc.d = TevColorArg::Color0;
+  load_bp_reg(cc.hex);
+
+  auto tevreg = CGXDefault<TevReg>(1, false);  // c0
+  tevreg.ra.red = 0xff;
+  load_bp_reg(tevreg.ra.hex);
+  load_bp_reg(tevreg.bg.hex);
+
+  // 0 = enable clipping, 1 = disable clipping
+  if (list)
+    list->LoadXFReg(0x1005, 0);
+  else
+    CGX_LoadXFReg(0x1005, 0);
+}
+
 void ClipTest()
 {
   START_TEST();
@@ -20,15 +77,15 @@ void ClipTest()
   CGX_LOAD_BP_REG(CGXDefault<TwoTevStageOrders>(0).hex);
 
   CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);
-  wgPipe->U32 = 1;  // 1 color channel
+  cgx_sink.U32(1);  // 1 color channel
 
   LitChannel chan;
   chan.hex = 0;
   chan.matsource = 1;                 // from vertex
   CGX_BEGIN_LOAD_XF_REGS(0x100e, 1);  // color channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
   CGX_BEGIN_LOAD_XF_REGS(0x1010, 1);  // alpha channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
 
   CGX_LOAD_BP_REG(CGXDefault<TevStageCombiner::AlphaCombiner>(0).hex);
 
@@ -43,44 +100,23 @@ void ClipTest()
   ctrl.early_ztest = false;
   CGX_LOAD_BP_REG(ctrl.hex);
 
+  // The clear quads and the testing state are the same in every step, so they're recorded once.
+  // They're also sent directly once, to compare the cost of both ways.
+  u64 start_tb = GetTimebase();
+  SendClearSetup(nullptr);
+  const u64 direct_ticks = GetTimebase() - start_tb;
+
+  CGXDisplayList clear_list(1024);
+  start_tb = GetTimebase();
+  SendClearSetup(&clear_list);
+  const u64 record_ticks = GetTimebase() - start_tb;
+  u64 call_ticks = 0;
+
   for (int step = 0; step < 16; ++step)
   {
-    auto zmode = CGXDefault<ZMode>();
-    CGX_LOAD_BP_REG(zmode.hex);
-
-    // First off, clear previous screen contents
-    CGX_SetViewport(0.0f, 0.0f, 201.0f, 50.0f, 0.0f,
-                    1.0f);  // stuff which really should not be filled
-    auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
-    cc.d = TevColorArg::RasColor;
-    CGX_LOAD_BP_REG(cc.hex);
-    GXTest::Quad().ColorRGBA(0, 0, 0, 0xff).Draw();
-
-    CGX_SetViewport(75.0f, 0.0f, 100.0f, 50.0f, 0.0f, 1.0f);  // guardband
-    cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
-    cc.d = TevColorArg::RasColor;
-    CGX_LOAD_BP_REG(cc.hex);
-    GXTest::Quad().ColorRGBA(0, 0x7f, 0, 0xff).Draw();
-
-    CGX_SetViewport(100.0f, 0.0f, 50.0f, 50.0f, 0.0f, 1.0f);  // viewport
-    cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
-    cc.d = TevColorArg::RasColor;
-    CGX_LOAD_BP_REG(cc.hex);
-    GXTest::Quad().ColorRGBA(0, 0xff, 0, 0xff).Draw();
-
-    // Now, enable testing viewport and draw the (red) testing quad
-    CGX_SetViewport(100.0f, 0.0f, 50.0f, 50.0f, 0.0f, 1.0f);
-
-    cc.d = TevColorArg::Color0;
-    CGX_LOAD_BP_REG(cc.hex);
-
-    auto tevreg = CGXDefault<TevReg>(1, false);  // c0
-    tevreg.ra.red = 0xff;
-    CGX_LOAD_BP_REG(tevreg.ra.hex);
-    CGX_LOAD_BP_REG(tevreg.bg.hex);
-
-    CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-    wgPipe->U32 = 0;  // 0 = enable clipping, 1 = disable clipping
+    start_tb = GetTimebase();
+    clear_list.Call();
+    call_ticks += GetTimebase() - start_tb;
 
     bool expect_quad_to_be_drawn = true;
     int test_x = 125, test_y = 25;  // Somewhere within the viewport
@@ -157,8 +193,7 @@ void ClipTest()
     // Depth clipping tests
     case 7:  // Everything behind z=w plane, depth clipping enabled
     case 8:  // Everything behind z=w plane, depth clipping disabled
-      CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-      wgPipe->U32 = step - 7;  // 0 = enable clipping, 1 = disable clipping
+      CGX_LoadXFReg(0x1005, step - 7);  // 0 = enable clipping, 1 = disable clipping
 
       test_quad.AtDepth(1.1);
       expect_quad_to_be_drawn = false;
@@ -166,8 +201,7 @@ void ClipTest()
 
     case 9:   // Everything in front of z=0 plane, depth clipping enabled
     case 10:  // Everything in front of z=0 plane, depth clipping disabled
-      CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-      wgPipe->U32 = step - 9;  // 0 = enable clipping, 1 = disable clipping
+      CGX_LoadXFReg(0x1005, step - 9);  // 0 = enable clipping, 1 = disable clipping
 
       test_quad.AtDepth(-0.00001);
       expect_quad_to_be_drawn = false;
@@ -181,16 +215,14 @@ void ClipTest()
       // number, which by IEEE would be non-zero but which in fact is
       // treated as zero.
       // In particular, the value by IEEE is -0.00000011920928955078125.
-      CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-      wgPipe->U32 = step - 11;  // 0 = enable clipping, 1 = disable clipping
+      CGX_LoadXFReg(0x1005, step - 11);  // 0 = enable clipping, 1 = disable clipping
 
       test_quad.AtDepth(1.0000001);
       break;
 
     case 13:  // One vertex behind z=w plane, depth clipping enabled
     case 14:  // One vertex behind z=w plane, depth clipping disabled
-      CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-      wgPipe->U32 = step - 13;  // 0 = enable clipping, 1 = disable clipping
+      CGX_LoadXFReg(0x1005, step - 13);  // 0 = enable clipping, 1 = disable clipping
 
       test_quad.VertexTopLeft(-1.0f, 1.0f, 1.5f);
 
@@ -200,8 +232,7 @@ void ClipTest()
       break;
 
     case 15:  // Three vertices with a very large value for z, depth clipping disabled
-      CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-      wgPipe->U32 = 1;  // 0 = enable clipping, 1 = disable clipping
+      CGX_LoadXFReg(0x1005, 1);  // 0 = enable clipping, 1 = disable clipping
 
       test_quad.VertexTopLeft(-1.0f, 1.0f, 65537.f);
       test_quad.VertexTopRight(1.0f, 1.0f, 65537.f);
@@ -229,6 +260,11 @@ void ClipTest()
     GXTest::DebugDisplayEfbContents();
   }
 
+  network_printf("Clear setup: %llu ns to send directly, %llu ns to record, "
+                 "%llu ns per display list call\n",
+                 direct_ticks * 1000000 / TB_TIMER_CLOCK, record_ticks * 1000000 / TB_TIMER_CLOCK,
+                 call_ticks * 1000000 / TB_TIMER_CLOCK / 16);
+
   END_TEST();
 }
 
@@ -241,6 +277,11 @@ int main()
 
   ClipTest();
 
+  const CGXShadowStats& stats = CGX_GetShadowStats();
+  network_printf("Dropped %u BP, %u CP and %u XF register writes (%u bytes)\n",
+                 stats.suppressed_bp_writes, stats.suppressed_cp_writes, stats.suppressed_xf_writes,
+                 stats.suppressed_bytes);
+
   network_printf("Shutting down...\n");
   network_shutdown();
 
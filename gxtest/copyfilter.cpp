@@ -5,6 +5,7 @@
 #include <array>
 #include <cmath>
 #include <fmt/format.h>
+#include <optional>
 
 #include <ogcsys.h>
 #include <wiiuse/wpad.h>
@@ -68,7 +69,8 @@ static void SetPixelFormat(PixelFormat pixel_fmt)
   ctrl.pixel_format = pixel_fmt;
   ctrl.zformat = DepthFormat::ZLINEAR;
   ctrl.early_ztest = false;
-  CGX_LOAD_BP_REG(ctrl.hex);
+  // Rewritten even if unchanged, so every fill starts with a fresh format write
+  CGX_FORCE_LOAD_BP_REG(ctrl.hex);
 }
 
 static void FillEFB(PixelFormat pixel_fmt)
@@ -113,7 +115,10 @@ static void FillEFB(PixelFormat pixel_fmt)
     // This value should be overridden, but it's recognizable if it shows up
     CGX_LOAD_BP_REG(BPMEM_CLEAR_Z << 24 | 123456);
     GXTest::CopyToTestBuffer(0, 0, 255, 7, {.clear = true});
+    CGX_BeginLibogcCommands();
     GX_InvalidateTexAll();
+    CGX_EndLibogcCommands();
+    CGX_InvalidateShadowRegs();
 
     AlphaTest alpha{.hex = BPMEM_ALPHACOMPARE << 24};
     alpha.comp0 = CompareMode::Always;
@@ -132,13 +137,13 @@ static void FillEFB(PixelFormat pixel_fmt)
     CGX_LOAD_BP_REG(blend.hex);
 
     CGX_BEGIN_LOAD_XF_REGS(0x1008, 1);  // XFMEM_VTXSPECS
-    wgPipe->U32 = 1<<4;  // 1 texture coordinate
+    cgx_sink.U32(1<<4);  // 1 texture coordinate
     CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);  // XFMEM_SETNUMCHAN
-    wgPipe->U32 = 0;
+    cgx_sink.U32(0);
     CGX_BEGIN_LOAD_XF_REGS(0x103f, 1);  // XFMEM_SETNUMTEXGENS
-    wgPipe->U32 = 1;
+    cgx_sink.U32(1);
     CGX_BEGIN_LOAD_XF_REGS(0x1040, 1);  // XFMEM_SETTEXMTXINFO
-    wgPipe->U32 = 0x280;  // regular texgen for tex0
+    cgx_sink.U32(0x280);  // regular texgen for tex0
 
     CGX_LOAD_BP_REG(BPMEM_TX_SETMODE0 << 24);
     CGX_LOAD_BP_REG(BPMEM_TX_SETMODE1 << 24);
@@ -194,31 +199,31 @@ static void FillEFB(PixelFormat pixel_fmt)
     CGX_LOAD_CP_REG(0x90, 0);  // CP_VAT_REG_C
 
     // Actually draw the vertices
-    GX_Begin(GX_QUADS, GX_VTXFMT0, 4);
-    wgPipe->S8 = -1;
-    wgPipe->S8 = -1;
-    wgPipe->S8 = 1;
-    wgPipe->U8 = 0;
-    wgPipe->U8 = 1;
-
-    wgPipe->S8 = -1;
-    wgPipe->S8 = +1;
-    wgPipe->S8 = 1;
-    wgPipe->U8 = 0;
-    wgPipe->U8 = 0;
-
-    wgPipe->S8 = +1;
-    wgPipe->S8 = +1;
-    wgPipe->S8 = 1;
-    wgPipe->U8 = 1;
-    wgPipe->U8 = 0;
-
-    wgPipe->S8 = +1;
-    wgPipe->S8 = -1;
-    wgPipe->S8 = 1;
-    wgPipe->U8 = 1;
-    wgPipe->U8 = 1;
-    GX_End();
+    cgx_sink.U8(0x80);  // draw quads
+    cgx_sink.U16(4);    // 4 vertices
+    cgx_sink.S8(-1);
+    cgx_sink.S8(-1);
+    cgx_sink.S8(1);
+    cgx_sink.U8(0);
+    cgx_sink.U8(1);
+
+    cgx_sink.S8(-1);
+    cgx_sink.S8(+1);
+    cgx_sink.S8(1);
+    cgx_sink.U8(0);
+    cgx_sink.U8(0);
+
+    cgx_sink.S8(+1);
+    cgx_sink.S8(+1);
+    cgx_sink.S8(1);
+    cgx_sink.U8(1);
+    cgx_sink.U8(0);
+
+    cgx_sink.S8(+1);
+    cgx_sink.S8(-1);
+    cgx_sink.S8(1);
+    cgx_sink.U8(1);
+    cgx_sink.U8(1);
 
     CGX_WaitForGpuToFinish();
 
@@ -438,29 +443,46 @@ GXTest::Vec4<u8> Predict(GXTest::Vec4<u8> prev_efb_color, GXTest::Vec4<u8> efb_c
   }
 }
 
-void CopyFilterTest(const CopyFilterTestContext& ctx)
+// Queues the copy for CopyFilterTest, which the GPU can then do while the previous one is checked
+u16 StartCopyFilterCopy(const CopyFilterTestContext& ctx, int buffer)
+{
+  SetCopyFilter(ctx);
+  return GXTest::CopyToTestBufferAsync(buffer, 0, 0, 255, 7, {.gamma = ctx.gamma, .intensity_fmt = ctx.intensity_fmt, .auto_conv = ctx.intensity_fmt});
+}
+
+struct PendingCopyFilterTest
+{
+  CopyFilterTestContext ctx;
+  int buffer;
+  u16 token;
+};
+
+void CopyFilterTest(const PendingCopyFilterTest& test)
 {
   START_TEST();
 
-  SetCopyFilter(ctx);
-  GXTest::CopyToTestBuffer(0, 0, 255, 7, {.gamma = ctx.gamma, .intensity_fmt = ctx.intensity_fmt, .auto_conv = ctx.intensity_fmt});
-  CGX_WaitForGpuToFinish();
+  const CopyFilterTestContext& ctx = test.ctx;
+  GXTest::WaitForTestBuffer(test.buffer, test.token);
+
+  // Rows 3 and 5 are only there for the copy filter, the checked row is 4
+  static GXTest::Vec4<u8> pixels[256 * 8];
+  GXTest::DetileRGBA8(GXTest::test_buffers[test.buffer], 256, 8, pixels);
 
+  GXTest::Vec4<u8> expected[256];
   for (u16 x = 0; x < 256; x++)
   {
-    // Reduce bit depth based on the format
-    GXTest::Vec4<u8> prev_efb_color = PredictEfbColor(x, 3, ctx.pixel_fmt);
-    GXTest::Vec4<u8> efb_color = PredictEfbColor(x, 4, ctx.pixel_fmt);
-    GXTest::Vec4<u8> next_efb_color = PredictEfbColor(x, 5, ctx.pixel_fmt);
-    // Make predictions based on the copy filter and gamma
-    GXTest::Vec4<u8> expected = Predict(prev_efb_color, efb_color, next_efb_color, ctx);
-    GXTest::Vec4<u8> actual = GXTest::ReadTestBuffer(x, 4, 256);
-    DO_TEST(actual.r == expected.r, "Predicted wrong red   value for x {} with {}: expected {} from {}/{}/{}, was {}", x, ctx, expected.r, prev_efb_color.r, efb_color.r, next_efb_color.r, actual.r);
-    DO_TEST(actual.g == expected.g, "Predicted wrong green value for x {} with {}: expected {} from {}/{}/{}, was {}", x, ctx, expected.g, prev_efb_color.g, efb_color.g, next_efb_color.g, actual.g);
-    DO_TEST(actual.b == expected.b, "Predicted wrong blue  value for x {} with {}: expected {} from {}/{}/{}, was {}", x, ctx, expected.b, prev_efb_color.b, efb_color.b, next_efb_color.b, actual.b);
-    DO_TEST(actual.a == expected.a, "Predicted wrong alpha value for x {} with {}: expected {} from {}/{}/{}, was {}", x, ctx, expected.a, prev_efb_color.a, efb_color.a, next_efb_color.a, actual.a);
+    // Reduce bit depth based on the format, then make predictions based on the copy filter and
+    // gamma
+    expected[x] = Predict(PredictEfbColor(x, 3, ctx.pixel_fmt), PredictEfbColor(x, 4, ctx.pixel_fmt),
+                          PredictEfbColor(x, 5, ctx.pixel_fmt), ctx);
   }
 
+  // The whole row is one subtest, which reports its first wrong pixel
+  const GXTest::Vec4<u8>* actual = &pixels[4 * 256];
+  const int x = GXTest::FindMismatch(actual, expected, 256);
+  const u16 shown_x = std::min(x, 255);
+  DO_TEST(x == 256, "Predicted wrong r/g/b/a value for x {} with {}: expected {} from {}, {} and {}, was {}", x, ctx, expected[shown_x], PredictEfbColor(shown_x, 3, ctx.pixel_fmt), PredictEfbColor(shown_x, 4, ctx.pixel_fmt), PredictEfbColor(shown_x, 5, ctx.pixel_fmt), actual[shown_x]);
+
   END_TEST();
 }
 
@@ -520,6 +542,11 @@ int main()
     FillEFB(pixel_fmt);
     CheckEFB(pixel_fmt);
 
+    // Each copy is queued before the previous one is checked, alternating between the test
+    // buffers. FillEFB waits for the GPU, so no copy is still running when the EFB gets refilled.
+    std::optional<PendingCopyFilterTest> pending;
+    int next_buffer = 0;
+
 #if FULL_COPY_FILTER_COEFS
     for (u8 copy_filter_sum = 0; copy_filter_sum <= MAX_COPY_FILTER_CUR; copy_filter_sum++)
 #else
@@ -546,7 +573,12 @@ int main()
           const u8 cur_sum = std::min(cur_row ? copy_filter_sum : 0, MAX_COPY_FILTER_CUR);
           const u8 next_sum = std::min(next_row ? copy_filter_sum : 0, MAX_COPY_FILTER_NEXT);
 
-          CopyFilterTest({pixel_fmt, gamma, prev_sum, cur_sum, next_sum, intensity_fmt});
+          const CopyFilterTestContext ctx{pixel_fmt, gamma, prev_sum, cur_sum, next_sum, intensity_fmt};
+          const u16 token = StartCopyFilterCopy(ctx, next_buffer);
+          if (pending)
+            CopyFilterTest(*pending);
+          pending = {ctx, next_buffer, token};
+          next_buffer = (next_buffer + 1) % GXTest::NUM_TEST_BUFFERS;
 
           WPAD_ScanPads();
           if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
@@ -554,6 +586,9 @@ int main()
         }
       }
     }
+
+    if (pending)
+      CopyFilterTest(*pending);
   }
 done:
 
@@ -0,0 +1,79 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Reading back RGBA8 copies. This only touches memory, so like quad.cpp, it also builds on the
+// host (see tools/detile_bench.cpp).
+
+#include <algorithm>
+#include <string.h>
+
+#include "gxtest/util.h"
+
+namespace GXTest
+{
+// An RGBA8 copy is made of 4x4 pixel blocks of 64 bytes, in rows of blocks. Each block has the
+// alpha and red values of its 16 pixels first, then their green and blue values.
+Vec4<u8> ReadRGBA8(const u32* buffer, int s, int t, int width)
+{
+  u16 sBlk = s >> 2;
+  u16 tBlk = t >> 2;
+  u16 widthBlks = (width + 3) >> 2;
+  u32 base = (tBlk * widthBlks + sBlk) << 5;
+  u16 blkS = s & 3;
+  u16 blkT = t & 3;
+  u32 blkOff = (blkT << 2) + blkS;
+
+  u32 offset = (base + blkOff) << 1;
+  const u8* valAddr = ((const u8*)buffer) + offset;
+
+  Vec4<u8> ret;
+  ret.r = valAddr[1];
+  ret.g = valAddr[32];
+  ret.b = valAddr[33];
+  ret.a = valAddr[0];
+  return ret;
+}
+
+void DetileRGBA8(const u32* buffer, int width, int height, Vec4<u8>* out)
+{
+  // The blocks are read in memory order, each row of a block goes to a row of out
+  const u8* block = reinterpret_cast<const u8*>(buffer);
+  for (int block_y = 0; block_y < height; block_y += 4)
+  {
+    const int rows = std::min(4, height - block_y);
+    for (int block_x = 0; block_x < width; block_x += 4, block += 64)
+    {
+      const int columns = std::min(4, width - block_x);
+      for (int row = 0; row < rows; ++row)
+      {
+        const u8* ar = block + 8 * row;
+        const u8* gb = ar + 32;
+        Vec4<u8>* dest = out + (block_y + row) * width + block_x;
+        for (int column = 0; column < columns; ++column)
+        {
+          dest[column].r = ar[2 * column + 1];
+          dest[column].g = gb[2 * column];
+          dest[column].b = gb[2 * column + 1];
+          dest[column].a = ar[2 * column];
+        }
+      }
+    }
+  }
+}
+
+int FindMismatch(const Vec4<u8>* actual, const Vec4<u8>* expected, int count)
+{
+  if (memcmp(actual, expected, count * sizeof(Vec4<u8>)) == 0)
+    return count;
+
+  for (int i = 0; i < count; ++i)
+  {
+    if (actual[i].r != expected[i].r || actual[i].g != expected[i].g ||
+        actual[i].b != expected[i].b || actual[i].a != expected[i].a)
+    {
+      return i;
+    }
+  }
+  return count;
+}
+}  // namespace GXTest
@@ -55,25 +55,34 @@ GXTest::Vec4<u8> GetIntensityColor(u8 r, u8 g, u8 b, u8 a)
   return { y_round, u_round, v_round, a };
 }
 
-void IntensityTest(u8 blue, bool unknown_yuv, bool intensity_fmt, bool auto_conv)
+// Queues the copy for IntensityTest, which the GPU can then do while the previous one is checked
+u16 StartIntensityCopy(int buffer, bool unknown_yuv, bool intensity_fmt, bool auto_conv)
+{
+  return GXTest::CopyToTestBufferAsync(buffer, 0, 0, 255, 255, {.unknown_bit = unknown_yuv, .intensity_fmt = intensity_fmt, .auto_conv = auto_conv});
+}
+
+// The copy IntensityTest checks, as rows of pixels
+static GXTest::Vec4<u8> s_pixels[256 * 256];
+
+void IntensityTest(u8 blue, bool unknown_yuv, bool intensity_fmt, bool auto_conv, int buffer, u16 token)
 {
   START_TEST();
 
-  GXTest::CopyToTestBuffer(0, 0, 255, 255, {.unknown_bit = unknown_yuv, .intensity_fmt = intensity_fmt, .auto_conv = auto_conv});
-  CGX_WaitForGpuToFinish();
+  GXTest::WaitForTestBuffer(buffer, token);
+  GXTest::DetileRGBA8(GXTest::test_buffers[buffer], 256, 256, s_pixels);
 
-  for (u32 x = 0; x < 256; x++)
+  const bool actually_is_intensity = intensity_fmt && auto_conv;
+  for (u32 y = 0; y < 256; y++)
   {
-    for (u32 y = 0; y < 256; y++)
-    {
-      GXTest::Vec4<u8> actual = GXTest::ReadTestBuffer(x, y, 256);
-      bool actually_is_intensity = intensity_fmt && auto_conv;
-      GXTest::Vec4<u8> expected = actually_is_intensity ? GetIntensityColor(x, y, blue, 255) : GXTest::Vec4<u8>{static_cast<u8>(x), static_cast<u8>(y), blue, 255};
-      DO_TEST(actual.r == expected.r, "Got wrong red   / y value for x {} y {} blue {}, {} {} {}: expected {}, was {}", x, y, blue, unknown_yuv, intensity_fmt, auto_conv, expected.r, actual.r);
-      DO_TEST(actual.g == expected.g, "Got wrong green / u value for x {} y {} blue {}, {} {} {}: expected {}, was {}", x, y, blue, unknown_yuv, intensity_fmt, auto_conv, expected.g, actual.g);
-      DO_TEST(actual.b == expected.b, "Got wrong blue  / v value for x {} y {} blue {}, {} {} {}: expected {}, was {}", x, y, blue, unknown_yuv, intensity_fmt, auto_conv, expected.b, actual.b);
-      DO_TEST(actual.a == expected.a, "Got wrong alpha     value for x {} y {} blue {}, {} {} {}: expected {}, was {}", x, y, blue, unknown_yuv, intensity_fmt, auto_conv, expected.a, actual.a);
-    }
+    GXTest::Vec4<u8> expected[256];
+    for (u32 x = 0; x < 256; x++)
+      expected[x] = actually_is_intensity ? GetIntensityColor(x, y, blue, 255) : GXTest::Vec4<u8>{static_cast<u8>(x), static_cast<u8>(y), blue, 255};
+
+    // Each row is a subtest, which reports its first wrong pixel
+    const GXTest::Vec4<u8>* actual = &s_pixels[y * 256];
+    const int x = GXTest::FindMismatch(actual, expected, 256);
+    const int shown_x = std::min(x, 255);
+    DO_TEST(x == 256, "Got wrong r/g/b/a (y/u/v/a) value for x {} y {} blue {}, {} {} {}: expected {}, was {}", x, y, blue, unknown_yuv, intensity_fmt, auto_conv, expected[shown_x], actual[shown_x]);
   }
 
   END_TEST();
@@ -89,14 +98,25 @@ int main()
   for (u32 blue = 0; blue < 256; blue++)
   {
     FillEFB(blue);
+
+    // The copy for the next counter is queued before checking the current one. FillEFB waits for
+    // the GPU, so no copy is still running when the EFB gets refilled.
+    u16 token = StartIntensityCopy(0, false, false, false);
     for (u32 counter = 0; counter < 8; counter++)
     {
+      const int buffer = counter % GXTest::NUM_TEST_BUFFERS;
+      const u32 next = counter + 1;
+      const u16 next_token = next < 8 ? StartIntensityCopy(next % GXTest::NUM_TEST_BUFFERS,
+                                                           next & 1, next & 2, next & 4) :
+                                        0;
+
       // The bit corresponding to unknown_yuv was renamed to "yuv" in Dolphin commit
       // 522746b2c223f37c45569ee7fd4a226b278cb6d9.  It's not clear why, and seems to do nothing.
       const bool unknown_yuv = (counter & 1);
       const bool intensity_fmt = (counter & 2);
       const bool auto_conv = (counter & 4);
-      IntensityTest(blue, unknown_yuv, intensity_fmt, auto_conv);
+      IntensityTest(blue, unknown_yuv, intensity_fmt, auto_conv, buffer, token);
+      token = next_token;
 
       WPAD_ScanPads();
       if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
@@ -20,17 +20,19 @@ void LightingTest()
   CGX_LOAD_BP_REG(CGXDefault<TwoTevStageOrders>(0).hex);
 
   CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);
-  wgPipe->U32 = 1;  // 1 color channel
+  cgx_sink.U32(1);  // 1 color channel
 
+  // The material color comes from the vertex color of each quad, so that a whole grid of
+  // material colors can be lit in one go. The ambient color changes every 256 quads.
   LitChannel chan;
   chan.hex = 0;
-  chan.matsource = 0;  // from register
+  chan.matsource = 1;  // from vertex
   chan.ambsource = 0;  // from register
   chan.enablelighting = true;
   CGX_BEGIN_LOAD_XF_REGS(0x100e, 1);  // color channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
   CGX_BEGIN_LOAD_XF_REGS(0x1010, 1);  // alpha channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
 
   CGX_LOAD_BP_REG(CGXDefault<TevStageCombiner::AlphaCombiner>(0).hex);
 
@@ -45,48 +47,47 @@ void LightingTest()
   ctrl.early_ztest = false;
   CGX_LOAD_BP_REG(ctrl.hex);
 
+  auto zmode = CGXDefault<ZMode>();
+  CGX_LOAD_BP_REG(zmode.hex);
+
+  CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
+  cgx_sink.U32(0);  // 0 = enable clipping, 1 = disable clipping
+
+  auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
+  cc.d = TevColorArg::RasColor;
+  CGX_LOAD_BP_REG(cc.hex);
+
   // Test to check how the hardware rounds the final computation of the
   // lit color of a vertex.  The formula is basically just
   // (material color * lighting color), but the rounding isn't obvious
   // because the hardware uses fixed-point math and takes some shortcuts.
-  for (int step = 0; step < 256 * 256; ++step)
+  constexpr int ambcolors_per_batch = 64;
+  static_assert(256 * ambcolors_per_batch <= GXTest::GRID_MAX_CELLS);
+  for (int first_ambcolor = 0; first_ambcolor < 256; first_ambcolor += ambcolors_per_batch)
   {
-    int matcolor = step & 255;
-    int ambcolor = step >> 8;
-
-    auto zmode = CGXDefault<ZMode>();
-    CGX_LOAD_BP_REG(zmode.hex);
-
-    auto tevreg = CGXDefault<TevReg>(1, false);  // c0
-    tevreg.ra.red = 0xff;
-    CGX_LOAD_BP_REG(tevreg.ra.hex);
-    CGX_LOAD_BP_REG(tevreg.bg.hex);
-
-    CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-    wgPipe->U32 = 0;  // 0 = enable clipping, 1 = disable clipping
-
-    CGX_BEGIN_LOAD_XF_REGS(0x100a, 1);
-    wgPipe->U32 = (ambcolor << 24) | 255;
-
-    CGX_BEGIN_LOAD_XF_REGS(0x100c, 1);
-    wgPipe->U32 = (matcolor << 24) | 255;
-
-    int test_x = 125, test_y = 25;  // Somewhere within the viewport
-
-    CGX_SetViewport(0.0f, 0.0f, 201.0f, 50.0f, 0.0f, 1.0f);
-    auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
-    cc.d = TevColorArg::RasColor;
-    CGX_LOAD_BP_REG(cc.hex);
-    GXTest::Quad().ColorRGBA(0, 0, 0, 0xff).Draw();
-
-    GXTest::CopyToTestBuffer(0, 0, 199, 49);
-    CGX_WaitForGpuToFinish();
-
-    GXTest::Vec4<u8> result = GXTest::ReadTestBuffer(test_x, test_y, 200);
-    int expected = (matcolor * (ambcolor + (ambcolor >> 7))) >> 8;
-    DO_TEST(result.r == expected, "lighting test failed at amb {} mat {} actual {}", ambcolor,
-            matcolor, result.r);
-
+    GXTest::DrawCellGrid(256 * ambcolors_per_batch, [first_ambcolor](int cell, GXTest::Quad& quad) {
+      const int matcolor = cell & 255;
+      if (matcolor == 0)
+      {
+        const int ambcolor = first_ambcolor + (cell >> 8);
+        CGX_BEGIN_LOAD_XF_REGS(0x100a, 1);
+        cgx_sink.U32((ambcolor << 24) | 255);
+      }
+      quad.ColorRGBA(matcolor, 0, 0, 0xff);
+    });
+
+    for (int cell = 0; cell < 256 * ambcolors_per_batch; ++cell)
+    {
+      const int matcolor = cell & 255;
+      const int ambcolor = first_ambcolor + (cell >> 8);
+      GXTest::Vec4<u8> result = GXTest::ReadCellGrid(cell);
+      int expected = (matcolor * (ambcolor + (ambcolor >> 7))) >> 8;
+      DO_TEST(result.r == expected, "lighting test failed at amb {} mat {} actual {}", ambcolor,
+              matcolor, result.r);
+    }
+
+    network_printf("Ambient colors %d-%d done\n", first_ambcolor,
+                   first_ambcolor + ambcolors_per_batch - 1);
     GXTest::DebugDisplayEfbContents();
     WPAD_ScanPads();
     if (WPAD_ButtonsDown(0) & WPAD_BUTTON_HOME)
@@ -0,0 +1,303 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Quad and QuadBatch only emit commands through cgx_sink, so unlike util.cpp, this also builds on
+// the host.
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gxtest/CPMemory.h"
+#include "gxtest/cgx.h"
+#include "gxtest/util.h"
+
+namespace GXTest
+{
+Quad::Quad()
+{
+  // top left
+  x[0] = -1.0;
+  y[0] = 1.0;
+  z[0] = 1.0;
+
+  // top right
+  x[1] = 1.0;
+  y[1] = 1.0;
+  z[1] = 1.0;
+
+  // bottom right
+  x[2] = 1.0;
+  y[2] = -1.0;
+  z[2] = 1.0;
+
+  // bottom left
+  x[3] = -1.0;
+  y[3] = -1.0;
+  z[3] = 1.0;
+
+  has_color = false;
+}
+
+Quad& Quad::VertexTopLeft(f32 x, f32 y, f32 z)
+{
+  this->x[0] = x;
+  this->y[0] = y;
+  this->z[0] = z;
+  return *this;
+}
+
+Quad& Quad::VertexTopRight(f32 x, f32 y, f32 z)
+{
+  this->x[1] = x;
+  this->y[1] = y;
+  this->z[1] = z;
+  return *this;
+}
+
+Quad& Quad::VertexBottomRight(f32 x, f32 y, f32 z)
+{
+  this->x[2] = x;
+  this->y[2] = y;
+  this->z[2] = z;
+  return *this;
+}
+
+Quad& Quad::VertexBottomLeft(f32 x, f32 y, f32 z)
+{
+  this->x[3] = x;
+  this->y[3] = y;
+  this->z[3] = z;
+  return *this;
+}
+
+Quad& Quad::AtDepth(f32 depth)
+{
+  z[0] = z[1] = z[2] = z[3] = depth;
+
+  return *this;
+}
+
+Quad& Quad::ColorRGBA(u8 r, u8 g, u8 b, u8 a)
+{
+  color = ((u32)r << 24) | ((u32)g << 16) | ((u32)b << 8) | (u32)a;
+  has_color = true;
+
+  return *this;
+}
+
+// Vertex format of Quad and QuadBatch vertices and the projection they're drawn with
+struct QuadVertexFormat
+{
+  TVtxDesc vtxdesc;
+  VAT vtxattr;
+  float projection[4][4];
+};
+
+static QuadVertexFormat GetQuadVertexFormat(bool has_color)
+{
+  QuadVertexFormat format;
+  VAT& vtxattr = format.vtxattr;
+  vtxattr.g0.Hex = 0;
+  vtxattr.g1.Hex = 0;
+  vtxattr.g2.Hex = 0;
+
+  vtxattr.g0.PosElements = VA_TYPE_POS_XYZ;
+  vtxattr.g0.PosFormat = VA_FMT_F32;
+
+  if (has_color)
+  {
+    vtxattr.g0.Color0Elements = VA_TYPE_CLR_RGBA;
+    vtxattr.g0.Color0Comp = VA_FMT_RGBA8;
+  }
+
+  // TODO: Figure out what this does and why it needs to be 1 for Dolphin not to error out
+  vtxattr.g0.ByteDequant = 1;
+
+  TVtxDesc& vtxdesc = format.vtxdesc;
+  vtxdesc.Hex = 0;
+  vtxdesc.Position = VTXATTR_DIRECT;
+
+  if (has_color)
+    vtxdesc.Color0 = VTXATTR_DIRECT;
+
+  /* TODO: Should reset this matrix..
+  float mtx[3][4];
+  memset(&mtx, 0, sizeof(mtx));
+  mtx[0][0] = 1.0;
+  mtx[1][1] = 1.0;
+  mtx[2][2] = 1.0;
+  CGX_LoadPosMatrixDirect(mtx, 0);*/
+
+  memset(format.projection, 0, sizeof(format.projection));
+  format.projection[0][0] = 1;
+  format.projection[1][1] = 1;
+  format.projection[2][2] = -1;
+  return format;
+}
+
+static void SetupQuadVertexFormat(bool has_color)
+{
+  QuadVertexFormat format = GetQuadVertexFormat(has_color);
+
+  // TODO: Not sure if the order of these two is correct
+  CGX_LOAD_CP_REG(0x50, format.vtxdesc.Hex0);
+  CGX_LOAD_CP_REG(0x60, format.vtxdesc.Hex1);
+
+  CGX_LOAD_CP_REG(0x70, format.vtxattr.g0.Hex);
+  CGX_LOAD_CP_REG(0x80, format.vtxattr.g1.Hex);
+  CGX_LOAD_CP_REG(0x90, format.vtxattr.g2.Hex);
+
+  CGX_LoadProjectionMatrixOrthographic(format.projection);
+}
+
+void Quad::Draw()
+{
+  SetupQuadVertexFormat(has_color);
+
+  cgx_sink.U8(0x80);  // draw quads
+  cgx_sink.U16(4);    // 4 vertices
+
+  for (int i = 0; i < 4; ++i)
+  {
+    cgx_sink.F32(x[i]);
+    cgx_sink.F32(y[i]);
+    cgx_sink.F32(z[i]);
+
+    if (has_color)
+      cgx_sink.U32(color);
+  }
+}
+
+void Quad::Draw(CGXDisplayList& list)
+{
+  QuadVertexFormat format = GetQuadVertexFormat(has_color);
+
+  list.LoadCPReg(0x50, format.vtxdesc.Hex0);
+  list.LoadCPReg(0x60, format.vtxdesc.Hex1);
+
+  list.LoadCPReg(0x70, format.vtxattr.g0.Hex);
+  list.LoadCPReg(0x80, format.vtxattr.g1.Hex);
+  list.LoadCPReg(0x90, format.vtxattr.g2.Hex);
+
+  list.LoadProjectionMatrixOrthographic(format.projection);
+
+  list.BeginDraw(0x80, 4);  // draw 4 quad vertices
+  for (int i = 0; i < 4; ++i)
+  {
+    list.WriteF32(x[i]);
+    list.WriteF32(y[i]);
+    list.WriteF32(z[i]);
+
+    if (has_color)
+      list.WriteU32(color);
+  }
+}
+
+// The draw command is staged right before the vertices, which start at the second 32-byte block
+// of the buffer. The NOPs in front of it are harmless in a display list.
+constexpr u32 QUAD_BATCH_VERTEX_OFFSET = 32;
+constexpr u32 QUAD_BATCH_COMMAND_OFFSET = QUAD_BATCH_VERTEX_OFFSET - 3;
+constexpr u32 QUAD_BATCH_MAX_VERTEX_SIZE = 4 * sizeof(u32);
+
+QuadBatch::QuadBatch(int max_quads) : max_quads(max_quads), num_quads(0), has_color(false)
+{
+  assert(max_quads > 0 && max_quads <= MAX_QUADS);
+
+  const u32 size = QUAD_BATCH_VERTEX_OFFSET + max_quads * 4 * QUAD_BATCH_MAX_VERTEX_SIZE;
+  buffer = (u8*)memalign(32, size);
+  memset(buffer, 0, size);
+}
+
+QuadBatch::~QuadBatch()
+{
+  free(buffer);
+}
+
+u32 QuadBatch::GetVertexSize() const
+{
+  return has_color ? 4 * sizeof(u32) : 3 * sizeof(u32);
+}
+
+QuadBatch& QuadBatch::Add(const Quad& quad)
+{
+  assert(num_quads < max_quads);
+  if (num_quads == 0)
+    has_color = quad.has_color;
+  assert(quad.has_color == has_color);
+
+  u32* vertex = (u32*)(buffer + QUAD_BATCH_VERTEX_OFFSET + num_quads * 4 * GetVertexSize());
+  for (int i = 0; i < 4; ++i)
+  {
+    memcpy(&vertex[0], &quad.x[i], sizeof(u32));
+    memcpy(&vertex[1], &quad.y[i], sizeof(u32));
+    memcpy(&vertex[2], &quad.z[i], sizeof(u32));
+    if (has_color)
+      vertex[3] = quad.color;
+    vertex += GetVertexSize() / sizeof(u32);
+  }
+
+  ++num_quads;
+  return *this;
+}
+
+void QuadBatch::Clear()
+{
+  num_quads = 0;
+}
+
+void QuadBatch::Draw()
+{
+  if (num_quads == 0)
+    return;
+
+  SetupQuadVertexFormat(has_color);
+
+  cgx_sink.U8(0x80);  // draw quads
+  cgx_sink.U16(num_quads * 4);
+
+  const u32* words = (const u32*)(buffer + QUAD_BATCH_VERTEX_OFFSET);
+  const u32 num_words = num_quads * 4 * GetVertexSize() / sizeof(u32);
+  for (u32 i = 0; i < num_words; ++i)
+    cgx_sink.U32(words[i]);
+}
+
+void QuadBatch::DrawAsDisplayList()
+{
+  if (num_quads == 0)
+    return;
+
+  SetupQuadVertexFormat(has_color);
+
+  const u16 num_vertices = num_quads * 4;
+  buffer[QUAD_BATCH_COMMAND_OFFSET] = 0x80;  // draw quads
+  buffer[QUAD_BATCH_COMMAND_OFFSET + 1] = num_vertices >> 8;
+  buffer[QUAD_BATCH_COMMAND_OFFSET + 2] = num_vertices & 0xff;
+
+  // Pad with NOPs up to the next 32-byte boundary
+  const u32 end = QUAD_BATCH_VERTEX_OFFSET + num_vertices * GetVertexSize();
+  const u32 size = (end + 31) & ~31;
+  memset(buffer + end, 0, size - end);
+
+  CGX_CallDisplayList(buffer, size);
+}
+
+Quad GetCellGridQuad(int cell)
+{
+  // Clip space to pixels: x = (x_clip + 1) * 320, y = (1 - y_clip) * 264
+  const int column = cell % GRID_COLUMNS;
+  const int row = cell / GRID_COLUMNS;
+  const f32 left = column * GRID_CELL_SIZE / 320.0f - 1.0f;
+  const f32 right = (column + 1) * GRID_CELL_SIZE / 320.0f - 1.0f;
+  const f32 top = 1.0f - row * GRID_CELL_SIZE / 264.0f;
+  const f32 bottom = 1.0f - (row + 1) * GRID_CELL_SIZE / 264.0f;
+
+  Quad quad;
+  quad.VertexTopLeft(left, top, 1.0f)
+      .VertexTopRight(right, top, 1.0f)
+      .VertexBottomRight(right, bottom, 1.0f)
+      .VertexBottomLeft(left, bottom, 1.0f);
+  return quad;
+}
+}  // namespace GXTest
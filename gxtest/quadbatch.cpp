@@ -0,0 +1,165 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ogc/lwp_watchdog.h>
+#include <ogcsys.h>
+#include <wiiuse/wpad.h>
+#include "Common/hwtests.h"
+#include "Common/timebase.h"
+#include "gxtest/cgx.h"
+#include "gxtest/cgx_defaults.h"
+#include "gxtest/util.h"
+
+// Draws a full grid of colored cells with a QuadBatch, both through the write-gather pipe and as
+// a display list, and checks every cell. Then measures how fast vertices get into the
+// write-gather pipe with one Quad::Draw per quad, with QuadBatch::Draw and with a display list.
+
+// As many full rows of cells as fit into one batch
+constexpr int NUM_CELLS =
+    GXTest::QuadBatch::MAX_QUADS / GXTest::GRID_COLUMNS * GXTest::GRID_COLUMNS;
+
+static GXTest::Vec4<u8> GetCellColor(int cell)
+{
+  return {{static_cast<u8>(cell), static_cast<u8>(cell >> 8), static_cast<u8>(~cell * 7), 0xff}};
+}
+
+static void FillBatch(GXTest::QuadBatch& batch)
+{
+  batch.Clear();
+  for (int cell = 0; cell < NUM_CELLS; ++cell)
+  {
+    const GXTest::Vec4<u8> color = GetCellColor(cell);
+    batch.Add(GXTest::GetCellGridQuad(cell).ColorRGBA(color.r, color.g, color.b, color.a));
+  }
+}
+
+static void SetupQuadBatchTest()
+{
+  CGX_LOAD_BP_REG(CGXDefault<TwoTevStageOrders>(0).hex);
+
+  CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);
+  cgx_sink.U32(1);  // 1 color channel
+
+  LitChannel chan;
+  chan.hex = 0;
+  chan.matsource = 1;                 // from vertex
+  CGX_BEGIN_LOAD_XF_REGS(0x100e, 1);  // color channel 1
+  cgx_sink.U32(chan.hex);
+  CGX_BEGIN_LOAD_XF_REGS(0x1010, 1);  // alpha channel 1
+  cgx_sink.U32(chan.hex);
+
+  CGX_LOAD_BP_REG(CGXDefault<TevStageCombiner::AlphaCombiner>(0).hex);
+
+  auto genmode = CGXDefault<GenMode>();
+  genmode.numtevstages = 0;  // One stage
+  CGX_LOAD_BP_REG(genmode.hex);
+
+  PEControl ctrl;
+  ctrl.hex = BPMEM_ZCOMPARE << 24;
+  ctrl.pixel_format = PixelFormat::RGB8_Z24;
+  ctrl.zformat = DepthFormat::ZLINEAR;
+  ctrl.early_ztest = false;
+  CGX_LOAD_BP_REG(ctrl.hex);
+
+  CGX_LOAD_BP_REG(CGXDefault<ZMode>().hex);
+
+  CGX_LoadXFReg(0x1005, 0);  // 0 = enable clipping, 1 = disable clipping
+
+  auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
+  cc.d = TevColorArg::RasColor;
+  CGX_LOAD_BP_REG(cc.hex);
+
+  CGX_SetViewport(0.0f, 0.0f, 640.0f, 528.0f, 0.0f, 1.0f);
+}
+
+static void CheckCellGrid(const char* method)
+{
+  GXTest::CopyCellGrid(NUM_CELLS);
+  for (int cell = 0; cell < NUM_CELLS; ++cell)
+  {
+    const GXTest::Vec4<u8> result = GXTest::ReadCellGrid(cell);
+    const GXTest::Vec4<u8> expected = GetCellColor(cell);
+    DO_TEST(result.r == expected.r && result.g == expected.g && result.b == expected.b,
+            "{} cell {}: got {:02x}{:02x}{:02x}, expected {:02x}{:02x}{:02x}", method, cell,
+            result.r, result.g, result.b, expected.r, expected.g, expected.b);
+  }
+}
+
+static void QuadBatchTest(GXTest::QuadBatch& batch)
+{
+  START_TEST();
+
+  FillBatch(batch);
+  batch.Draw();
+  CheckCellGrid("QuadBatch::Draw");
+
+  // Start from a different picture, so that a display list that doesn't run can't pass
+  GXTest::Quad().ColorRGBA(0, 0, 0, 0xff).Draw();
+  batch.DrawAsDisplayList();
+  CheckCellGrid("QuadBatch::DrawAsDisplayList");
+
+  END_TEST();
+}
+
+static u64 GetVerticesPerSecond(u64 ticks)
+{
+  return u64{NUM_CELLS} * 4 * TB_TIMER_CLOCK * 1000 / (ticks ? ticks : 1);
+}
+
+static void PrintVerticesPerSecond(const char* method, u64 submit_ticks, u64 total_ticks)
+{
+  network_printf("%-28s %10llu vertices/second submitted, %10llu drawn\n", method,
+                 GetVerticesPerSecond(submit_ticks), GetVerticesPerSecond(total_ticks));
+}
+
+// Submission stops once the last vertex is in the write-gather pipe (or, for the display list,
+// once the call is), drawing once the GPU is done
+static void QuadBatchBenchmark(GXTest::QuadBatch& batch)
+{
+  CGX_WaitForGpuToFinish();
+
+  u64 start_tb = GetTimebase();
+  for (int cell = 0; cell < NUM_CELLS; ++cell)
+  {
+    const GXTest::Vec4<u8> color = GetCellColor(cell);
+    GXTest::GetCellGridQuad(cell).ColorRGBA(color.r, color.g, color.b, color.a).Draw();
+  }
+  u64 submit_ticks = GetTimebase() - start_tb;
+  CGX_WaitForGpuToFinish();
+  PrintVerticesPerSecond("Quad::Draw", submit_ticks, GetTimebase() - start_tb);
+
+  start_tb = GetTimebase();
+  FillBatch(batch);
+  network_printf("%-28s %10llu vertices/second staged\n", "QuadBatch::Add",
+                 GetVerticesPerSecond(GetTimebase() - start_tb));
+
+  start_tb = GetTimebase();
+  batch.Draw();
+  submit_ticks = GetTimebase() - start_tb;
+  CGX_WaitForGpuToFinish();
+  PrintVerticesPerSecond("QuadBatch::Draw", submit_ticks, GetTimebase() - start_tb);
+
+  start_tb = GetTimebase();
+  batch.DrawAsDisplayList();
+  submit_ticks = GetTimebase() - start_tb;
+  CGX_WaitForGpuToFinish();
+  PrintVerticesPerSecond("QuadBatch::DrawAsDisplayList", submit_ticks, GetTimebase() - start_tb);
+}
+
+int main()
+{
+  network_init();
+  WPAD_Init();
+
+  GXTest::Init();
+
+  SetupQuadBatchTest();
+  GXTest::QuadBatch batch(NUM_CELLS);
+  QuadBatchTest(batch);
+  QuadBatchBenchmark(batch);
+
+  network_printf("Shutting down...\n");
+  network_shutdown();
+
+  return 0;
+}
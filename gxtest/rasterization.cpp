@@ -4,15 +4,54 @@
 
 #include <initializer_list>
 #include <math.h>
+#include <ogc/lwp_watchdog.h>
 #include <ogcsys.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wiiuse/wpad.h>
+#include "Common/BitUtils.h"
 #include "Common/hwtests.h"
+#include "Common/timebase.h"
 #include "gxtest/cgx.h"
 #include "gxtest/cgx_defaults.h"
 #include "gxtest/util.h"
 
+// Clears the area and draws the quad whose coverage is tested, with the viewport at xpos, into
+// list if there is one and straight to the FIFO otherwise. Returns the offset of the viewport in
+// list.
+static u32 SendCoverageSetup(float xpos, CGXDisplayList* list)
+{
+  const auto draw = [list](GXTest::Quad& quad) {
+    if (list)
+      quad.Draw(*list);
+    else
+      quad.Draw();
+  };
+
+  u32 viewport_offset = 0;
+  if (list)
+    viewport_offset = list->SetViewport(xpos, 0.0f, 100.0f, 100.0f, 0.0f, 1.0f);
+  else
+    CGX_SetViewport(xpos, 0.0f, 100.0f, 100.0f, 0.0f, 1.0f);
+
+  // first off, clear the full area.
+  draw(GXTest::Quad()
+           .VertexTopLeft(-2.0, 2.0, 1.0)
+           .VertexBottomLeft(-2.0, -2.0, 1.0)
+           .VertexTopRight(2.0, 2.0, 1.0)
+           .VertexBottomRight(2.0, -2.0, 1.0)
+           .ColorRGBA(0, 0, 0, 255));
+  draw(GXTest::Quad().ColorRGBA(0, 255, 0, 255));
+
+  // now, draw the actual testing quad.
+  draw(GXTest::Quad()
+           .VertexTopLeft(0, 1.0, 1.0)
+           .VertexBottomLeft(0, -1.0, 1.0)
+           .ColorRGBA(255, 0, 255, 255));
+
+  return viewport_offset;
+}
+
 void CoordinatePrecisionTest()
 {
   START_TEST();
@@ -20,15 +59,15 @@ void CoordinatePrecisionTest()
   CGX_LOAD_BP_REG(CGXDefault<TwoTevStageOrders>(0).hex);
 
   CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);
-  wgPipe->U32 = 1;  // 1 color channel
+  cgx_sink.U32(1);  // 1 color channel
 
   LitChannel chan;
   chan.hex = 0;
   chan.matsource = 1;                 // from vertex
   CGX_BEGIN_LOAD_XF_REGS(0x100e, 1);  // color channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
   CGX_BEGIN_LOAD_XF_REGS(0x1010, 1);  // alpha channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
 
   auto ac = CGXDefault<TevStageCombiner::AlphaCombiner>(0);
   ac.d = TevAlphaArg::RasAlpha;
@@ -40,26 +79,31 @@ void CoordinatePrecisionTest()
 
   // Test at which coordinates a pixel is considered to be within a primitive.
   // TODO: Not sure how to interpret the results, yet.
-  for (float xpos = 0.583328247070f; xpos <= 0.583328306675f; xpos = nextafterf(xpos, +1.0f))
+  // Only the viewport changes between iterations, so everything is recorded once and the viewport
+  // gets patched.
+  // The setup is also sent directly once, to compare the cost of both ways.
+  const float first_xpos = 0.583328247070f;
+  u64 start_tb = GetTimebase();
+  SendCoverageSetup(first_xpos, nullptr);
+  const u64 direct_ticks = GetTimebase() - start_tb;
+
+  CGXDisplayList list(1024);
+  start_tb = GetTimebase();
+  const u32 viewport_offset = SendCoverageSetup(first_xpos, &list);
+  u64 record_ticks = GetTimebase() - start_tb;
+  u64 call_ticks = 0;
+  u32 num_calls = 0;
+  network_printf("First setup: %llu ns to send directly, %llu ns to record\n",
+                 direct_ticks * 1000000 / TB_TIMER_CLOCK, record_ticks * 1000000 / TB_TIMER_CLOCK);
+
+  for (float xpos = first_xpos; xpos <= 0.583328306675f; xpos = nextafterf(xpos, +1.0f))
   {
-    CGX_SetViewport(xpos, 0.0f, 100.0f, 100.0f, 0.0f, 1.0f);
-
-    // first off, clear the full area.
-    GXTest::Quad()
-        .VertexTopLeft(-2.0, 2.0, 1.0)
-        .VertexBottomLeft(-2.0, -2.0, 1.0)
-        .VertexTopRight(2.0, 2.0, 1.0)
-        .VertexBottomRight(2.0, -2.0, 1.0)
-        .ColorRGBA(0, 0, 0, 255)
-        .Draw();
-    GXTest::Quad().ColorRGBA(0, 255, 0, 255).Draw();
+    start_tb = GetTimebase();
+    list.PatchViewport(viewport_offset, xpos, 0.0f, 100.0f, 100.0f, 0.0f, 1.0f);
+    list.Call();
+    call_ticks += GetTimebase() - start_tb;
+    ++num_calls;
 
-    // now, draw the actual testing quad.
-    GXTest::Quad()
-        .VertexTopLeft(0, 1.0, 1.0)
-        .VertexBottomLeft(0, -1.0, 1.0)
-        .ColorRGBA(255, 0, 255, 255)
-        .Draw();
     GXTest::CopyToTestBuffer(50, 0, 127, 127);
     CGX_WaitForGpuToFinish();
     GXTest::DebugDisplayEfbContents();
@@ -80,35 +124,44 @@ void CoordinatePrecisionTest()
   // screen position 7/12.
   // I (neobrain) am not sure if the sample indeed is not at that location or if it's just due to
   // floating point rounding errors.
+  list.Clear();
+  start_tb = GetTimebase();
+  list.SetViewport(0.0, 0.0f, 100.0f, 100.0f, 0.0f, 1.0f);
+
+  // first off, clear the full area.
+  GXTest::Quad()
+      .VertexTopLeft(-2.0, 2.0, 1.0)
+      .VertexBottomLeft(-2.0, -2.0, 1.0)
+      .VertexTopRight(2.0, 2.0, 1.0)
+      .VertexBottomRight(2.0, -2.0, 1.0)
+      .ColorRGBA(0, 0, 0, 255)
+      .Draw(list);
+  GXTest::Quad().ColorRGBA(0, 255, 0, 255).Draw(list);
+
+  // manual viewport setting to make sure we aren't limited (too much) by floating point precision
+  // 2.0e-5 seems to be the smallest possible viewport width which behaves sane.
+  // For this size, values of xpos from 0.583297729492 to 0.583328247070 will yield a covered
+  // pixel
+  const float vp_width = 2.0e-5f;
+  const u32 manual_viewport[] = {
+      Common::BitCast<u32>(vp_width), Common::BitCast<u32>(-50.0f),
+      Common::BitCast<u32>(16777215.0f), 0,  // x origin, patched below
+      Common::BitCast<u32>(392.0f), Common::BitCast<u32>(16777215.0f),
+  };
+  const u32 x_origin_offset = list.LoadXFRegs(0x101a, manual_viewport, 6) + 3 * sizeof(u32);
+
+  // now, draw the actual testing quad.
+  GXTest::Quad().ColorRGBA(255, 0, 255, 255).Draw(list);
+  record_ticks += GetTimebase() - start_tb;
+
   for (float xpos = 0.583297669888f; xpos <= 0.583328306675; xpos = nextafterf(xpos, +1.0f))
   {
-    CGX_SetViewport(0.0, 0.0f, 100.0f, 100.0f, 0.0f, 1.0f);
+    start_tb = GetTimebase();
+    list.PatchF32(x_origin_offset, 342.0f + xpos + vp_width);
+    list.Call();
+    call_ticks += GetTimebase() - start_tb;
+    ++num_calls;
 
-    // first off, clear the full area.
-    GXTest::Quad()
-        .VertexTopLeft(-2.0, 2.0, 1.0)
-        .VertexBottomLeft(-2.0, -2.0, 1.0)
-        .VertexTopRight(2.0, 2.0, 1.0)
-        .VertexBottomRight(2.0, -2.0, 1.0)
-        .ColorRGBA(0, 0, 0, 255)
-        .Draw();
-    GXTest::Quad().ColorRGBA(0, 255, 0, 255).Draw();
-
-    // manual viewport setting to make sure we aren't limited (too much) by floating point precision
-    // 2.0e-5 seems to be the smallest possible viewport width which behaves sane.
-    // For this size, values of xpos from 0.583297729492 to 0.583328247070 will yield a covered
-    // pixel
-    float vp_width = 2.0e-5f;
-    CGX_BEGIN_LOAD_XF_REGS(0x101a, 6);
-    wgPipe->F32 = vp_width;
-    wgPipe->F32 = -50.0f;
-    wgPipe->F32 = 16777215.0f;
-    wgPipe->F32 = 342.0f + xpos + vp_width;
-    wgPipe->F32 = 392.0f;
-    wgPipe->F32 = 16777215.0f;
-
-    // now, draw the actual testing quad.
-    GXTest::Quad().ColorRGBA(255, 0, 255, 255).Draw();
     GXTest::CopyToTestBuffer(0, 0, 127, 127);
     CGX_WaitForGpuToFinish();
     GXTest::DebugDisplayEfbContents();
@@ -121,6 +174,10 @@ void CoordinatePrecisionTest()
             result.r, expectation, xpos, subsample_index);
   }
 
+  network_printf("Setup: %llu ns to record, %llu ns per patched display list call\n",
+                 record_ticks * 1000000 / TB_TIMER_CLOCK,
+                 call_ticks * 1000000 / TB_TIMER_CLOCK / (num_calls ? num_calls : 1));
+
   // Guardband clipping indeed uses floating point math!
   // Hence, the smallest floating point value smaller than -2.0 will yield a clipped primitive.
   CGX_SetViewport(100.0f, 100.0f, 100.0f, 100.0f, 0.0f, 1.0f);
@@ -2,12 +2,15 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <initializer_list>
 #include <math.h>
 #include <ogcsys.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wiiuse/wpad.h>
+#include "Common/Random.h"
+#include "Common/Shrink.h"
 #include "Common/hwtests.h"
 #include "gxtest/cgx.h"
 #include "gxtest/cgx_defaults.h"
@@ -35,6 +38,135 @@ int TevCombinerExpectation(int a, int b, int c, int d, TevScale scale, TevBias b
   return expected;
 }
 
+// One configuration of the randomized combiner test. The stage computes d +/- lerp(a, b, c) with
+// the inputs in the red channels of c0, c1, c2 and prev.
+struct TevCombinerCase
+{
+  int a;
+  int b;
+  int c;
+  int d;
+  TevScale scale;
+  TevBias bias;
+  TevOp op;
+  bool clamp;
+};
+
+// Loads a TEV color register. Like libogc's GX_SetTevColorS10, the second half is written three
+// times, since back-to-back draws with different values otherwise pick up the old value.
+static void LoadTevColor(const TevReg& tevreg)
+{
+  CGX_LOAD_BP_REG(tevreg.ra.hex);
+  CGX_LOAD_BP_REG(tevreg.bg.hex);
+  CGX_LOAD_BP_REG(tevreg.bg.hex);
+  CGX_LOAD_BP_REG(tevreg.bg.hex);
+}
+
+// TEV stage configured by the case, output in PREV.
+static TevStageCombiner::ColorCombiner TevCombinerCaseCC(const TevCombinerCase& tc)
+{
+  auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
+  cc.a = TevColorArg::Color0;
+  cc.b = TevColorArg::Color1;
+  cc.c = TevColorArg::Color2;
+  // NOTE: TevColorArg::PrevColor doesn't actually seem to fetch its data from PREV when used in
+  // the first stage?
+  cc.d = TevColorArg::Zero;  // TevColorArg::PrevColor;
+  cc.scale = tc.scale;
+  cc.bias = tc.bias;
+  cc.op = tc.op;
+  cc.clamp = tc.clamp;
+  return cc;
+}
+
+// Loads the stage and the registers of a case, everything except GenMode and PEControl
+static void LoadTevCombinerCase(const TevCombinerCase& tc)
+{
+  CGX_LOAD_BP_REG(TevCombinerCaseCC(tc).hex);
+
+  auto tevreg = CGXDefault<TevReg>(1, false);  // c0
+  tevreg.ra.red = tc.a;
+  LoadTevColor(tevreg);
+  tevreg = CGXDefault<TevReg>(2, false);  // c1
+  tevreg.ra.red = tc.b;
+  LoadTevColor(tevreg);
+  tevreg = CGXDefault<TevReg>(3, false);  // c2
+  tevreg.ra.red = tc.c;
+  LoadTevColor(tevreg);
+  tevreg = CGXDefault<TevReg>(0, false);  // prev
+  tevreg.ra.red = tc.d;
+  LoadTevColor(tevreg);
+}
+
+static void LoadTevCombinerPixelFormat()
+{
+  PEControl ctrl;
+  ctrl.hex = BPMEM_ZCOMPARE << 24;
+  ctrl.pixel_format = PixelFormat::RGB8_Z24;
+  ctrl.zformat = DepthFormat::ZLINEAR;
+  ctrl.early_ztest = false;
+  CGX_LOAD_BP_REG(ctrl.hex);
+}
+
+// Runs a single case on its own, which is slow but independent of the batching
+static int RunTevCombinerCase(const TevCombinerCase& tc,
+                              const TevStageCombiner::AlphaCombiner& ac)
+{
+  auto genmode = CGXDefault<GenMode>();
+  genmode.numtevstages = 0;  // One stage
+  CGX_LOAD_BP_REG(genmode.hex);
+
+  LoadTevCombinerCase(tc);
+  LoadTevCombinerPixelFormat();
+
+  return GXTest::GetTevOutput(genmode, TevCombinerCaseCC(tc), ac).r;
+}
+
+// Operands shrink towards zero, the other settings towards the plain lerp.
+static const ShrinkStep<TevCombinerCase> TEV_COMBINER_SHRINK_STEPS[] = {
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.a, 0); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.b, 0); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.c, 0); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.d, 0); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.scale, TevScale::Scale1); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.bias, TevBias::Zero); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.op, TevOp::Add); },
+    [](TevCombinerCase& tc) { return ShrinkToValue(tc.clamp, false); },
+    [](TevCombinerCase& tc) { return ShrinkHalfway(tc.a, 0); },
+    [](TevCombinerCase& tc) { return ShrinkHalfway(tc.b, 0); },
+    [](TevCombinerCase& tc) { return ShrinkHalfway(tc.c, 0); },
+    [](TevCombinerCase& tc) { return ShrinkHalfway(tc.d, 0); },
+    [](TevCombinerCase& tc) { return ShrinkByOne(tc.a, 0); },
+    [](TevCombinerCase& tc) { return ShrinkByOne(tc.b, 0); },
+    [](TevCombinerCase& tc) { return ShrinkByOne(tc.c, 0); },
+    [](TevCombinerCase& tc) { return ShrinkByOne(tc.d, 0); },
+};
+
+static void ReportMinimalTevCombinerCase(const TevCombinerCase& failing,
+                                         const TevStageCombiner::AlphaCombiner& ac)
+{
+  const auto result =
+      Shrink(failing, TEV_COMBINER_SHRINK_STEPS, [&ac](const TevCombinerCase& tc) {
+        return RunTevCombinerCase(tc, ac) !=
+               TevCombinerExpectation(tc.a, tc.b, tc.c, tc.d, tc.scale, tc.bias, tc.op, tc.clamp);
+      });
+
+  if (!result.reproduced)
+  {
+    network_printf("Failure did not reproduce when rerun\n");
+    return;
+  }
+
+  const TevCombinerCase& tc = result.minimal;
+  const std::string message = fmt::format(
+      "Minimal failing case after {} runs: a={}, b={}, c={}, d={}, shift={}, bias={}, op={}, "
+      "clamp={}: expected {}, got {}\n",
+      result.runs, tc.a, tc.b, tc.c, tc.d, tc.scale, tc.bias, tc.op, tc.clamp,
+      TevCombinerExpectation(tc.a, tc.b, tc.c, tc.d, tc.scale, tc.bias, tc.op, tc.clamp),
+      RunTevCombinerCase(tc, ac));
+  network_printf("%s", message.c_str());
+}
+
 void TevCombinerTest()
 {
   START_TEST();
@@ -42,132 +174,95 @@ void TevCombinerTest()
   CGX_LOAD_BP_REG(CGXDefault<TwoTevStageOrders>(0).hex);
 
   CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);
-  wgPipe->U32 = 1;  // 1 color channel
+  cgx_sink.U32(1);  // 1 color channel
 
   LitChannel chan;
   chan.hex = 0;
   chan.matsource = 1;                 // from vertex
   CGX_BEGIN_LOAD_XF_REGS(0x100e, 1);  // color channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
   CGX_BEGIN_LOAD_XF_REGS(0x1010, 1);  // alpha channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
 
   auto ac = CGXDefault<TevStageCombiner::AlphaCombiner>(0);
   CGX_LOAD_BP_REG(ac.hex);
 
-  // Test if we can reliably extract all bits of the tev combiner output...
-  auto tevreg = CGXDefault<TevReg>(1, false);  // c0
-  for (int i = 0; i < 2; ++i)
-    for (tevreg.ra.red = -1024; tevreg.ra.red != 1023; tevreg.ra.red = tevreg.ra.red + 1)
-    {
-      CGX_LOAD_BP_REG(tevreg.ra.hex);
-      CGX_LOAD_BP_REG(tevreg.bg.hex);
-
-      auto genmode = CGXDefault<GenMode>();
-      genmode.numtevstages = 0;  // One stage
-      CGX_LOAD_BP_REG(genmode.hex);
-
-      auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
-      cc.d = TevColorArg::Color0;
-      CGX_LOAD_BP_REG(cc.hex);
-
-      PEControl ctrl;
-      ctrl.hex = BPMEM_ZCOMPARE << 24;
-      ctrl.zformat = DepthFormat::ZLINEAR;
-      ctrl.early_ztest = false;
-      if (i == 0)
-      {
-        // 8 bits per channel: No worries about GetTevOutput making
-        // mistakes when writing to framebuffer or when performing
-        // an EFB copy.
-        ctrl.pixel_format = PixelFormat::RGB8_Z24;
-        CGX_LOAD_BP_REG(ctrl.hex);
-
-        int result = GXTest::GetTevOutput(genmode, cc, ac).r;
-
-        DO_TEST(result == tevreg.ra.red, "Got {}, expected {}", result, tevreg.ra.red);
-      }
-      else
-      {
-        // TODO: This doesn't quite work, yet.
-        break;
-
-        // 6 bits per channel: Implement GetTevOutput functionality
-        // manually, to verify how tev output is truncated to 6 bit
-        // and how EFB copies upscale that to 8 bit again.
-        ctrl.pixel_format = PixelFormat::RGBA6_Z24;
-        CGX_LOAD_BP_REG(ctrl.hex);
-
-        GXTest::Quad().AtDepth(1.0).ColorRGBA(255, 255, 255, 255).Draw();
-        GXTest::CopyToTestBuffer(0, 0, 99, 9);
-        CGX_ForcePipelineFlush();
-        CGX_WaitForGpuToFinish();
-        u16 result = GXTest::ReadTestBuffer(5, 5, 100).r;
-
-        int expected = (((tevreg.ra.red + 1) >> 2) & 0xFF) << 2;
-        expected = expected | (expected >> 6);
-        DO_TEST(result == expected, "Run {}: Got {}, expected {}", tevreg.ra.red, result,
-                expected);
-      }
-    }
-
-  // Now: Randomized testing of tev combiners.
-  for (int i = 0x000000; i < 0x000F000; ++i)
-  {
-    if ((i & 0xFF00) == i)
-      network_printf("progress: %x\n", i);
+  auto genmode = CGXDefault<GenMode>();
+  genmode.numtevstages = 0;  // One stage
+  CGX_LOAD_BP_REG(genmode.hex);
 
-    auto genmode = CGXDefault<GenMode>();
-    genmode.numtevstages = 0;  // One stage
-    CGX_LOAD_BP_REG(genmode.hex);
+  static GXTest::Vec4<int> outputs[GXTest::GRID_MAX_CELLS];
 
-    // Randomly configured TEV stage, output in PREV.
+  // Test if we can reliably extract all bits of the tev combiner output...
+  // 8 bits per channel: No worries about GetTevOutputs making
+  // mistakes when writing to framebuffer or when performing
+  // an EFB copy.
+  {
     auto cc = CGXDefault<TevStageCombiner::ColorCombiner>(0);
-    cc.a = TevColorArg::Color0;
-    cc.b = TevColorArg::Color1;
-    cc.c = TevColorArg::Color2;
-    cc.d = TevColorArg::Zero;  // TevColorArg::PrevColor; // NOTE: TevColorArg::PrevColor doesn't actually seem
-                              // to fetch its data from PREV when used in the first stage?
-    cc.scale = static_cast<TevScale>(rand() % 4);
-    cc.bias = static_cast<TevBias>(rand() % 3);
-    cc.op = static_cast<TevOp>(rand() % 2);
-    cc.clamp = static_cast<bool>(rand() % 2);
+    cc.d = TevColorArg::Color0;
     CGX_LOAD_BP_REG(cc.hex);
 
-    int a = -1024 + (rand() % 2048);
-    int b = -1024 + (rand() % 2048);
-    int c = -1024 + (rand() % 2048);
-    int d = 0;                              //-1024 + (rand() % 2048);
-    tevreg = CGXDefault<TevReg>(1, false);  // c0
-    tevreg.ra.red = a;
-    CGX_LOAD_BP_REG(tevreg.ra.hex);
-    CGX_LOAD_BP_REG(tevreg.bg.hex);
-    tevreg = CGXDefault<TevReg>(2, false);  // c1
-    tevreg.ra.red = b;
-    CGX_LOAD_BP_REG(tevreg.ra.hex);
-    CGX_LOAD_BP_REG(tevreg.bg.hex);
-    tevreg = CGXDefault<TevReg>(3, false);  // c2
-    tevreg.ra.red = c;
-    CGX_LOAD_BP_REG(tevreg.ra.hex);
-    CGX_LOAD_BP_REG(tevreg.bg.hex);
-    tevreg = CGXDefault<TevReg>(0, false);  // prev
-    tevreg.ra.red = d;
-    CGX_LOAD_BP_REG(tevreg.ra.hex);
-    CGX_LOAD_BP_REG(tevreg.bg.hex);
+    LoadTevCombinerPixelFormat();
 
-    PEControl ctrl;
-    ctrl.hex = BPMEM_ZCOMPARE << 24;
-    ctrl.pixel_format = PixelFormat::RGB8_Z24;
-    ctrl.zformat = DepthFormat::ZLINEAR;
-    ctrl.early_ztest = false;
-    CGX_LOAD_BP_REG(ctrl.hex);
+    // One cell for each value from -1024 to 1022
+    constexpr int num_values = 2047;
+    GXTest::GetTevOutputs(
+        genmode, cc, ac, num_values,
+        [](int cell) {
+          auto tevreg = CGXDefault<TevReg>(1, false);  // c0
+          tevreg.ra.red = cell - 1024;
+          LoadTevColor(tevreg);
+        },
+        outputs);
 
-    int result = GXTest::GetTevOutput(genmode, cc, ac).r;
+    for (int cell = 0; cell < num_values; ++cell)
+    {
+      DO_TEST(outputs[cell].r == cell - 1024, "Got {}, expected {}", outputs[cell].r,
+              cell - 1024);
+    }
+  }
 
-    int expected = TevCombinerExpectation(a, b, c, d, cc.scale, cc.bias, cc.op, cc.clamp);
-    DO_TEST(result == expected, "Mismatch on a={}, b={}, c={}, d={}, shift={}, bias={}, op={}, "
-                                "clamp={}: expected {}, got {}",
-            a, b, c, d, cc.scale, cc.bias, cc.op, cc.clamp, expected, result);
+  // TODO: The readback of TEV outputs through the RGBA6 pixel format is untested.
+
+  // Now: Randomized testing of tev combiners, a whole grid of cases per pair of render passes.
+  Random random(GetTestSeed());
+  LoadTevCombinerPixelFormat();
+  constexpr int num_random_cases = 0xF000;
+  static TevCombinerCase cases[GXTest::GRID_MAX_CELLS];
+  for (int first = 0; first < num_random_cases; first += GXTest::GRID_MAX_CELLS)
+  {
+    network_printf("progress: %x\n", first);
+
+    const int count = std::min(num_random_cases - first, GXTest::GRID_MAX_CELLS);
+    for (int i = 0; i < count; ++i)
+    {
+      TevCombinerCase& tc = cases[i];
+      tc.scale = static_cast<TevScale>(random.NextBelow(4));
+      tc.bias = static_cast<TevBias>(random.NextBelow(3));
+      tc.op = static_cast<TevOp>(random.NextBelow(2));
+      tc.clamp = random.NextBool();
+      tc.a = random.NextInRange(-1024, 1023);
+      tc.b = random.NextInRange(-1024, 1023);
+      tc.c = random.NextInRange(-1024, 1023);
+      tc.d = 0;  // random.NextInRange(-1024, 1023);
+    }
+
+    // All cases use the same stage, so the first one stands in for the dest registers
+    GXTest::GetTevOutputs(genmode, TevCombinerCaseCC(cases[0]), ac, count,
+                          [](int cell) { LoadTevCombinerCase(cases[cell]); }, outputs);
+
+    for (int i = 0; i < count; ++i)
+    {
+      const TevCombinerCase& tc = cases[i];
+      int result = outputs[i].r;
+      int expected = TevCombinerExpectation(tc.a, tc.b, tc.c, tc.d, tc.scale, tc.bias, tc.op,
+                                            tc.clamp);
+      DO_TEST(result == expected, "Mismatch on a={}, b={}, c={}, d={}, shift={}, bias={}, op={}, "
+                                  "clamp={}: expected {}, got {}",
+              tc.a, tc.b, tc.c, tc.d, tc.scale, tc.bias, tc.op, tc.clamp, expected, result);
+      if (result != expected)
+        ReportMinimalTevCombinerCase(tc, ac);
+    }
 
     WPAD_ScanPads();
 
@@ -210,7 +305,7 @@ void TevCombinerTest()
     ctrl.early_ztest = false;
     CGX_LOAD_BP_REG(ctrl.hex);
 
-    tevreg = CGXDefault<TevReg>(1, false);  // c0
+    auto tevreg = CGXDefault<TevReg>(1, false);  // c0
     tevreg.ra.red = 127;                       // 127 is always NOT less than 127.
     CGX_LOAD_BP_REG(tevreg.ra.hex);
     CGX_LOAD_BP_REG(tevreg.bg.hex);
@@ -241,7 +336,7 @@ void KonstTest()
   CGX_LOAD_BP_REG(CGXDefault<TwoTevStageOrders>(0).hex);
 
   CGX_BEGIN_LOAD_XF_REGS(0x1009, 1);
-  wgPipe->U32 = 1;  // 1 color channel
+  cgx_sink.U32(1);  // 1 color channel
 
   LitChannel chan;
   chan.hex = 0;
@@ -249,9 +344,9 @@ void KonstTest()
   chan.ambsource = 0;  // from register
   chan.enablelighting = false;
   CGX_BEGIN_LOAD_XF_REGS(0x100e, 1);  // color channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
   CGX_BEGIN_LOAD_XF_REGS(0x1010, 1);  // alpha channel 1
-  wgPipe->U32 = chan.hex;
+  cgx_sink.U32(chan.hex);
 
   auto genmode = CGXDefault<GenMode>();
   genmode.numtevstages = 1;  // Two stages
@@ -265,7 +360,7 @@ void KonstTest()
   CGX_LOAD_BP_REG(ctrl.hex);
 
   CGX_BEGIN_LOAD_XF_REGS(0x1005, 1);
-  wgPipe->U32 = 0;  // 0 = enable clipping, 1 = disable clipping
+  cgx_sink.U32(0);  // 0 = enable clipping, 1 = disable clipping
 
   // Set up "konst" colors with recognizable values.
   for (int i = 0; i < 4; ++i)
@@ -393,6 +488,11 @@ int main()
   TevCombinerTest();
   KonstTest();
 
+  const CGXShadowStats& stats = CGX_GetShadowStats();
+  network_printf("Dropped %u BP, %u CP and %u XF register writes (%u bytes)\n",
+                 stats.suppressed_bp_writes, stats.suppressed_cp_writes, stats.suppressed_xf_writes,
+                 stats.suppressed_bytes);
+
   network_printf("Shutting down...\n");
   network_shutdown();
 
@@ -8,15 +8,27 @@
 #include <ogc/video.h>
 #include <string.h>
 
+#include "Common/hwtests.h"
 #include "gxtest/cgx.h"
 #include "gxtest/cgx_defaults.h"
 #include "gxtest/util.h"
 
 //#define ENABLE_DEBUG_DISPLAY
 
+// Writes a FIFO log of every EFB copy to sd:/hwtests/<source file>_<test number>_<copy>.dff, see
+// CGX_EnableFifoLogs. The test is the one running when the copy was done, which for the test
+// buffer helpers is the one that waits for it.
+//#define ENABLE_FIFO_LOGS
+
+#ifdef ENABLE_FIFO_LOGS
+#include <fat.h>
+#include <sys/stat.h>
+#endif
+
 namespace GXTest
 {
 #define TEST_BUFFER_SIZE (640 * 528 * 4)
+u32* test_buffers[NUM_TEST_BUFFERS];
 u32* test_buffer;
 
 #ifdef ENABLE_DEBUG_DISPLAY
@@ -28,6 +40,30 @@ float yscale;
 u32 xfbHeight;
 #endif
 
+#ifdef ENABLE_FIFO_LOGS
+static const char* s_test_file = "init";
+static int s_test_number = 0;
+
+static void OnTestStart(const char* file, int test_number)
+{
+  s_test_file = file;
+  s_test_number = test_number;
+}
+
+static void WriteFifoLog(u32 copy, const FifoLog& log)
+{
+  const char* name = strrchr(s_test_file, '/');
+  name = name ? name + 1 : s_test_file;
+  const int name_length = strcspn(name, ".");
+
+  char path[256];
+  snprintf(path, sizeof(path), "sd:/hwtests/%.*s_%d_%u.dff", name_length, name, s_test_number,
+           copy);
+  if (!CGX_WriteFifoLog(log, path))
+    network_printf("Couldn't write %s\n", path);
+}
+#endif
+
 void Init()
 {
   GXColor background = {0, 0x27, 0, 0xff};
@@ -68,7 +104,9 @@ void Init()
   GX_SetScissor(0, 0, 640, 528);
 #endif
 
-  test_buffer = (u32*)memalign(32, 640 * 528 * 4);
+  for (u32*& buffer : test_buffers)
+    buffer = (u32*)memalign(32, TEST_BUFFER_SIZE);
+  test_buffer = test_buffers[0];
 
   GX_SetTexCopySrc(0, 0, 100, 100);
   GX_SetTexCopyDst(100, 100, GX_TF_RGBA8, false);
@@ -85,7 +123,7 @@ void Init()
 
   Mtx model;
   guMtxIdentity(model);
-  GX_LoadPosMtxImm(model, GX_PNMTX0);
+  CGX_LoadPosMatrixDirect(model, GX_PNMTX0);
 
   float mtx[4][4];
   memset(mtx, 0, sizeof(mtx));
@@ -126,6 +164,8 @@ void Init()
 
   GX_End();
   GX_Flush();
+  // libogc wrote all sorts of registers behind the shadow's back
+  CGX_InvalidateShadowRegs();
 
   PEControl ctrl;
   ctrl.hex = BPMEM_ZCOMPARE << 24;
@@ -133,6 +173,14 @@ void Init()
   ctrl.zformat = DepthFormat::ZLINEAR;
   ctrl.early_ztest = false;
   CGX_LOAD_BP_REG(ctrl.hex);
+
+#ifdef ENABLE_FIFO_LOGS
+  // Last, so that the logs start with everything libogc set up
+  fatInitDefault();
+  mkdir("sd:/hwtests", 0777);
+  CGX_EnableFifoLogs(WriteFifoLog);
+  SetTestHooks(OnTestStart, nullptr);
+#endif
 }
 
 void DebugDisplayEfbContents()
@@ -150,158 +198,12 @@ void DebugDisplayEfbContents()
 
 Vec4<u8> ReadTestBuffer(int s, int t, int width)
 {
-  u16 sBlk = s >> 2;
-  u16 tBlk = t >> 2;
-  u16 widthBlks = (width + 3) >> 2;
-  u32 base = (tBlk * widthBlks + sBlk) << 5;
-  u16 blkS = s & 3;
-  u16 blkT = t & 3;
-  u32 blkOff = (blkT << 2) + blkS;
-
-  u32 offset = (base + blkOff) << 1;
-  const u8* valAddr = ((u8*)test_buffer) + offset;
-
-  Vec4<u8> ret;
-  ret.r = valAddr[1];
-  ret.g = valAddr[32];
-  ret.b = valAddr[33];
-  ret.a = valAddr[0];
-  return ret;
-}
-
-Quad::Quad()
-{
-  // top left
-  x[0] = -1.0;
-  y[0] = 1.0;
-  z[0] = 1.0;
-
-  // top right
-  x[1] = 1.0;
-  y[1] = 1.0;
-  z[1] = 1.0;
-
-  // bottom right
-  x[2] = 1.0;
-  y[2] = -1.0;
-  z[2] = 1.0;
-
-  // bottom left
-  x[3] = -1.0;
-  y[3] = -1.0;
-  z[3] = 1.0;
-
-  has_color = false;
-}
-
-Quad& Quad::VertexTopLeft(f32 x, f32 y, f32 z)
-{
-  this->x[0] = x;
-  this->y[0] = y;
-  this->z[0] = z;
-  return *this;
-}
-
-Quad& Quad::VertexTopRight(f32 x, f32 y, f32 z)
-{
-  this->x[1] = x;
-  this->y[1] = y;
-  this->z[1] = z;
-  return *this;
-}
-
-Quad& Quad::VertexBottomRight(f32 x, f32 y, f32 z)
-{
-  this->x[2] = x;
-  this->y[2] = y;
-  this->z[2] = z;
-  return *this;
-}
-
-Quad& Quad::VertexBottomLeft(f32 x, f32 y, f32 z)
-{
-  this->x[3] = x;
-  this->y[3] = y;
-  this->z[3] = z;
-  return *this;
-}
-
-Quad& Quad::AtDepth(f32 depth)
-{
-  z[0] = z[1] = z[2] = z[3] = depth;
-
-  return *this;
-}
-
-Quad& Quad::ColorRGBA(u8 r, u8 g, u8 b, u8 a)
-{
-  color = ((u32)r << 24) | ((u32)g << 16) | ((u32)b << 8) | (u32)a;
-  has_color = true;
-
-  return *this;
+  return ReadTestBuffer(0, s, t, width);
 }
 
-void Quad::Draw()
+Vec4<u8> ReadTestBuffer(int buffer, int s, int t, int width)
 {
-  VAT vtxattr;
-  vtxattr.g0.Hex = 0;
-  vtxattr.g1.Hex = 0;
-  vtxattr.g2.Hex = 0;
-
-  vtxattr.g0.PosElements = VA_TYPE_POS_XYZ;
-  vtxattr.g0.PosFormat = VA_FMT_F32;
-
-  if (has_color)
-  {
-    vtxattr.g0.Color0Elements = VA_TYPE_CLR_RGBA;
-    vtxattr.g0.Color0Comp = VA_FMT_RGBA8;
-  }
-
-  // TODO: Figure out what this does and why it needs to be 1 for Dolphin not to error out
-  vtxattr.g0.ByteDequant = 1;
-
-  TVtxDesc vtxdesc;
-  vtxdesc.Hex = 0;
-  vtxdesc.Position = VTXATTR_DIRECT;
-
-  if (has_color)
-    vtxdesc.Color0 = VTXATTR_DIRECT;
-
-  // TODO: Not sure if the order of these two is correct
-  CGX_LOAD_CP_REG(0x50, vtxdesc.Hex0);
-  CGX_LOAD_CP_REG(0x60, vtxdesc.Hex1);
-
-  CGX_LOAD_CP_REG(0x70, vtxattr.g0.Hex);
-  CGX_LOAD_CP_REG(0x80, vtxattr.g1.Hex);
-  CGX_LOAD_CP_REG(0x90, vtxattr.g2.Hex);
-
-  /* TODO: Should reset this matrix..
-  float mtx[3][4];
-  memset(&mtx, 0, sizeof(mtx));
-  mtx[0][0] = 1.0;
-  mtx[1][1] = 1.0;
-  mtx[2][2] = 1.0;
-  CGX_LoadPosMatrixDirect(mtx, 0);*/
-
-  float mtx[4][4];
-  memset(mtx, 0, sizeof(mtx));
-  mtx[0][0] = 1;
-  mtx[1][1] = 1;
-  mtx[2][2] = -1;
-  CGX_LoadProjectionMatrixOrthographic(mtx);
-
-  wgPipe->U8 = 0x80;  // draw quads
-  wgPipe->U16 = 4;    // 4 vertices
-
-  for (int i = 0; i < 4; ++i)
-  {
-    wgPipe->F32 = x[i];
-    wgPipe->F32 = y[i];
-    wgPipe->F32 = z[i];
-
-    if (has_color)
-      wgPipe->U32 = color;
-  }
+  return ReadRGBA8(test_buffers[buffer], s, t, width);
 }
 
 void CopyToTestBuffer(int left_most_pixel, int top_most_pixel, int right_most_pixel,
@@ -313,140 +215,236 @@ void CopyToTestBuffer(int left_most_pixel, int top_most_pixel, int right_most_pi
                    bottom_most_pixel - top_most_pixel + 1, test_buffer, params);
 }
 
-Vec4<int> GetTevOutput(const GenMode& genmode, const TevStageCombiner::ColorCombiner& last_cc,
-                       const TevStageCombiner::AlphaCombiner& last_ac)
+// TEV registers holding the output of the last stage, which the readback stages read from
+struct TevReadbackInputs
 {
+  int previous_stage;
   TevColorArg color_reg;
+  TevAlphaArg alpha_reg;
+};
+
+static TevReadbackInputs GetTevReadbackInputs(const TevStageCombiner::ColorCombiner& last_cc,
+                                              const TevStageCombiner::AlphaCombiner& last_ac)
+{
+  TevReadbackInputs inputs;
   switch (last_cc.dest)
   {
   case TevOutput::Prev:
   default:
-    color_reg = TevColorArg::PrevColor;
+    inputs.color_reg = TevColorArg::PrevColor;
     break;
   case TevOutput::Color0:
-    color_reg = TevColorArg::Color0;
+    inputs.color_reg = TevColorArg::Color0;
     break;
   case TevOutput::Color1:
-    color_reg = TevColorArg::Color1;
+    inputs.color_reg = TevColorArg::Color1;
     break;
   case TevOutput::Color2:
-    color_reg = TevColorArg::Color2;
+    inputs.color_reg = TevColorArg::Color2;
     break;
   }
-  TevAlphaArg alpha_reg;
   switch (last_ac.dest)
   {
   case TevOutput::Prev:
   default:
-    alpha_reg = TevAlphaArg::PrevAlpha;
+    inputs.alpha_reg = TevAlphaArg::PrevAlpha;
     break;
   case TevOutput::Color0:
-    alpha_reg = TevAlphaArg::Alpha0;
+    inputs.alpha_reg = TevAlphaArg::Alpha0;
     break;
   case TevOutput::Color1:
-    alpha_reg = TevAlphaArg::Alpha1;
+    inputs.alpha_reg = TevAlphaArg::Alpha1;
     break;
   case TevOutput::Color2:
-    alpha_reg = TevAlphaArg::Alpha2;
+    inputs.alpha_reg = TevAlphaArg::Alpha2;
     break;
   }
-  int previous_stage = ((last_cc.hex >> 24) - BPMEM_TEV_COLOR_ENV) >> 1;
-  assert(previous_stage < 13);
-  assert(previous_stage == (((last_ac.hex >> 24) - BPMEM_TEV_ALPHA_ENV) >> 1));
-
-  // The TEV output gets truncated to 8 bits when writing to the EFB.
-  // Hence, we cannot retrieve all 11 TEV output bits directly.
-  // Instead, we're performing two render passes, one of which retrieves
-  // the lower 6 output bits, the other one of which retrieves the upper
-  // 5 bits.
+  inputs.previous_stage = ((last_cc.hex >> 24) - BPMEM_TEV_COLOR_ENV) >> 1;
+  assert(inputs.previous_stage < 13);
+  assert(inputs.previous_stage == (((last_ac.hex >> 24) - BPMEM_TEV_ALPHA_ENV) >> 1));
+  return inputs;
+}
 
-  // FIRST RENDER PASS:
-  // As set up by the caller, with one additional tev stage multiplying the result by 4.
-  // This will retrieve the lower 6 bits of the TEV output.
+// The TEV output gets truncated to 8 bits when writing to the EFB.
+// Hence, we cannot retrieve all 11 TEV output bits directly.
+// Instead, we're performing two render passes, one of which retrieves
+// the lower 6 output bits, the other one of which retrieves the upper
+// 5 bits.
 
+// FIRST RENDER PASS:
+// As set up by the caller, with one additional tev stage multiplying the result by 4.
+// This will retrieve the lower 6 bits of the TEV output.
+static void SetupTevReadbackLowBits(const GenMode& genmode, const TevReadbackInputs& inputs)
+{
   auto gm = genmode;
-  gm.numtevstages = previous_stage + 1;  // one additional stage
+  gm.numtevstages = inputs.previous_stage + 1;  // one additional stage
   CGX_LOAD_BP_REG(gm.hex);
 
   // Enable new TEV stage. Note that we are using the "a" input here to make
   // sure the input doesn't get erroneously clamped to 11 bit range.
-  auto cc1 = CGXDefault<TevStageCombiner::ColorCombiner>(previous_stage + 1);
-  cc1.a = color_reg;
+  auto cc1 = CGXDefault<TevStageCombiner::ColorCombiner>(inputs.previous_stage + 1);
+  cc1.a = inputs.color_reg;
   cc1.scale = TevScale::Scale4;
   CGX_LOAD_BP_REG(cc1.hex);
 
-  auto ac1 = CGXDefault<TevStageCombiner::AlphaCombiner>(previous_stage + 1);
-  ac1.a = alpha_reg;
+  auto ac1 = CGXDefault<TevStageCombiner::AlphaCombiner>(inputs.previous_stage + 1);
+  ac1.a = inputs.alpha_reg;
   ac1.scale = TevScale::Scale4;
   CGX_LOAD_BP_REG(ac1.hex);
+}
 
-  memset(test_buffer, 0, TEST_BUFFER_SIZE);  // Just for debugging
-  Quad().AtDepth(1.0).ColorRGBA(255, 255, 255, 255).Draw();
-  CGX_DoEfbCopyTex(0, 0, 100, 100, test_buffer);
-  CGX_ForcePipelineFlush();
-  CGX_WaitForGpuToFinish();
-  u16 result1r = ReadTestBuffer(5, 5, 100).r >> 2;
-  u16 result1g = ReadTestBuffer(5, 5, 100).g >> 2;
-  u16 result1b = ReadTestBuffer(5, 5, 100).b >> 2;
-  u16 result1a = ReadTestBuffer(5, 5, 100).a >> 2;
-
-  // SECOND RENDER PASS
-  // Uses three additional TEV stages which shift the previous result
-  // three bits to the right. This is necessary to read off the 5 upper bits,
-  // 3 of which got masked off when writing to the EFB in the first pass.
-  gm.hex = genmode.hex;
-  gm.numtevstages = previous_stage + 3;  // three additional stages
+// SECOND RENDER PASS
+// Uses three additional TEV stages which shift the previous result
+// three bits to the right. This is necessary to read off the 5 upper bits,
+// 3 of which got masked off when writing to the EFB in the first pass.
+static void SetupTevReadbackHighBits(const GenMode& genmode, const TevReadbackInputs& inputs)
+{
+  auto gm = genmode;
+  gm.numtevstages = inputs.previous_stage + 3;  // three additional stages
   CGX_LOAD_BP_REG(gm.hex);
 
   // The following tev stages are exclusively used to rightshift the
   // upper bits such that they get written to the render target.
-  cc1 = CGXDefault<TevStageCombiner::ColorCombiner>(previous_stage + 1);
-  cc1.d = color_reg;
-  cc1.scale = TevScale::Divide2;
-  CGX_LOAD_BP_REG(cc1.hex);
+  for (int stage = inputs.previous_stage + 1; stage <= inputs.previous_stage + 3; ++stage)
+  {
+    auto cc1 = CGXDefault<TevStageCombiner::ColorCombiner>(stage);
+    cc1.d = inputs.color_reg;
+    cc1.scale = TevScale::Divide2;
+    CGX_LOAD_BP_REG(cc1.hex);
+
+    auto ac1 = CGXDefault<TevStageCombiner::AlphaCombiner>(stage);
+    ac1.d = inputs.alpha_reg;
+    ac1.scale = TevScale::Divide2;
+    CGX_LOAD_BP_REG(ac1.hex);
+  }
+}
 
-  ac1 = CGXDefault<TevStageCombiner::AlphaCombiner>(previous_stage + 1);
-  ac1.d = alpha_reg;
-  ac1.scale = TevScale::Divide2;
-  CGX_LOAD_BP_REG(ac1.hex);
+// Puts together one channel from the EFB values of the two passes
+static int CombineTevReadback(u8 low_pass, u8 high_pass)
+{
+  const int low = low_pass >> 2;
+  const int high = high_pass >> 3;
 
-  cc1 = CGXDefault<TevStageCombiner::ColorCombiner>(previous_stage + 2);
-  cc1.d = color_reg;
-  cc1.scale = TevScale::Divide2;
-  CGX_LOAD_BP_REG(cc1.hex);
+  // uh.. let's just say this works, but I guess it could be simplified.
+  return low + ((high & 0x10) ? (-0x400 + ((high & 0xF) << 6)) : (high << 6));
+}
 
-  ac1 = CGXDefault<TevStageCombiner::AlphaCombiner>(previous_stage + 2);
-  ac1.d = alpha_reg;
-  ac1.scale = TevScale::Divide2;
-  CGX_LOAD_BP_REG(ac1.hex);
+static Vec4<int> CombineTevReadback(const Vec4<u8>& low_pass, const Vec4<u8>& high_pass)
+{
+  Vec4<int> result;
+  result.r = CombineTevReadback(low_pass.r, high_pass.r);
+  result.g = CombineTevReadback(low_pass.g, high_pass.g);
+  result.b = CombineTevReadback(low_pass.b, high_pass.b);
+  result.a = CombineTevReadback(low_pass.a, high_pass.a);
+  return result;
+}
 
-  cc1 = CGXDefault<TevStageCombiner::ColorCombiner>(previous_stage + 3);
-  cc1.d = color_reg;
-  cc1.scale = TevScale::Divide2;
-  CGX_LOAD_BP_REG(cc1.hex);
+u16 CopyToTestBufferAsync(int buffer, int left_most_pixel, int top_most_pixel,
+                          int right_most_pixel, int bottom_most_pixel, const EFBCopyParams& params)
+{
+  CGX_DoEfbCopyTex(left_most_pixel, top_most_pixel, right_most_pixel - left_most_pixel + 1,
+                   bottom_most_pixel - top_most_pixel + 1, test_buffers[buffer], params);
+  return CGX_SendToken();
+}
 
-  ac1 = CGXDefault<TevStageCombiner::AlphaCombiner>(previous_stage + 3);
-  ac1.d = alpha_reg;
-  ac1.scale = TevScale::Divide2;
-  CGX_LOAD_BP_REG(ac1.hex);
+void WaitForTestBuffer(int buffer, u16 token)
+{
+  CGX_WaitForToken(token);
+
+  // Drop anything the CPU might have pulled into the cache while the copy was running
+  DCInvalidateRange(test_buffers[buffer], TEST_BUFFER_SIZE);
+}
+
+Vec4<int> GetTevOutput(const GenMode& genmode, const TevStageCombiner::ColorCombiner& last_cc,
+                       const TevStageCombiner::AlphaCombiner& last_ac)
+{
+  const TevReadbackInputs inputs = GetTevReadbackInputs(last_cc, last_ac);
+
+  SetupTevReadbackLowBits(genmode, inputs);
+
+  memset(test_buffer, 0, TEST_BUFFER_SIZE);  // Just for debugging
+  Quad().AtDepth(1.0).ColorRGBA(255, 255, 255, 255).Draw();
+  CGX_DoEfbCopyTex(0, 0, 100, 100, test_buffer);
+  CGX_ForcePipelineFlush();
+  CGX_WaitForGpuToFinish();
+  const Vec4<u8> low_pass = ReadTestBuffer(5, 5, 100);
+
+  SetupTevReadbackHighBits(genmode, inputs);
 
   memset(test_buffer, 0, TEST_BUFFER_SIZE);
   Quad().AtDepth(1.0).ColorRGBA(255, 255, 255, 255).Draw();
   CGX_DoEfbCopyTex(0, 0, 100, 100, test_buffer);
   CGX_ForcePipelineFlush();
   CGX_WaitForGpuToFinish();
+  const Vec4<u8> high_pass = ReadTestBuffer(5, 5, 100);
 
-  u16 result2r = ReadTestBuffer(5, 5, 100).r >> 3;
-  u16 result2g = ReadTestBuffer(5, 5, 100).g >> 3;
-  u16 result2b = ReadTestBuffer(5, 5, 100).b >> 3;
-  u16 result2a = ReadTestBuffer(5, 5, 100).a >> 3;
+  return CombineTevReadback(low_pass, high_pass);
+}
 
-  // uh.. let's just say this works, but I guess it could be simplified.
-  Vec4<int> result;
-  result.r = result1r + ((result2r & 0x10) ? (-0x400 + ((result2r & 0xF) << 6)) : (result2r << 6));
-  result.g = result1g + ((result2g & 0x10) ? (-0x400 + ((result2g & 0xF) << 6)) : (result2g << 6));
-  result.b = result1b + ((result2b & 0x10) ? (-0x400 + ((result2b & 0xF) << 6)) : (result2b << 6));
-  result.a = result1a + ((result2a & 0x10) ? (-0x400 + ((result2a & 0xF) << 6)) : (result2a << 6));
-  return result;
+void CopyCellGrid(int count)
+{
+  const int rows = (count + GRID_COLUMNS - 1) / GRID_COLUMNS;
+  CGX_DoEfbCopyTex(0, 0, 640, rows * GRID_CELL_SIZE, test_buffer);
+  CGX_ForcePipelineFlush();
+  CGX_WaitForGpuToFinish();
+}
+
+void DrawCellGrid(int count, const std::function<void(int cell, Quad& quad)>& setup_cell)
+{
+  assert(count > 0 && count <= GRID_MAX_CELLS);
+
+  CGX_SetViewport(0.0f, 0.0f, 640.0f, 528.0f, 0.0f, 1.0f);
+
+  for (int cell = 0; cell < count; ++cell)
+  {
+    Quad quad = GetCellGridQuad(cell);
+    setup_cell(cell, quad);
+    quad.Draw();
+  }
+
+  CopyCellGrid(count);
+}
+
+Vec4<u8> ReadCellGrid(int cell)
+{
+  // Away from the quad edges
+  const int x = (cell % GRID_COLUMNS) * GRID_CELL_SIZE + GRID_CELL_SIZE / 2;
+  const int y = (cell / GRID_COLUMNS) * GRID_CELL_SIZE + GRID_CELL_SIZE / 2;
+  return ReadTestBuffer(x, y, 640);
+}
+
+void GetTevOutputs(const GenMode& genmode, const TevStageCombiner::ColorCombiner& last_cc,
+                   const TevStageCombiner::AlphaCombiner& last_ac, int count,
+                   const std::function<void(int cell)>& setup_cell, Vec4<int>* outputs)
+{
+  const TevReadbackInputs inputs = GetTevReadbackInputs(last_cc, last_ac);
+  const auto draw_cell = [&setup_cell](int cell, Quad& quad) {
+    setup_cell(cell);
+    quad.ColorRGBA(255, 255, 255, 255);
+  };
+
+  // Keep the low pass in outputs until the high pass is in the test buffer
+  SetupTevReadbackLowBits(genmode, inputs);
+  DrawCellGrid(count, draw_cell);
+  for (int cell = 0; cell < count; ++cell)
+  {
+    const Vec4<u8> low_pass = ReadCellGrid(cell);
+    outputs[cell].r = low_pass.r;
+    outputs[cell].g = low_pass.g;
+    outputs[cell].b = low_pass.b;
+    outputs[cell].a = low_pass.a;
+  }
+
+  SetupTevReadbackHighBits(genmode, inputs);
+  DrawCellGrid(count, draw_cell);
+  for (int cell = 0; cell < count; ++cell)
+  {
+    Vec4<u8> low_pass;
+    low_pass.r = static_cast<u8>(outputs[cell].r);
+    low_pass.g = static_cast<u8>(outputs[cell].g);
+    low_pass.b = static_cast<u8>(outputs[cell].b);
+    low_pass.a = static_cast<u8>(outputs[cell].a);
+    outputs[cell] = CombineTevReadback(low_pass, ReadCellGrid(cell));
+  }
 }
 }
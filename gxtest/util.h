@@ -4,10 +4,17 @@
 
 #pragma once
 
+#include <fmt/format.h>
+#include <functional>
+
 #include "cgx.h"
 
 namespace GXTest
 {
+// Test buffers that the GPU can copy to while the CPU checks the previous copy.
+// test_buffer is the first one, which the functions without a buffer index use.
+constexpr int NUM_TEST_BUFFERS = 2;
+extern u32* test_buffers[NUM_TEST_BUFFERS];
 extern u32* test_buffer;
 
 // Four component vector with arbitrary base type
@@ -41,13 +48,54 @@ public:
 
   void Draw();
 
+  // Records the draw (including the vertex format and projection setup) into a display list
+  void Draw(CGXDisplayList& list);
+
 private:
+  friend class QuadBatch;
+
   f32 x[4], y[4], z[4];
 
   bool has_color;
   u32 color;
 };
 
+// Utility class to draw many quads with a single draw command
+// The vertices of the added quads are staged in a 32-byte aligned buffer, which is either sent
+// through the write-gather pipe or handed to the GPU as a display list. Either way, the vertex
+// format and the projection are only set up once per batch.
+class QuadBatch
+{
+public:
+  // Limited by the 16 bit vertex count of the draw command
+  static constexpr int MAX_QUADS = 0xffff / 4;
+
+  explicit QuadBatch(int max_quads);
+  ~QuadBatch();
+
+  QuadBatch(const QuadBatch&) = delete;
+  QuadBatch& operator=(const QuadBatch&) = delete;
+
+  // Either all quads of a batch have a color, or none of them
+  QuadBatch& Add(const Quad& quad);
+  void Clear();
+  int GetNumQuads() const { return num_quads; }
+
+  void Draw();
+
+  // The GPU reads the vertices from the staging buffer by itself, so the batch must not be
+  // changed until the GPU is done with it
+  void DrawAsDisplayList();
+
+private:
+  u32 GetVertexSize() const;
+
+  u8* buffer;
+  int max_quads;
+  int num_quads;
+  bool has_color;
+};
+
 // Initialize CGX and GXTest
 void Init();
 
@@ -64,6 +112,50 @@ void CopyToTestBuffer(int left_most_pixel, int top_most_pixel, int right_most_pi
 // After that, this function is free to use in terms of performance.
 Vec4<u8> ReadTestBuffer(int x, int y, int previous_copy_width);
 
+// Queue an RGBA8 EFB copy to one of the test buffers without waiting for it.
+// Returns the PE token to pass to WaitForTestBuffer before reading the buffer.
+u16 CopyToTestBufferAsync(int buffer, int left_most_pixel, int top_most_pixel,
+                          int right_most_pixel, int bottom_most_pixel,
+                          const EFBCopyParams& params = {});
+
+// Wait for a copy queued by CopyToTestBufferAsync
+void WaitForTestBuffer(int buffer, u16 token);
+
+Vec4<u8> ReadTestBuffer(int buffer, int x, int y, int previous_copy_width);
+
+// Reads one pixel of an RGBA8 copy of the given width, like ReadTestBuffer
+Vec4<u8> ReadRGBA8(const u32* buffer, int x, int y, int width);
+
+// Converts a whole RGBA8 copy into rows of pixels, out[y * width + x]. Tests that check every
+// pixel should use this instead of ReadTestBuffer: it goes through the copy once, block by block,
+// rather than working out the position of each pixel and jumping between blocks.
+void DetileRGBA8(const u32* buffer, int width, int height, Vec4<u8>* out);
+
+// Index of the first pixel that differs between two rows, or count if they're the same
+int FindMismatch(const Vec4<u8>* actual, const Vec4<u8>* expected, int count);
+
+// Grid of small quads for tests that check many configurations per EFB copy. Each cell is a 4x4
+// pixel quad (one block of the RGBA8 copy), and the grid covers the top 640x512 pixels of the EFB.
+constexpr int GRID_CELL_SIZE = 4;
+constexpr int GRID_COLUMNS = 640 / GRID_CELL_SIZE;
+constexpr int GRID_ROWS = 512 / GRID_CELL_SIZE;
+constexpr int GRID_MAX_CELLS = GRID_COLUMNS * GRID_ROWS;
+
+// Quad covering the given cell, without a color
+Quad GetCellGridQuad(int cell);
+
+// Copies the rows covered by count cells to the test buffer and waits for the GPU
+void CopyCellGrid(int count);
+
+// Draws count cells, copies the rows they cover to the test buffer and waits for the GPU.
+// setup_cell(i, quad) is called right before cell i is drawn. It loads whatever state differs
+// between the cells and may give the quad a vertex color; the position is set here.
+// Sets the viewport to 640x528.
+void DrawCellGrid(int count, const std::function<void(int cell, Quad& quad)>& setup_cell);
+
+// Read back the middle of a cell drawn by the last DrawCellGrid
+Vec4<u8> ReadCellGrid(int cell);
+
 // Read back output of the last tev stage (all 11 bits)
 // The BP registers last_cc and last_ac must have already been written before
 // calling this function. The function logic adds 3 additional tev stages,
@@ -72,6 +164,27 @@ Vec4<u8> ReadTestBuffer(int x, int y, int previous_copy_width);
 Vec4<int> GetTevOutput(const GenMode& genmode, const TevStageCombiner::ColorCombiner& last_cc,
                        const TevStageCombiner::AlphaCombiner& last_ac);
 
+// Batched version of GetTevOutput, which reads back up to GRID_MAX_CELLS outputs from a single
+// pair of render passes and EFB copies, one per DrawCellGrid cell.
+// setup_cell(i) is called right before cell i is drawn in each pass and loads whatever differs
+// between the cells (TEV registers, konst colors, the combiners up to last_cc and last_ac).
+// It must not write GenMode or the stages after the last one, which are set up here.
+// Sets the viewport to 640x528. Same constraints as GetTevOutput otherwise.
+void GetTevOutputs(const GenMode& genmode, const TevStageCombiner::ColorCombiner& last_cc,
+                   const TevStageCombiner::AlphaCombiner& last_ac, int count,
+                   const std::function<void(int cell)>& setup_cell, Vec4<int>* outputs);
+
 void DebugDisplayEfbContents();
 
 }  // namespace
+
+template <>
+struct fmt::formatter<GXTest::Vec4<u8>>
+{
+  constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+  template <typename FormatContext>
+  auto format(const GXTest::Vec4<u8>& color, FormatContext& ctx) const
+  {
+    return fmt::format_to(ctx.out(), "{}/{}/{}/{}", color.r, color.g, color.b, color.a);
+  }
+};
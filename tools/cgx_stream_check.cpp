@@ -0,0 +1,412 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Runs the CGX and Quad helpers of gxtest on the host, where cgx_sink captures everything they
+// emit, and checks the exact command streams: the shadow registers, the display list offsets and
+// the size of a draw. Also prints how many bytes and commands the common draws take, so changes
+// to the helpers can be measured without a console. Finally, writes a FIFO log and reads it back.
+//
+// Usage: cgx_stream_check
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "gxtest/FifoDecoder.h"
+#include "gxtest/FifoLog.h"
+#include "gxtest/cgx.h"
+#include "gxtest/util.h"
+
+static int s_num_failures = 0;
+
+static void Check(bool condition, const char* description)
+{
+  if (!condition)
+  {
+    std::printf("FAILED: %s\n", description);
+    ++s_num_failures;
+  }
+}
+
+// Starts from a GPU whose registers the shadow knows nothing about
+static void Reset()
+{
+  CGX_InvalidateShadowRegs();
+  CGX_ResetShadowStats();
+  cgx_sink.ClearCapture();
+}
+
+static u32 ReadU32(const std::vector<u8>& stream, size_t offset)
+{
+  return (u32{stream[offset]} << 24) | (u32{stream[offset + 1]} << 16) |
+         (u32{stream[offset + 2]} << 8) | stream[offset + 3];
+}
+
+// Number of commands in the stream. Draws are assumed to use vertex_size bytes per vertex.
+static u32 CountCommands(const std::vector<u8>& stream, u32 vertex_size)
+{
+  u32 count = 0;
+  size_t offset = 0;
+  while (offset < stream.size())
+  {
+    const u8 command = stream[offset];
+    if (command == 0x00)
+      offset += 1;
+    else if (command == 0x08)
+      offset += 6;
+    else if (command == 0x10)
+      offset += 5 + 4 * ((ReadU32(stream, offset + 1) >> 16) + 1);
+    else if (command == 0x40)
+      offset += 9;
+    else if (command == 0x61)
+      offset += 5;
+    else if (command >= 0x80 && command < 0xc0)
+      offset += 3 + ((stream[offset + 1] << 8) | stream[offset + 2]) * vertex_size;
+    else
+      break;
+    ++count;
+  }
+  Check(offset == stream.size(), "stream ends with a complete command");
+  return count;
+}
+
+static void PrintStream(const char* name, u32 vertex_size)
+{
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+  std::printf("%-36s %6zu bytes, %3u commands\n", name, stream.size(),
+              CountCommands(stream, vertex_size));
+}
+
+static void QuadDrawCheck()
+{
+  Reset();
+  GXTest::Quad quad;
+  quad.ColorRGBA(0x12, 0x34, 0x56, 0x78);
+
+  // 5 CP loads, the projection, and the draw with 4 vertices of position and color
+  quad.Draw();
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+  Check(stream.size() == 5 * 6 + (5 + 7 * 4) + 3 + 4 * 16, "first Quad::Draw size");
+  Check(stream.size() > 6 && stream[0] == 0x08 && stream[1] == 0x50, "Quad::Draw loads VCD");
+  PrintStream("Quad::Draw, first", 16);
+
+  // Only the draw itself is left once the vertex format and projection are known
+  cgx_sink.ClearCapture();
+  quad.Draw();
+  Check(stream.size() == 3 + 4 * 16, "repeated Quad::Draw size");
+  Check(stream.size() > 3 && stream[0] == 0x80 && stream[1] == 0 && stream[2] == 4,
+        "repeated Quad::Draw starts with the draw");
+  Check(stream.size() > 3 + 16 && ReadU32(stream, 3 + 12) == 0x12345678, "vertex color");
+  PrintStream("Quad::Draw, repeated", 16);
+  Check(CGX_GetShadowStats().suppressed_cp_writes == 5, "suppressed CP writes");
+  Check(CGX_GetShadowStats().suppressed_xf_writes == 7, "suppressed XF writes");
+
+  // A quad without color only changes the VCD and VAT group 0
+  cgx_sink.ClearCapture();
+  GXTest::Quad().Draw();
+  Check(stream.size() == 2 * 6 + 3 + 4 * 12, "Quad::Draw without color after one with color");
+  PrintStream("Quad::Draw, other vertex format", 12);
+}
+
+static void BPShadowCheck()
+{
+  Reset();
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+  const u32 genmode = BPMEM_GENMODE << 24 | 0x10;
+
+  CGX_LOAD_BP_REG(genmode);
+  CGX_LOAD_BP_REG(genmode);
+  Check(stream.size() == 5 && stream[0] == 0x61 && ReadU32(stream, 1) == genmode,
+        "duplicate BP write is dropped");
+  Check(CGX_GetShadowStats().suppressed_bp_writes == 1, "suppressed BP writes");
+  Check(CGX_GetShadowStats().suppressed_bytes == 5, "suppressed bytes");
+
+  CGX_FORCE_LOAD_BP_REG(genmode);
+  Check(stream.size() == 10, "forced BP write is sent");
+
+  // Triggers are sent every time
+  CGX_LOAD_BP_REG(BPMEM_SETDRAWDONE << 24 | 2);
+  CGX_LOAD_BP_REG(BPMEM_SETDRAWDONE << 24 | 2);
+  Check(stream.size() == 20, "BP triggers are always sent");
+
+  // After a masked write, the register it went to is unknown, so the same value is sent again
+  cgx_sink.ClearCapture();
+  CGX_LOAD_BP_REG(BPMEM_BP_MASK << 24 | 0x0000ff);
+  CGX_LOAD_BP_REG(genmode);
+  CGX_LOAD_BP_REG(genmode);
+  CGX_LOAD_BP_REG(genmode);
+  Check(stream.size() == 3 * 5, "BP mask makes the next write unknown");
+
+  // The TEV color registers share addresses with the konst colors
+  cgx_sink.ClearCapture();
+  CGX_LOAD_BP_REG(BPMEM_TEV_COLOR_BG << 24);
+  CGX_LOAD_BP_REG(BPMEM_TEV_COLOR_BG << 24);
+  Check(stream.size() == 10, "TEV color writes are always sent");
+}
+
+static void XFShadowCheck()
+{
+  Reset();
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+
+  CGX_SetViewport(0.0f, 0.0f, 640.0f, 528.0f, 0.0f, 1.0f);
+  Check(stream.size() == 5 + 6 * 4, "viewport size");
+
+  // Only the x and y origin change
+  cgx_sink.ClearCapture();
+  CGX_SetViewport(10.0f, 20.0f, 640.0f, 528.0f, 0.0f, 1.0f);
+  Check(stream.size() == 5 + 2 * 4 && stream[0] == 0x10 && ReadU32(stream, 1) == (1 << 16 | 0x101d),
+        "XF writes are trimmed to the changed registers");
+
+  cgx_sink.ClearCapture();
+  CGX_SetViewport(10.0f, 20.0f, 640.0f, 528.0f, 0.0f, 1.0f);
+  Check(stream.empty(), "unchanged viewport is dropped");
+  Check(CGX_GetShadowStats().suppressed_bytes == 4 * 4 + 6 * 4 + 5, "suppressed XF bytes");
+
+  // Raw XF writes make the shadow forget the registers
+  CGX_BEGIN_LOAD_XF_REGS(0x101d, 1);
+  cgx_sink.F32(0.0f);
+  cgx_sink.ClearCapture();
+  CGX_SetViewport(10.0f, 20.0f, 640.0f, 528.0f, 0.0f, 1.0f);
+  Check(stream.size() == 5 + 4, "raw XF write invalidates the shadow");
+}
+
+static void DisplayListCheck()
+{
+  Reset();
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+  const u32 genmode = BPMEM_GENMODE << 24 | 0x10;
+
+  CGXDisplayList list(64);
+  Check(list.LoadBPReg(genmode) == 1, "BP value offset");
+  Check(list.LoadCPReg(0x50, 0x200) == 7, "CP value offset");
+  Check(list.SetViewport(0.0f, 0.0f, 640.0f, 528.0f, 0.0f, 1.0f) == 16, "viewport offset");
+
+  CGX_LOAD_BP_REG(genmode);
+  cgx_sink.ClearCapture();
+  list.Call();
+  Check(stream.size() == 9 && stream[0] == 0x40 && ReadU32(stream, 5) == 64,
+        "display list call pads to 32 bytes");
+  PrintStream("CGXDisplayList::Call", 0);
+
+  // The list wrote genmode behind the shadow's back
+  cgx_sink.ClearCapture();
+  CGX_LOAD_BP_REG(genmode);
+  Check(stream.size() == 5, "display list call invalidates the shadow");
+}
+
+static void QuadBatchCheck()
+{
+  Reset();
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+  constexpr int NUM_QUADS = 100;
+
+  GXTest::QuadBatch batch(NUM_QUADS);
+  for (int cell = 0; cell < NUM_QUADS; ++cell)
+    batch.Add(GXTest::GetCellGridQuad(cell));
+
+  batch.Draw();
+  cgx_sink.ClearCapture();
+  batch.Draw();
+  Check(stream.size() == 3 + NUM_QUADS * 4 * 12, "QuadBatch::Draw size");
+  Check(stream.size() > 3 && stream[1] == 1 && stream[2] == 400 - 256, "QuadBatch vertex count");
+  PrintStream("QuadBatch::Draw, 100 quads", 12);
+
+  cgx_sink.ClearCapture();
+  batch.DrawAsDisplayList();
+  Check(stream.size() == 9 && ReadU32(stream, 5) == 32 + NUM_QUADS * 4 * 12,
+        "QuadBatch::DrawAsDisplayList size");
+  PrintStream("QuadBatch::DrawAsDisplayList, 100", 12);
+}
+
+// Collects the vertex sizes the decoder works out for the draws
+class DrawSizeHandler : public FifoHandler
+{
+public:
+  void OnDraw(u8 /*command*/, u16 num_vertices, u32 vertex_size, const u8* /*vertices*/) override
+  {
+    vertex_sizes.push_back(vertex_size);
+    vertex_counts.push_back(num_vertices);
+  }
+
+  void OnCallDisplayList(u32 /*address*/, u32 /*size*/) override { ++num_calls; }
+
+  std::vector<u32> vertex_sizes;
+  std::vector<u32> vertex_counts;
+  u32 num_calls = 0;
+};
+
+static void DecoderCheck()
+{
+  Reset();
+  GXTest::Quad().ColorRGBA(0, 0, 0, 0xff).Draw();
+  GXTest::Quad().Draw();
+
+  DrawSizeHandler handler;
+  FifoDecoder decoder(handler);
+  const std::vector<u8>& stream = cgx_sink.GetCapture();
+  Check(decoder.Decode(stream.data(), stream.size()) == stream.size(), "decoder takes all");
+  Check(handler.vertex_sizes == std::vector<u32>{16, 12}, "decoded vertex sizes");
+  Check(handler.vertex_counts == std::vector<u32>{4, 4}, "decoded vertex counts");
+
+  // An incomplete command is left for the next call
+  Check(decoder.Decode(stream.data(), stream.size() - 1) < stream.size() - 1,
+        "decoder leaves an incomplete command");
+
+  // EFB copy rectangles have X in the lower bits, scissor corners in the upper ones
+  Check(DescribeBPReg(BPMEM_EFB_TL << 24 | 3 << 10 | 5) == "X: 5\nY: 3",
+        "decoder describes EFB copy corners");
+  Check(DescribeBPReg(BPMEM_SCISSORTL << 24 | 5 << 12 | 3) == "X: 5\nY: 3",
+        "decoder describes scissor corners");
+}
+
+static std::vector<u8> ReadFile(const char* path)
+{
+  std::vector<u8> file;
+  if (std::FILE* in = std::fopen(path, "rb"))
+  {
+    u8 block[4096];
+    size_t read;
+    while ((read = std::fread(block, 1, sizeof(block), in)) != 0)
+      file.insert(file.end(), block, block + read);
+    std::fclose(in);
+  }
+  return file;
+}
+
+static u32 ReadLE32(const std::vector<u8>& file, size_t offset)
+{
+  return u32{file[offset]} | (u32{file[offset + 1]} << 8) | (u32{file[offset + 2]} << 16) |
+         (u32{file[offset + 3]} << 24);
+}
+
+static std::vector<FifoLog> s_fifo_logs;
+static std::vector<u32> s_fifo_log_copies;
+
+static void KeepFifoLog(u32 copy, const FifoLog& log)
+{
+  s_fifo_log_copies.push_back(copy);
+  s_fifo_logs.push_back(log);
+}
+
+// Checks the file layout against Dolphin's FifoDataFile (FileFrameInfo and MemoryUpdate, packed
+// to 4 bytes) independently of ParseFifoLog, which would agree with any mistake in
+// SerializeFifoLog
+static void FifoLogLayoutCheck(const FifoLog& log)
+{
+  const std::vector<u8> file = SerializeFifoLog(log);
+  const size_t frame = ReadLE32(file, 60);
+  Check(ReadLE32(file, 0) == 0x0d01f1f0 && frame == 128 && ReadLE32(file, 68) == 1,
+        "FIFO log header");
+
+  const size_t fifo_offset = ReadLE32(file, frame);
+  Check(ReadLE32(file, frame + 8) == log.fifo_data.size() &&
+            std::equal(log.fifo_data.begin(), log.fifo_data.end(), file.begin() + fifo_offset),
+        "FIFO log frame commands");
+  Check(ReadLE32(file, frame + 12) == log.fifo_start && ReadLE32(file, frame + 16) == log.fifo_end,
+        "FIFO log frame FIFO bounds");
+
+  const size_t update_list = ReadLE32(file, frame + 20);
+  Check(ReadLE32(file, frame + 28) == log.memory_updates.size(), "FIFO log frame update count");
+  for (size_t i = 0; i < log.memory_updates.size(); ++i)
+  {
+    const FifoLogMemoryUpdate& update = log.memory_updates[i];
+    const size_t entry = update_list + 24 * i;
+    const size_t data_offset = ReadLE32(file, entry + 8);
+    Check(ReadLE32(file, entry) == update.fifo_position &&
+              ReadLE32(file, entry + 4) == update.address &&
+              ReadLE32(file, entry + 16) == update.data.size() && file[entry + 20] == 0x01 &&
+              std::equal(update.data.begin(), update.data.end(), file.begin() + data_offset),
+          "FIFO log memory update");
+  }
+}
+
+// Every EFB copy ends a log, which starts with the registers written before it, including those
+// of display lists. Logs capture for good once enabled, so this check comes last.
+static void FifoLogCheck()
+{
+  Reset();
+  CGX_EnableFifoLogs(KeepFifoLog);
+
+  CGX_LOAD_BP_REG(BPMEM_ZMODE << 24 | 0x17);
+  CGXDisplayList list(64);
+  list.LoadBPReg(BPMEM_GENMODE << 24 | 0x10);
+  list.LoadCPReg(0x50, 0x200);
+  list.Call();
+  CGX_LOAD_BP_REG(BPMEM_BP_MASK << 24 | 0xff);
+  CGX_LOAD_BP_REG(BPMEM_ZMODE << 24 | 0xfff);
+  u8 first_dest[64] = {};
+  CGX_FifoLogEfbCopy(first_dest, sizeof(first_dest));
+
+  GXTest::Quad().Draw();
+  list.Call();
+  u8 second_dest[64] = {};
+  CGX_FifoLogEfbCopy(second_dest, sizeof(second_dest));
+  // As CGX_SendToken would
+  const u16 token = 7;
+  CGX_FifoLogToken(token);
+
+  // Logs are only handed over once the GPU is done with their copy
+  std::fill(std::begin(first_dest), std::end(first_dest), 0xab);
+  std::fill(std::begin(second_dest), std::end(second_dest), 0xcd);
+  Check(s_fifo_logs.empty(), "FIFO logs wait for their copies");
+  CGX_FifoLogTokenReached(token);
+  Check(s_fifo_log_copies == std::vector<u32>{0, 1}, "FIFO logs of both copies");
+  if (s_fifo_logs.size() != 2)
+    return;
+
+  const FifoLog& first = s_fifo_logs[0];
+  Check(first.memory_updates.size() == 1 &&
+            first.memory_updates[0].fifo_position == first.fifo_data.size() &&
+            first.memory_updates[0].data == std::vector<u8>(sizeof(first_dest), 0xab),
+        "FIFO log ends with the copy's result");
+
+  const FifoLog& second = s_fifo_logs[1];
+  const std::vector<u8> second_result(sizeof(second_dest), 0xcd);
+  Check(second.registers.bp_mem[BPMEM_ZMODE] == 0xff, "FIFO log applies the BP mask");
+  Check(second.registers.bp_mem[BPMEM_GENMODE] == 0x10 && second.registers.cp_mem[0x50] == 0x200,
+        "FIFO log has the registers of display lists");
+  Check(second.memory_updates.size() == 2 && second.memory_updates[0].fifo_position == 0 &&
+            second.memory_updates[0].data == first.memory_updates[0].data &&
+            second.memory_updates[1].data == second_result,
+        "FIFO log starts with the previous copy's result");
+
+  const std::vector<u8>& fifo = second.fifo_data;
+  DrawSizeHandler handler;
+  FifoDecoder decoder(handler);
+  decoder.LoadCPState(second.registers.cp_mem);
+  Check(decoder.Decode(fifo.data(), fifo.size()) == fifo.size(), "FIFO log decodes");
+  Check(handler.vertex_sizes == std::vector<u32>{12}, "FIFO log draw");
+  // The list's commands replace the call
+  Check(handler.num_calls == 0, "FIFO log inlines display lists");
+
+  FifoLogLayoutCheck(second);
+
+  const char* path = "cgx_stream_check.dff";
+  Check(CGX_WriteFifoLog(second, path), "FIFO log written");
+  const std::vector<u8> file = ReadFile(path);
+  std::remove(path);
+  FifoLog parsed;
+  Check(ParseFifoLog(file.data(), file.size(), &parsed) && parsed.fifo_data == fifo &&
+            parsed.memory_updates.size() == 2 && parsed.memory_updates[1].data == second_result,
+        "FIFO log reads back");
+  std::printf("FIFO log of a quad and a display list: %zu bytes, %zu of them commands\n",
+              file.size(), fifo.size());
+}
+
+int main()
+{
+  QuadDrawCheck();
+  BPShadowCheck();
+  XFShadowCheck();
+  DisplayListCheck();
+  QuadBatchCheck();
+  DecoderCheck();
+  FifoLogCheck();
+
+  std::printf("%d failures\n", s_num_failures);
+  return s_num_failures != 0;
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Compares reading back an RGBA8 copy pixel by pixel (GXTest::ReadRGBA8, which ReadTestBuffer
+// uses) with detiling all of it at once (GXTest::DetileRGBA8). Checks that both give the same
+// pixels and prints how long each takes for the copy sizes of the tests.
+//
+// Usage: detile_bench [repetitions]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "gxtest/util.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the compiler from dropping the pixel by pixel reads
+static volatile u32 s_sink = 0;
+
+static double NanosecondsPerPixel(Clock::duration duration, int width, int height, int repetitions)
+{
+  const double ns = std::chrono::duration<double, std::nano>(duration).count();
+  return ns / (double(width) * height * repetitions);
+}
+
+static bool Bench(int width, int height, int repetitions)
+{
+  // Copies are padded to whole 4x4 blocks of 64 bytes
+  const int blocks = ((width + 3) / 4) * ((height + 3) / 4);
+  std::vector<u32> buffer(blocks * 16);
+  std::mt19937 rng(width * 1000 + height);
+  for (u32& word : buffer)
+    word = rng();
+
+  std::vector<GXTest::Vec4<u8>> pixels(width * height);
+
+  // The order the tests used to read in, one column after the other
+  const Clock::time_point before_start = Clock::now();
+  for (int i = 0; i < repetitions; ++i)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      for (int y = 0; y < height; ++y)
+        s_sink = s_sink + GXTest::ReadRGBA8(buffer.data(), x, y, width).g;
+    }
+  }
+  const Clock::duration before = Clock::now() - before_start;
+
+  const Clock::time_point after_start = Clock::now();
+  for (int i = 0; i < repetitions; ++i)
+    GXTest::DetileRGBA8(buffer.data(), width, height, pixels.data());
+  const Clock::duration after = Clock::now() - after_start;
+
+  bool same = true;
+  for (int y = 0; y < height; ++y)
+  {
+    std::vector<GXTest::Vec4<u8>> expected(width);
+    for (int x = 0; x < width; ++x)
+      expected[x] = GXTest::ReadRGBA8(buffer.data(), x, y, width);
+    same &= GXTest::FindMismatch(&pixels[y * width], expected.data(), width) == width;
+  }
+
+  std::printf("%4dx%-4d  ReadRGBA8 %6.2f ns/pixel  DetileRGBA8 %6.2f ns/pixel  %s\n", width,
+              height, NanosecondsPerPixel(before, width, height, repetitions),
+              NanosecondsPerPixel(after, width, height, repetitions),
+              same ? "same pixels" : "DIFFERENT PIXELS");
+  return same;
+}
+
+int main(int argc, char** argv)
+{
+  const int repetitions = argc > 1 ? std::atoi(argv[1]) : 200;
+  if (repetitions <= 0)
+  {
+    std::fprintf(stderr, "Usage: %s [repetitions]\n", argv[0]);
+    return 1;
+  }
+
+  bool same = true;
+  same &= Bench(256, 256, repetitions);  // intensity
+  same &= Bench(256, 8, repetitions);    // copyfilter
+  same &= Bench(640, 528, repetitions);  // the whole EFB
+  same &= Bench(101, 7, repetitions);    // partial blocks at the edges
+  return !same;
+}
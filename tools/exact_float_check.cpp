@@ -0,0 +1,302 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Checks the arithmetic of Common/ExactFloat.h and Common/PairedSingle.h against the host's
+// IEEE arithmetic, in all four rounding modes, and prints how many operations per second the
+// model manages. The console tests trust the model, so this makes sure it's right wherever the
+// hardware follows IEEE 754 before a mismatch gets blamed on the hardware.
+//
+// Only the cases where Broadway and IEEE agree are compared: NI is off, and NaN inputs and
+// results are skipped (Broadway's default NaN is positive and its propagation order differs).
+// Single-precision operations get single-precision inputs, so truncating frC doesn't matter.
+//
+// The operands of the fused multiply-add sweep (Common/FmaInputs.h) are checked too, since they
+// aim right at the rounding boundaries: all of them against the host's fma, and the ones that
+// happen to be singles against its fmaf as well.
+//
+// Usage: exact_float_check [cases per rounding mode]
+
+#include <cfenv>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/ExactFloat.h"
+#include "Common/FloatUtils.h"
+#include "Common/FmaInputs.h"
+#include "Common/PairedSingle.h"
+#include "Common/Random.h"
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int HOST_ROUNDING_MODES[] = {FE_TONEAREST, FE_TOWARDZERO, FE_UPWARD, FE_DOWNWARD};
+
+// The host's operands and results go through volatile variables, so that the compiler can't
+// move the arithmetic across fesetround or fold it at compile time
+static volatile double s_a, s_b, s_c, s_result;
+static volatile float s_a_single, s_b_single, s_c_single, s_result_single;
+
+static int s_num_failures = 0;
+static u64 s_num_single_fma_cases = 0;
+
+// Exponents close to each other most of the time, so that results round rather than overflow,
+// plus any bit pattern for the denormals, infinities and huge ratios
+static u64 RandomDouble(Random& random)
+{
+  const u64 bits = random.Next64();
+  if (random.NextBelow(8) == 0)
+    return bits;
+  const u64 exponent = 1023 - 60 + random.NextBelow(121);
+  return (bits & (DOUBLE_SIGN | DOUBLE_FRAC)) | (exponent << DOUBLE_FRAC_WIDTH);
+}
+
+static u32 RandomSingleBits(Random& random)
+{
+  const u32 bits = random.Next32();
+  if (random.NextBelow(8) == 0)
+    return bits;
+  const u32 exponent = 127 - 30 + static_cast<u32>(random.NextBelow(61));
+  return (bits & (FLOAT_SIGN | FLOAT_FRAC)) | (exponent << FLOAT_FRAC_WIDTH);
+}
+
+static bool IsNaNDouble(u64 bits)
+{
+  return (bits & DOUBLE_EXP) == DOUBLE_EXP && (bits & DOUBLE_FRAC) != 0;
+}
+
+static void Compare(const char* name, int rounding_mode, u64 a, u64 b, u64 c, u64 model, u64 host)
+{
+  if (IsNaNDouble(model) || IsNaNDouble(host) || model == host)
+    return;
+
+  if (s_num_failures++ < 20)
+  {
+    std::printf("%s (RN=%d) a=%016" PRIx64 " b=%016" PRIx64 " c=%016" PRIx64 ":\n"
+                "   model %016" PRIx64 "\n"
+                "    host %016" PRIx64 "\n",
+                name, rounding_mode, a, b, c, model, host);
+  }
+}
+
+static u64 HostDouble()
+{
+  return Common::BitCast<u64>(static_cast<double>(s_result));
+}
+
+static u64 HostSingle()
+{
+  return ConvertFloatBitsToDouble(Common::BitCast<u32>(static_cast<float>(s_result_single)));
+}
+
+static void CheckDouble(Random& random, int rounding_mode)
+{
+  const u64 a = RandomDouble(random);
+  const u64 b = RandomDouble(random);
+  const u64 c = RandomDouble(random);
+  if (IsNaNDouble(a) || IsNaNDouble(b) || IsNaNDouble(c))
+    return;
+  s_a = Common::BitCast<double>(a);
+  s_b = Common::BitCast<double>(b);
+  s_c = Common::BitCast<double>(c);
+
+  FPState state;
+  state.rounding_mode = static_cast<RoundingMode>(rounding_mode);
+  const FloatPrecision precision = FloatPrecision::Double;
+
+  s_result = s_a + s_b;
+  Compare("add", rounding_mode, a, b, 0, FloatAdd(a, b, precision, state), HostDouble());
+  s_result = s_a - s_b;
+  Compare("sub", rounding_mode, a, b, 0, FloatSub(a, b, precision, state), HostDouble());
+  s_result = s_a * s_c;
+  Compare("mul", rounding_mode, a, 0, c, FloatMul(a, c, precision, state), HostDouble());
+  s_result = s_a / s_b;
+  Compare("div", rounding_mode, a, b, 0, FloatDiv(a, b, precision, state), HostDouble());
+  s_result = std::fma(s_a, s_c, s_b);
+  Compare("madd", rounding_mode, a, b, c, FloatMulAdd(a, c, b, false, false, precision, state),
+          HostDouble());
+  s_result_single = static_cast<float>(s_a);
+  Compare("frsp", rounding_mode, 0, a, 0, FloatRoundToSingle(a, state), HostSingle());
+}
+
+static void CheckSingle(Random& random, int rounding_mode)
+{
+  const u32 a_bits = RandomSingleBits(random);
+  const u32 b_bits = RandomSingleBits(random);
+  const u32 c_bits = RandomSingleBits(random);
+  const u64 a = ConvertFloatBitsToDouble(a_bits);
+  const u64 b = ConvertFloatBitsToDouble(b_bits);
+  const u64 c = ConvertFloatBitsToDouble(c_bits);
+  if (IsNaNDouble(a) || IsNaNDouble(b) || IsNaNDouble(c))
+    return;
+  s_a_single = Common::BitCast<float>(a_bits);
+  s_b_single = Common::BitCast<float>(b_bits);
+  s_c_single = Common::BitCast<float>(c_bits);
+
+  FPState state;
+  state.rounding_mode = static_cast<RoundingMode>(rounding_mode);
+  const FloatPrecision precision = FloatPrecision::Single;
+
+  s_result_single = s_a_single + s_b_single;
+  Compare("adds", rounding_mode, a, b, 0, FloatAdd(a, b, precision, state), HostSingle());
+  s_result_single = s_a_single - s_b_single;
+  Compare("subs", rounding_mode, a, b, 0, FloatSub(a, b, precision, state), HostSingle());
+  s_result_single = s_a_single * s_c_single;
+  Compare("muls", rounding_mode, a, 0, c, FloatMul(a, c, precision, state), HostSingle());
+  s_result_single = s_a_single / s_b_single;
+  Compare("divs", rounding_mode, a, b, 0, FloatDiv(a, b, precision, state), HostSingle());
+  s_result_single = std::fma(s_a_single, s_c_single, s_b_single);
+  Compare("madds", rounding_mode, a, b, c, FloatMulAdd(a, c, b, false, false, precision, state),
+          HostSingle());
+
+  // Both slots of a paired single, with the operands swapped in ps1
+  const PairedSingle pa = {a, b};
+  const PairedSingle pb = {b, a};
+  const PairedSingle pc = {c, c};
+  const PairedSingle sum = ps_add_expected(pa, pb, state);
+  s_result_single = s_a_single + s_b_single;
+  Compare("ps_add ps0", rounding_mode, a, b, 0, sum.ps0, HostSingle());
+  s_result_single = s_b_single + s_a_single;
+  Compare("ps_add ps1", rounding_mode, b, a, 0, sum.ps1, HostSingle());
+  const PairedSingle madd = ps_madd_expected(pa, pc, pb, state);
+  s_result_single = std::fma(s_a_single, s_c_single, s_b_single);
+  Compare("ps_madd ps0", rounding_mode, a, b, c, madd.ps0, HostSingle());
+  s_result_single = std::fma(s_b_single, s_c_single, s_a_single);
+  Compare("ps_madd ps1", rounding_mode, b, a, c, madd.ps1, HostSingle());
+}
+
+static bool IsSingle(u64 bits)
+{
+  s_a = Common::BitCast<double>(bits);
+  s_result_single = static_cast<float>(s_a);
+  return static_cast<double>(s_result_single) == s_a;
+}
+
+static void CheckFMA(Random& random, int rounding_mode, FloatPrecision target)
+{
+  const FMAInputs in = GenerateFMAInputs(random, target);
+  if (IsNaNDouble(in.a) || IsNaNDouble(in.c) || IsNaNDouble(in.b))
+    return;
+  const bool singles = IsSingle(in.a) && IsSingle(in.c) && IsSingle(in.b);
+  s_num_single_fma_cases += singles;
+
+  static const char* const NAMES[2][4] = {{"fmadd", "fmsub", "fnmadd", "fnmsub"},
+                                          {"fmadds", "fmsubs", "fnmadds", "fnmsubs"}};
+  for (int variant = 0; variant < 4; ++variant)
+  {
+    const bool negate_b = (variant & 1) != 0;
+    const bool negate_result = (variant & 2) != 0;
+    const u64 b = negate_b ? in.b ^ DOUBLE_SIGN : in.b;
+
+    FPState state;
+    state.rounding_mode = static_cast<RoundingMode>(rounding_mode);
+
+    s_a = Common::BitCast<double>(in.a);
+    s_c = Common::BitCast<double>(in.c);
+    s_b = Common::BitCast<double>(b);
+    s_result = std::fma(s_a, s_c, s_b);
+    const u64 host = HostDouble() ^ (negate_result ? DOUBLE_SIGN : 0);
+    Compare(NAMES[0][variant], rounding_mode, in.a, in.b, in.c,
+            FloatMulAdd(in.a, in.c, in.b, negate_b, negate_result, FloatPrecision::Double, state),
+            host);
+
+    if (!singles)
+      continue;
+    s_a_single = static_cast<float>(s_a);
+    s_c_single = static_cast<float>(s_c);
+    s_b_single = static_cast<float>(s_b);
+    s_result_single = std::fma(s_a_single, s_c_single, s_b_single);
+    const u64 host_single = HostSingle() ^ (negate_result ? DOUBLE_SIGN : 0);
+    Compare(NAMES[1][variant], rounding_mode, in.a, in.b, in.c,
+            FloatMulAdd(in.a, in.c, in.b, negate_b, negate_result, FloatPrecision::Single, state),
+            host_single);
+  }
+}
+
+// Keeps the compiler from dropping the model's results
+static volatile u64 s_sink = 0;
+
+static void Benchmark(u64 cases)
+{
+  Random random(1);
+  std::vector<u64> operands(3 * 4096);
+  for (u64& operand : operands)
+    operand = RandomDouble(random);
+
+  struct Operation
+  {
+    const char* name;
+    u64 (*run)(u64 a, u64 b, u64 c, FloatPrecision precision, FPState& state);
+  };
+  static const Operation OPERATIONS[] = {
+      {"add",
+       [](u64 a, u64 b, u64, FloatPrecision p, FPState& s) { return FloatAdd(a, b, p, s); }},
+      {"mul",
+       [](u64 a, u64, u64 c, FloatPrecision p, FPState& s) { return FloatMul(a, c, p, s); }},
+      {"div",
+       [](u64 a, u64 b, u64, FloatPrecision p, FPState& s) { return FloatDiv(a, b, p, s); }},
+      {"madd",
+       [](u64 a, u64 b, u64 c, FloatPrecision p, FPState& s) {
+         return FloatMulAdd(a, c, b, false, false, p, s);
+       }},
+  };
+
+  for (const Operation& operation : OPERATIONS)
+  {
+    for (FloatPrecision precision : {FloatPrecision::Double, FloatPrecision::Single})
+    {
+      FPState state;
+      u64 sink = 0;
+      const Clock::time_point start = Clock::now();
+      for (u64 i = 0; i < cases; ++i)
+      {
+        const u64* in = &operands[3 * (i % 4096)];
+        sink += operation.run(in[0], in[1], in[2], precision, state);
+      }
+      const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+      s_sink = sink;
+
+      std::printf("%-5s %s: %6.1f million operations per second\n", operation.name,
+                  precision == FloatPrecision::Double ? "double" : "single",
+                  cases / seconds / 1e6);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 2)
+  {
+    std::fprintf(stderr, "Usage: %s [cases per rounding mode]\n", argv[0]);
+    return 1;
+  }
+  const u64 cases = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 2000000;
+
+  for (int rounding_mode = 0; rounding_mode < 4; ++rounding_mode)
+  {
+    Random random(rounding_mode);
+    std::fesetround(HOST_ROUNDING_MODES[rounding_mode]);
+    for (u64 i = 0; i < cases; ++i)
+    {
+      CheckDouble(random, rounding_mode);
+      CheckSingle(random, rounding_mode);
+      CheckFMA(random, rounding_mode, FloatPrecision::Double);
+      CheckFMA(random, rounding_mode, FloatPrecision::Single);
+    }
+    std::fesetround(FE_TONEAREST);
+    std::printf("Rounding mode %d: %" PRIu64 " double and single cases checked\n", rounding_mode,
+                cases);
+  }
+
+  std::printf("%" PRIu64 " of the fused multiply-add inputs were singles\n",
+              s_num_single_fma_cases);
+
+  Benchmark(cases);
+
+  std::printf("%d mismatches\n", s_num_failures);
+  return s_num_failures != 0;
+}
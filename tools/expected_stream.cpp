@@ -0,0 +1,237 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Stands in for netcat when running tests built with USE_EXPECTED_STREAM: prints the test output
+// and answers the console's requests for expected results, computing them with the same models
+// the tests use (see Common/ExpectedStreamProtocol.h for the protocol).
+//
+// Usage: expected_stream <console address> [port]
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/ExpectedStreamProtocol.h"
+#include "Common/FloatUtils.h"
+#include "Common/FprfSweep.h"
+#include "Common/ReciprocalTables.h"
+
+struct Request
+{
+  ExpectedKind kind;
+  u32 param;
+  u64 first;
+  u64 count;
+};
+
+static bool SendAll(int fd, const void* data, size_t size)
+{
+  const u8* bytes = static_cast<const u8*>(data);
+  while (size != 0)
+  {
+    const ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+    if (sent <= 0)
+      return false;
+    bytes += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+static void StoreBigEndian(u8* out, u64 value, int bytes)
+{
+  for (int i = bytes - 1; i >= 0; --i, value >>= 8)
+    out[i] = static_cast<u8>(value);
+}
+
+static void Generate(const Request& request, u64 input, u32 num_inputs, u64* out)
+{
+  switch (request.kind)
+  {
+  case ExpectedKind::Reciprocal:
+  {
+    const ReciprocalTables& tables = ReciprocalTables::Get();
+    for (u32 i = 0; i < num_inputs; ++i)
+    {
+      const double value = Common::BitCast<double>((input + i) << 32);
+      out[2 * i] = Common::BitCast<u64>(tables.frsqrte(value));
+      out[2 * i + 1] = Common::BitCast<u64>(tables.fres(value, request.param != 0));
+    }
+    break;
+  }
+  case ExpectedKind::Fctiw:
+  {
+    const RoundingMode rounding_mode = static_cast<RoundingMode>(request.param & 3);
+    for (u32 i = 0; i < num_inputs; ++i)
+    {
+      const float value = Common::BitCast<float>(static_cast<u32>(input + i));
+      out[i] = fctiw_expected(value, rounding_mode);
+    }
+    break;
+  }
+  case ExpectedKind::Fprf:
+  {
+    ComputeFprfSweepBlock(static_cast<u32>(input), num_inputs,
+                          static_cast<RoundingMode>(request.param & 3), out);
+    break;
+  }
+  }
+}
+
+static void Serve(int fd, Request request, const std::atomic<bool>& cancel)
+{
+  const u32 entries_per_input = ExpectedEntriesPerInput(request.kind);
+  const u32 max_inputs = EXPECTED_STREAM_BLOCK_ENTRIES / entries_per_input;
+
+  std::vector<u64> entries(EXPECTED_STREAM_BLOCK_ENTRIES);
+  std::vector<u8> block(sizeof(u32) + EXPECTED_STREAM_BLOCK_ENTRIES * sizeof(u64));
+
+  const bool valid_kind = request.kind == ExpectedKind::Reciprocal ||
+                          request.kind == ExpectedKind::Fctiw || request.kind == ExpectedKind::Fprf;
+  if (!valid_kind)
+    std::fprintf(stderr, "Unknown expected result kind %u\n", static_cast<u32>(request.kind));
+
+  const u64 end = request.first + request.count;
+  for (u64 input = request.first; valid_kind && input < end && !cancel;)
+  {
+    const u32 num_inputs = static_cast<u32>(std::min<u64>(max_inputs, end - input));
+    const u32 num_entries = num_inputs * entries_per_input;
+    Generate(request, input, num_inputs, entries.data());
+
+    StoreBigEndian(block.data(), num_entries, sizeof(u32));
+    for (u32 i = 0; i < num_entries; ++i)
+      StoreBigEndian(&block[sizeof(u32) + i * sizeof(u64)], entries[i], sizeof(u64));
+    if (!SendAll(fd, block.data(), sizeof(u32) + num_entries * sizeof(u64)))
+      return;
+
+    input += num_inputs;
+  }
+
+  // Terminating empty block
+  const u8 terminator[sizeof(u32)] = {};
+  SendAll(fd, terminator, sizeof(terminator));
+}
+
+static int Connect(const char* host, const char* port)
+{
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo* addresses;
+  if (const int error = getaddrinfo(host, port, &hints, &addresses))
+  {
+    std::fprintf(stderr, "%s: %s\n", host, gai_strerror(error));
+    return -1;
+  }
+
+  int fd = -1;
+  for (addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+  {
+    fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0)
+      continue;
+    if (connect(fd, address->ai_addr, address->ai_addrlen) == 0)
+      break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+
+  if (fd < 0)
+    std::perror("connect");
+  return fd;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2 || argc > 3)
+  {
+    std::fprintf(stderr, "Usage: %s <console address> [port]\n", argv[0]);
+    return 1;
+  }
+
+  // Build the tables before the first request comes in
+  ReciprocalTables::Get();
+
+  const int fd = Connect(argv[1], argc > 2 ? argv[2] : "16784");
+  if (fd < 0)
+    return 1;
+
+  std::thread server;
+  std::atomic<bool> cancel{false};
+
+  const std::string request_prefix = EXPECTED_STREAM_REQUEST " ";
+  std::string pending;
+  char buffer[4096];
+  ssize_t received;
+  while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+  {
+    pending.append(buffer, static_cast<size_t>(received));
+
+    size_t line_start = 0;
+    size_t line_end;
+    while ((line_end = pending.find('\n', line_start)) != std::string::npos)
+    {
+      const std::string line = pending.substr(line_start, line_end - line_start);
+      line_start = line_end + 1;
+
+      if (line.compare(0, request_prefix.size(), request_prefix) != 0)
+      {
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        std::fputc('\n', stdout);
+        continue;
+      }
+
+      if (line == EXPECTED_STREAM_CANCEL)
+      {
+        cancel = true;
+        continue;
+      }
+
+      Request request;
+      u32 kind;
+      if (std::sscanf(line.c_str() + request_prefix.size(), "%" SCNu32 " %" SCNu32 " %" SCNu64
+                                                             " %" SCNu64,
+                      &kind, &request.param, &request.first, &request.count) != 4)
+      {
+        std::fprintf(stderr, "Malformed request: %s\n", line.c_str());
+        continue;
+      }
+      request.kind = static_cast<ExpectedKind>(kind);
+
+      // The console only starts a new stream after the previous one was terminated
+      if (server.joinable())
+        server.join();
+      cancel = false;
+      server = std::thread(Serve, fd, request, std::cref(cancel));
+    }
+    pending.erase(0, line_start);
+
+    // Don't hold back partial output lines unless they could turn out to be a request
+    if (!pending.empty() && pending[0] != '@')
+    {
+      std::fwrite(pending.data(), 1, pending.size(), stdout);
+      pending.clear();
+    }
+    std::fflush(stdout);
+  }
+
+  cancel = true;
+  shutdown(fd, SHUT_RDWR);
+  if (server.joinable())
+    server.join();
+  close(fd);
+  return 0;
+}
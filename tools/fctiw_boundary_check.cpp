@@ -0,0 +1,95 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Checks fctiw_expected against the host's own conversion over the inputs of
+// Common/FctiwBoundaries.h, in all rounding modes. The console tests trust fctiw_expected, so this
+// makes sure the model is right on the boundary inputs before a mismatch gets blamed on the
+// hardware.
+//
+// Usage: fctiw_boundary_check [stride] [first input]
+// Every stride-th input starting at the first one is checked. A stride of 1 checks all of them.
+
+#include <algorithm>
+#include <atomic>
+#include <cfenv>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/FctiwBoundaries.h"
+#include "Common/FloatUtils.h"
+
+constexpr int HOST_ROUNDING_MODES[] = {FE_TONEAREST, FE_TOWARDZERO, FE_UPWARD, FE_DOWNWARD};
+
+// fctiw written in terms of the host's rounding, including Broadway's -0 quirk. The rounding mode
+// must already be set.
+static u64 HostFctiw(double value)
+{
+  const u64 upper_bits = 0xfff8000000000000ull;
+  if (std::isnan(value))
+    return upper_bits | 0x80000000;
+
+  const double rounded = std::nearbyint(value);
+  if (rounded >= 2147483648.0)
+    return upper_bits | 0x7fffffff;
+  if (rounded < -2147483648.0)
+    return upper_bits | 0x80000000;
+  if (rounded == 0 && std::signbit(value))
+    return upper_bits | 0x100000000ull;
+  return upper_bits | static_cast<u32>(static_cast<s32>(rounded));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 3)
+  {
+    std::fprintf(stderr, "Usage: %s [stride] [first input]\n", argv[0]);
+    return 1;
+  }
+
+  const u64 stride = std::max<u64>(argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1, 1);
+  const u64 first = argc > 2 ? std::strtoull(argv[2], nullptr, 0) : 0;
+  const u64 num_inputs = first < FCTIW_BOUNDARY_INPUTS ?
+                             (FCTIW_BOUNDARY_INPUTS - first + stride - 1) / stride :
+                             0;
+
+  const u32 num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::atomic<u64> num_failures{0};
+  std::vector<std::thread> threads;
+
+  for (u32 t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&, t] {
+      for (u32 mode = 0; mode < 4; ++mode)
+      {
+        std::fesetround(HOST_ROUNDING_MODES[mode]);
+        const RoundingMode rounding_mode = static_cast<RoundingMode>(mode);
+
+        for (u64 i = t; i < num_inputs; i += num_threads)
+        {
+          const u64 input = FctiwBoundaryInput(first + i * stride);
+          const double value = Common::BitCast<double>(input);
+          const u64 expected = fctiw_expected(value, rounding_mode);
+          const u64 host = HostFctiw(value);
+          if (expected != host && num_failures++ < 100)
+          {
+            std::printf("RN=%u %016" PRIx64 ": fctiw_expected %016" PRIx64 ", host %016" PRIx64
+                        "\n",
+                        mode, input, expected, host);
+          }
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  std::printf("%" PRIu64 " inputs in 4 rounding modes, %" PRIu64 " mismatches\n", num_inputs,
+              num_failures.load());
+  return num_failures != 0;
+}
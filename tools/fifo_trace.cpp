@@ -0,0 +1,367 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Prints a captured GX command stream (e.g. what cgx_sink captured) as a list of register writes,
+// decoded through the formatters of gxtest/BPMemory.h, and draws. The capture is read in chunks,
+// so it can be much bigger than the memory. FIFO logs (.dff files, see gxtest/FifoLog.h) are
+// printed as well, along with their memory updates.
+//
+// Usage: fifo_trace [--changes] [capture or FIFO log file]
+// Without a file, the capture is read from stdin. With --changes, only register writes that change
+// a register are printed, along with the writes that trigger something and the draws. For a FIFO
+// log, that means changes to the registers the log starts with.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fmt/format.h>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "gxtest/BPMemory.h"
+#include "gxtest/FifoDecoder.h"
+#include "gxtest/FifoLog.h"
+
+// The output is flushed in blocks of about this size
+constexpr size_t OUTPUT_BLOCK_SIZE = 1 << 20;
+constexpr size_t INPUT_BLOCK_SIZE = 4 << 20;
+
+// Writes to these registers start something instead of setting state, so --changes keeps them
+static bool IsBPTrigger(u8 addr)
+{
+  switch (addr)
+  {
+  case BPMEM_PERF0_TRI:
+  case BPMEM_PERF0_QUAD:
+  case BPMEM_SETDRAWDONE:
+  case BPMEM_PE_TOKEN_ID:
+  case BPMEM_PE_TOKEN_INT_ID:
+  case BPMEM_TRIGGER_EFB_COPY:
+  case BPMEM_CLEARBBOX1:
+  case BPMEM_CLEARBBOX2:
+  case BPMEM_CLEAR_PIXEL_PERF:
+  case BPMEM_PRELOAD_MODE:
+  case BPMEM_LOADTLUT1:
+  case BPMEM_TEXINVALIDATE:
+  case BPMEM_PERF1:
+    return true;
+  default:
+    return false;
+  }
+}
+
+class TraceHandler : public FifoHandler
+{
+public:
+  explicit TraceHandler(bool changes_only) : changes_only(changes_only)
+  {
+    xf_state.resize(0x1100);
+    xf_known.resize(0x1100);
+  }
+
+  ~TraceHandler() override { Flush(); }
+
+  void OnNop() override
+  {
+    ++num_commands;
+    ++num_nops;
+  }
+
+  void OnBP(u32 value) override
+  {
+    ++num_commands;
+    const u8 addr = value >> 24;
+    if (addr == BPMEM_BP_MASK)
+    {
+      bp_mask = value & 0xffffff;
+      if (!changes_only)
+        PrintRegister("BP", addr, 2, GetBPRegName(addr), value, "");
+      return;
+    }
+
+    // A masked write only changes some of the bits
+    const u32 new_value = (bp_state[addr] & ~bp_mask) | (value & bp_mask) | (value & 0xff000000);
+    bp_mask = 0xffffff;
+    if (changes_only && bp_known[addr] && bp_state[addr] == new_value && !IsBPTrigger(addr))
+      return;
+    bp_state[addr] = new_value;
+    bp_known[addr] = true;
+
+    PrintRegister("BP", addr, 2, GetBPRegName(addr), value, DescribeBPReg(new_value));
+  }
+
+  void OnCP(u8 addr, u32 value) override
+  {
+    ++num_commands;
+    if (changes_only && cp_known[addr] && cp_state[addr] == value)
+      return;
+    cp_state[addr] = value;
+    cp_known[addr] = true;
+
+    PrintRegister("CP", addr, 2, GetCPRegName(addr), value, DescribeCPReg(addr, value));
+  }
+
+  void OnXF(u16 addr, const u32* values, u32 count) override
+  {
+    ++num_commands;
+    for (u32 i = 0; i < count; ++i)
+    {
+      const u32 reg = addr + i;
+      if (reg < xf_state.size())
+      {
+        if (changes_only && xf_known[reg] && xf_state[reg] == values[i])
+          continue;
+        xf_state[reg] = values[i];
+        xf_known[reg] = true;
+      }
+      PrintRegister("XF", reg, 4, GetXFRegName(reg), values[i], DescribeXFReg(reg, values[i]));
+    }
+  }
+
+  void OnLoadIndexed(u8 command, u32 value) override
+  {
+    ++num_commands;
+    FlushNops();
+    fmt::format_to(std::back_inserter(out),
+                   "Load indexed {:c}: index {}, address {:03x}, {} words\n",
+                   static_cast<char>('A' + (command - GX_CMD_LOAD_INDEXED_A) / 8), value >> 16,
+                   value & 0xfff, ((value >> 12) & 0xf) + 1);
+    MaybeFlush();
+  }
+
+  void OnCallDisplayList(u32 address, u32 size) override
+  {
+    ++num_commands;
+    FlushNops();
+    fmt::format_to(std::back_inserter(out), "Call display list at {:08x}, {} bytes\n", address,
+                   size);
+    MaybeFlush();
+  }
+
+  void OnInvalidateVertexCache() override
+  {
+    ++num_commands;
+    FlushNops();
+    fmt::format_to(std::back_inserter(out), "Invalidate vertex cache\n");
+    MaybeFlush();
+  }
+
+  void OnDraw(u8 command, u16 num_vertices, u32 vertex_size, const u8* /*vertices*/) override
+  {
+    ++num_commands;
+    ++num_draws;
+    num_vertices_drawn += num_vertices;
+    FlushNops();
+    fmt::format_to(std::back_inserter(out), "Draw {}, VAT {}: {} vertices of {} bytes\n",
+                   GetPrimitiveName(command), command & 7, num_vertices, vertex_size);
+    MaybeFlush();
+  }
+
+  void OnUnknown(u8 command) override
+  {
+    FlushNops();
+    fmt::format_to(std::back_inserter(out), "Unknown command {:02x}, stopping\n", command);
+  }
+
+  // The registers a FIFO log starts with are known, but not printed
+  void LoadState(const FifoLogRegisters& registers)
+  {
+    for (u32 i = 0; i < FIFO_LOG_BP_MEM_SIZE; ++i)
+      bp_state[i] = (i << 24) | registers.bp_mem[i];
+    std::fill(std::begin(bp_known), std::end(bp_known), true);
+    std::copy(std::begin(registers.cp_mem), std::end(registers.cp_mem), cp_state);
+    std::fill(std::begin(cp_known), std::end(cp_known), true);
+    std::copy(std::begin(registers.xf_mem), std::end(registers.xf_mem), xf_state.begin());
+    std::copy(std::begin(registers.xf_regs), std::end(registers.xf_regs),
+              xf_state.begin() + 0x1000);
+    std::fill(xf_known.begin(), xf_known.begin() + 0x1000 + FIFO_LOG_XF_REGS_SIZE, true);
+  }
+
+  void PrintMemoryUpdate(const FifoLogMemoryUpdate& update)
+  {
+    static const char* const TYPE_NAMES[] = {"texture", "XF data", "vertex stream", "TMEM"};
+    const char* type = "unknown";
+    for (u32 i = 0; i < std::size(TYPE_NAMES); ++i)
+    {
+      if (static_cast<u8>(update.type) == 1 << i)
+        type = TYPE_NAMES[i];
+    }
+
+    FlushNops();
+    fmt::format_to(std::back_inserter(out), "Memory update ({}): {} bytes at {:08x}\n", type,
+                   update.data.size(), update.address);
+    MaybeFlush();
+  }
+
+  void Flush()
+  {
+    FlushNops();
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    out.clear();
+  }
+
+  u64 num_commands = 0;
+  u64 num_draws = 0;
+  u64 num_vertices_drawn = 0;
+
+private:
+  void PrintRegister(const char* type, u32 addr, int addr_digits, const std::string& name,
+                     u32 value, const std::string& description)
+  {
+    FlushNops();
+    auto it = fmt::format_to(std::back_inserter(out), "{} {:0{}x} {}: {:08x}", type, addr,
+                             addr_digits, name, value);
+
+    // Single values go on the same line, fields on their own lines
+    if (description.find('\n') == std::string::npos)
+    {
+      if (!description.empty())
+        it = fmt::format_to(it, " ({})", description);
+      *it++ = '\n';
+    }
+    else
+    {
+      size_t start = 0;
+      while (start < description.size())
+      {
+        size_t end = description.find('\n', start);
+        if (end == std::string::npos)
+          end = description.size();
+        const std::string_view line = std::string_view(description).substr(start, end - start);
+        it = fmt::format_to(it, line.empty() ? "\n" : "\n    {}", line);
+        start = end + 1;
+      }
+      *it++ = '\n';
+    }
+    MaybeFlush();
+  }
+
+  // Runs of NOPs (like the padding of display lists) are printed as one line
+  void FlushNops()
+  {
+    if (num_nops != 0 && !changes_only)
+      fmt::format_to(std::back_inserter(out), "NOP x{}\n", num_nops);
+    num_nops = 0;
+  }
+
+  void MaybeFlush()
+  {
+    if (out.size() >= OUTPUT_BLOCK_SIZE)
+      Flush();
+  }
+
+  bool changes_only;
+  fmt::memory_buffer out;
+  u64 num_nops = 0;
+
+  u32 bp_state[0x100] = {};
+  bool bp_known[0x100] = {};
+  u32 bp_mask = 0xffffff;
+  u32 cp_state[0x100] = {};
+  bool cp_known[0x100] = {};
+  // Matrix memory, lights and the registers from 0x1000 on
+  std::vector<u32> xf_state;
+  std::vector<bool> xf_known;
+};
+
+// Decodes the log's commands, with the memory updates where they happen
+static size_t TraceFifoLog(const FifoLog& log, TraceHandler& handler, FifoDecoder& decoder)
+{
+  handler.LoadState(log.registers);
+  decoder.LoadCPState(log.registers.cp_mem);
+
+  size_t decoded = 0;
+  for (const FifoLogMemoryUpdate& update : log.memory_updates)
+  {
+    if (update.fifo_position > decoded && update.fifo_position <= log.fifo_data.size())
+      decoded += decoder.Decode(log.fifo_data.data() + decoded, update.fifo_position - decoded);
+    handler.PrintMemoryUpdate(update);
+  }
+  decoded += decoder.Decode(log.fifo_data.data() + decoded, log.fifo_data.size() - decoded);
+  return log.fifo_data.size() - decoded;
+}
+
+int main(int argc, char** argv)
+{
+  bool changes_only = false;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--changes") == 0)
+      changes_only = true;
+    else if (!path && argv[i][0] != '-')
+      path = argv[i];
+    else
+    {
+      std::fprintf(stderr, "Usage: %s [--changes] [capture or FIFO log file]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  std::FILE* file = path ? std::fopen(path, "rb") : stdin;
+  if (!file)
+  {
+    std::fprintf(stderr, "Can't open %s\n", path);
+    return 1;
+  }
+
+  TraceHandler handler(changes_only);
+  FifoDecoder decoder(handler);
+
+  // Commands that don't fit into the rest of the buffer are moved to its start, and the buffer
+  // grows if a single command (a big draw) doesn't fit at all
+  std::vector<u8> buffer(INPUT_BLOCK_SIZE);
+  size_t filled = 0;
+  u64 total_size = 0;
+  bool is_fifo_log = false;
+  while (!decoder.Failed())
+  {
+    if (filled == buffer.size())
+      buffer.resize(buffer.size() * 2);
+    const size_t read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, file);
+    if (read == 0)
+      break;
+    filled += read;
+    total_size += read;
+
+    // A FIFO log isn't a stream, it's read completely first
+    if (total_size == read && IsFifoLog(buffer.data(), filled))
+    {
+      is_fifo_log = true;
+      continue;
+    }
+    if (is_fifo_log)
+      continue;
+
+    const size_t decoded = decoder.Decode(buffer.data(), filled);
+    std::memmove(buffer.data(), buffer.data() + decoded, filled - decoded);
+    filled -= decoded;
+  }
+  if (path)
+    std::fclose(file);
+
+  if (is_fifo_log)
+  {
+    FifoLog log;
+    if (!ParseFifoLog(buffer.data(), filled, &log))
+    {
+      std::fprintf(stderr, "%s is a broken FIFO log\n", path ? path : "The input");
+      return 1;
+    }
+    filled = TraceFifoLog(log, handler, decoder);
+    total_size = log.fifo_data.size();
+  }
+  handler.Flush();
+
+  if (filled != 0 && !decoder.Failed())
+    std::fprintf(stderr, "The last %zu bytes are an incomplete command\n", filled);
+  std::fprintf(stderr, "%llu bytes, %llu commands, %llu draws with %llu vertices\n",
+               static_cast<unsigned long long>(total_size),
+               static_cast<unsigned long long>(handler.num_commands),
+               static_cast<unsigned long long>(handler.num_draws),
+               static_cast<unsigned long long>(handler.num_vertices_drawn));
+  return decoder.Failed() || filled != 0;
+}
@@ -0,0 +1,7 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Builds the encoder with the host compiler, which evaluates the known encodings it checks with
+// static_assert. This catches encoding mistakes without needing a console.
+
+#include "Common/GekkoEncoder.h"
@@ -0,0 +1,145 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Checks DequantizeBatch and QuantizeBatch from Common/FloatUtils.h against the scalar Dequantize
+// and Quantize, element by element, for every QuantizeType and all 64 scales. The console always
+// takes the scalar path, so this is where the SSE2 paths get compared with it. The lengths aren't
+// all multiples of the vector width, so the scalar tails after the vector loops are covered too.
+//
+// Usage: quantize_batch_check [seed]
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Common/FloatUtils.h"
+#include "Common/Random.h"
+
+constexpr QuantizeType TYPES[] = {QuantizeType::Float, QuantizeType::U8, QuantizeType::U16,
+                                  QuantizeType::S8, QuantizeType::S16};
+constexpr const char* TYPE_NAMES[] = {"Float", "U8", "U16", "S8", "S16"};
+constexpr u32 LENGTHS[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 1021};
+
+static int s_num_failures = 0;
+
+static void Report(const char* function, const char* type_name, u32 scale, u32 length, u32 i,
+                   u32 got, u32 expected)
+{
+  if (s_num_failures++ < 20)
+  {
+    std::printf("%s %s scale %u length %u element %u: got 0x%08x, expected 0x%08x\n", function,
+                type_name, scale, length, i, got, expected);
+  }
+}
+
+// Float inputs for stores: in and around the range of every type at every scale, plus the
+// special values and random bit patterns
+static float RandomStoreInput(Random& random, u32 scale)
+{
+  switch (random.NextBelow(4))
+  {
+  case 0:
+  {
+    static const u32 SPECIAL[] = {0x00000000, 0x80000000, 0x7F800000, 0xFF800000, 0x7FC00000,
+                                  0xFFC00000, 0x7F800001, 0x00000001, 0x3F000000, 0xBF000000};
+    return Common::BitCast<float>(SPECIAL[random.NextBelow(std::size(SPECIAL))]);
+  }
+  case 1:
+    return Common::BitCast<float>(random.Next32());
+  default:
+  {
+    // An integer up to twice the range of the widest type, sometimes with a fraction, scaled
+    // back by the factor the store multiplies with
+    const float integer = static_cast<float>(random.NextInRange(-0x10000, 0x20000));
+    const float fraction = random.NextBool() ? 0.0f : static_cast<float>(random.Next32() >> 8) /
+                                                          static_cast<float>(1 << 24);
+    return (integer + fraction) * DequantizeFactor(scale);
+  }
+  }
+}
+
+static void CheckDequantize(Random& random, u32 type_index, u32 scale, u32 length)
+{
+  const QuantizeType type = TYPES[type_index];
+  const u32 size = QuantizeTypeSize(type);
+
+  std::vector<u8> src(length * size);
+  for (u8& byte : src)
+    byte = static_cast<u8>(random.Next32());
+  std::vector<float> dst(length);
+  DequantizeBatch(src.data(), dst.data(), length, type, scale);
+
+  for (u32 i = 0; i < length; ++i)
+  {
+    u32 raw = 0;
+    for (u32 j = 0; j < size; ++j)
+      raw = (raw << 8) | src[i * size + j];
+    const u32 expected = Common::BitCast<u32>(Dequantize(raw, type, scale));
+    const u32 got = Common::BitCast<u32>(dst[i]);
+    if (got != expected)
+      Report("DequantizeBatch", TYPE_NAMES[type_index], scale, length, i, got, expected);
+  }
+}
+
+static void CheckQuantize(Random& random, u32 type_index, u32 scale, u32 length)
+{
+  const QuantizeType type = TYPES[type_index];
+  const u32 size = QuantizeTypeSize(type);
+
+  std::vector<float> src(length);
+  for (float& value : src)
+    value = RandomStoreInput(random, scale);
+  std::vector<u8> dst(length * size);
+  QuantizeBatch(src.data(), dst.data(), length, type, scale);
+
+  for (u32 i = 0; i < length; ++i)
+  {
+    u32 got = 0;
+    for (u32 j = 0; j < size; ++j)
+      got = (got << 8) | dst[i * size + j];
+    const u32 expected = Quantize(src[i], type, scale);
+    if (got != expected)
+      Report("QuantizeBatch", TYPE_NAMES[type_index], scale, length, i, got, expected);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 2)
+  {
+    std::fprintf(stderr, "Usage: %s [seed]\n", argv[0]);
+    return 1;
+  }
+  const u64 seed = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 0;
+  Random random(seed);
+
+#ifndef __SSE2__
+  std::printf("Built without SSE2, so the batch functions only have the scalar path\n");
+#endif
+
+  u64 num_elements = 0;
+  for (u32 type_index = 0; type_index < std::size(TYPES); ++type_index)
+  {
+    for (u32 scale = 0; scale < 64; ++scale)
+    {
+      for (u32 length : LENGTHS)
+      {
+        // Several rounds, so that every vector lane sees the special values
+        for (u32 round = 0; round < 16; ++round)
+        {
+          CheckDequantize(random, type_index, scale, length);
+          CheckQuantize(random, type_index, scale, length);
+          num_elements += 2 * length;
+        }
+      }
+    }
+  }
+
+  std::printf("Seed %" PRIu64 ": %" PRIu64 " elements checked, %d mismatches\n", seed,
+              num_elements, s_num_failures);
+  return s_num_failures != 0;
+}